@@ -26,9 +26,25 @@
 
 #include "DebugNew.h"
 
+#ifdef _MSC_VER
+#define URHO3D_THREAD_LOCAL __declspec(thread)
+#else
+#define URHO3D_THREAD_LOCAL __thread
+#endif
+
 namespace Urho3D
 {
 
+/// Number of nodes moved between a thread cache and the central pool at a time.
+static const unsigned SHARED_ALLOCATOR_BATCH = 32;
+/// Maximum number of free nodes held in a thread cache before a batch is returned.
+static const unsigned SHARED_ALLOCATOR_CACHE_MAX = 2 * SHARED_ALLOCATOR_BATCH;
+
+/// Shared allocator cache index of the current thread plus one, or zero if not assigned yet.
+static URHO3D_THREAD_LOCAL unsigned threadCacheIndex = 0;
+/// Number of threads that have been assigned a cache index.
+static volatile int numCacheThreads = 0;
+
 AllocatorBlock* AllocatorReserveBlock(AllocatorBlock* allocator, unsigned nodeSize, unsigned capacity)
 {
     if (!capacity)
@@ -40,6 +56,7 @@ AllocatorBlock* AllocatorReserveBlock(AllocatorBlock* allocator, unsigned nodeSi
     newBlock->capacity_ = capacity;
     newBlock->free_ = 0;
     newBlock->next_ = 0;
+    newBlock->shared_ = 0;
     
     if (!allocator)
         allocator = newBlock;
@@ -121,4 +138,224 @@ void AllocatorFree(AllocatorBlock* allocator, void* ptr)
     allocator->free_ = node;
 }
 
+static SharedAllocatorCache& GetThreadCache(SharedAllocator* allocator)
+{
+    if (!threadCacheIndex)
+        threadCacheIndex = ((unsigned)(AtomicIncrement(numCacheThreads) - 1)) % SHARED_ALLOCATOR_CACHES + 1;
+    
+    return allocator->caches_[threadCacheIndex - 1];
+}
+
+void SharedAllocatorReserveBlock(SharedAllocator* allocator, unsigned capacity)
+{
+    if (!capacity)
+        capacity = 1;
+    
+    unsigned nodeStride = sizeof(SharedAllocatorNode) + allocator->nodeSize_;
+    unsigned char* blockPtr = new unsigned char[sizeof(SharedAllocatorBlock) + capacity * nodeStride];
+    SharedAllocatorBlock* newBlock = reinterpret_cast<SharedAllocatorBlock*>(blockPtr);
+    newBlock->capacity_ = capacity;
+    newBlock->used_ = 0;
+    newBlock->next_ = allocator->blocks_;
+    allocator->blocks_ = newBlock;
+    allocator->capacity_ += capacity;
+    
+    // Chain the new nodes in front of the central pool's free nodes
+    unsigned char* nodePtr = blockPtr + sizeof(SharedAllocatorBlock);
+    SharedAllocatorNode* firstNewNode = reinterpret_cast<SharedAllocatorNode*>(nodePtr);
+    
+    for (unsigned i = 0; i < capacity; ++i)
+    {
+        SharedAllocatorNode* newNode = reinterpret_cast<SharedAllocatorNode*>(nodePtr);
+        newNode->block_ = newBlock;
+        newNode->next_ = i < capacity - 1 ? reinterpret_cast<SharedAllocatorNode*>(nodePtr + nodeStride) : allocator->free_;
+        nodePtr += nodeStride;
+    }
+    
+    allocator->free_ = firstNewNode;
+}
+
+void SharedAllocatorReturnNodes(SharedAllocator* allocator, SharedAllocatorCache& cache, unsigned count)
+{
+    // The cache must already be locked by the caller
+    if (!count || !cache.free_)
+        return;
+    
+    allocator->lock_.Acquire();
+    
+    SharedAllocatorNode* first = cache.free_;
+    SharedAllocatorNode* last = 0;
+    SharedAllocatorNode* node = first;
+    unsigned returned = 0;
+    while (node && returned < count)
+    {
+        --node->block_->used_;
+        last = node;
+        node = node->next_;
+        ++returned;
+    }
+    
+    cache.free_ = node;
+    cache.numFree_ -= returned;
+    last->next_ = allocator->free_;
+    allocator->free_ = first;
+    
+    allocator->lock_.Release();
+}
+
+SharedAllocator* SharedAllocatorInitialize(unsigned nodeSize, unsigned initialCapacity)
+{
+    SharedAllocator* allocator = new SharedAllocator();
+    allocator->nodeSize_ = nodeSize;
+    if (initialCapacity)
+        SharedAllocatorReserveBlock(allocator, initialCapacity);
+    
+    return allocator;
+}
+
+void SharedAllocatorUninitialize(SharedAllocator* allocator)
+{
+    if (!allocator)
+        return;
+    
+    SharedAllocatorBlock* block = allocator->blocks_;
+    while (block)
+    {
+        SharedAllocatorBlock* next = block->next_;
+        delete[] reinterpret_cast<unsigned char*>(block);
+        block = next;
+    }
+    
+    delete allocator;
+}
+
+void* SharedAllocatorReserve(SharedAllocator* allocator)
+{
+    if (!allocator)
+        return 0;
+    
+    SharedAllocatorCache& cache = GetThreadCache(allocator);
+    cache.lock_.Acquire();
+    
+    if (!cache.free_)
+    {
+        // Cache is empty. Take a batch of nodes from the central pool, which grows by half if exhausted
+        allocator->lock_.Acquire();
+        
+        if (!allocator->free_)
+        {
+            unsigned newCapacity = (allocator->capacity_ + 1) >> 1;
+            SharedAllocatorReserveBlock(allocator, newCapacity > SHARED_ALLOCATOR_BATCH ? newCapacity : SHARED_ALLOCATOR_BATCH);
+        }
+        
+        SharedAllocatorNode* node = allocator->free_;
+        SharedAllocatorNode* last = 0;
+        unsigned taken = 0;
+        cache.free_ = node;
+        while (node && taken < SHARED_ALLOCATOR_BATCH)
+        {
+            ++node->block_->used_;
+            last = node;
+            node = node->next_;
+            ++taken;
+        }
+        
+        last->next_ = 0;
+        allocator->free_ = node;
+        cache.numFree_ = taken;
+        
+        allocator->lock_.Release();
+    }
+    
+    SharedAllocatorNode* freeNode = cache.free_;
+    cache.free_ = freeNode->next_;
+    --cache.numFree_;
+    
+    cache.lock_.Release();
+    
+    freeNode->next_ = 0;
+    
+    // Update statistics
+    int liveNodes = AtomicIncrement(allocator->liveNodes_);
+    for (;;)
+    {
+        int peakNodes = allocator->peakNodes_;
+        if (liveNodes <= peakNodes || AtomicCompareExchange(allocator->peakNodes_, liveNodes, peakNodes))
+            break;
+    }
+    
+    return (reinterpret_cast<unsigned char*>(freeNode)) + sizeof(SharedAllocatorNode);
+}
+
+void SharedAllocatorFree(SharedAllocator* allocator, void* ptr)
+{
+    if (!allocator || !ptr)
+        return;
+    
+    unsigned char* dataPtr = static_cast<unsigned char*>(ptr);
+    SharedAllocatorNode* node = reinterpret_cast<SharedAllocatorNode*>(dataPtr - sizeof(SharedAllocatorNode));
+    
+    AtomicDecrement(allocator->liveNodes_);
+    
+    SharedAllocatorCache& cache = GetThreadCache(allocator);
+    cache.lock_.Acquire();
+    
+    node->next_ = cache.free_;
+    cache.free_ = node;
+    ++cache.numFree_;
+    
+    // If the cache has grown too large, return the most recently freed nodes to the central pool
+    if (cache.numFree_ > SHARED_ALLOCATOR_CACHE_MAX)
+        SharedAllocatorReturnNodes(allocator, cache, SHARED_ALLOCATOR_BATCH);
+    
+    cache.lock_.Release();
+}
+
+unsigned SharedAllocatorTrim(SharedAllocator* allocator)
+{
+    if (!allocator)
+        return 0;
+    
+    for (unsigned i = 0; i < SHARED_ALLOCATOR_CACHES; ++i)
+    {
+        SharedAllocatorCache& cache = allocator->caches_[i];
+        cache.lock_.Acquire();
+        SharedAllocatorReturnNodes(allocator, cache, cache.numFree_);
+        cache.lock_.Release();
+    }
+    
+    allocator->lock_.Acquire();
+    
+    // Unchain the free nodes of blocks that have no nodes in use, then free those blocks
+    SharedAllocatorNode** nodePtr = &allocator->free_;
+    while (*nodePtr)
+    {
+        if (!(*nodePtr)->block_->used_)
+            *nodePtr = (*nodePtr)->next_;
+        else
+            nodePtr = &(*nodePtr)->next_;
+    }
+    
+    unsigned nodeStride = sizeof(SharedAllocatorNode) + allocator->nodeSize_;
+    unsigned freedBytes = 0;
+    SharedAllocatorBlock** blockPtr = &allocator->blocks_;
+    while (*blockPtr)
+    {
+        SharedAllocatorBlock* block = *blockPtr;
+        if (!block->used_)
+        {
+            *blockPtr = block->next_;
+            allocator->capacity_ -= block->capacity_;
+            freedBytes += sizeof(SharedAllocatorBlock) + block->capacity_ * nodeStride;
+            delete[] reinterpret_cast<unsigned char*>(block);
+        }
+        else
+            blockPtr = &block->next_;
+    }
+    
+    allocator->lock_.Release();
+    
+    return freedBytes;
+}
+
 }
@@ -22,6 +22,8 @@
 
 #pragma once
 
+#include "Atomic.h"
+
 #include <new>
 
 namespace Urho3D
@@ -29,6 +31,7 @@ namespace Urho3D
 
 struct AllocatorBlock;
 struct AllocatorNode;
+struct SharedAllocator;
 
 /// %Allocator memory block.
 struct AllocatorBlock
@@ -41,6 +44,8 @@ struct AllocatorBlock
     AllocatorNode* free_;
     /// Next allocator block.
     AllocatorBlock* next_;
+    /// Thread-safe allocator that the owning container uses instead, or null. Only used in the first block.
+    SharedAllocator* shared_;
     /// Nodes follow.
 };
 
@@ -61,6 +66,79 @@ void* AllocatorReserve(AllocatorBlock* allocator);
 /// Free a node. Does not free any blocks.
 void AllocatorFree(AllocatorBlock* allocator, void* ptr);
 
+struct SharedAllocatorBlock;
+struct SharedAllocatorNode;
+
+/// Number of per-thread free node caches in a shared allocator. Threads beyond this share caches.
+static const unsigned SHARED_ALLOCATOR_CACHES = 16;
+
+/// %Shared allocator memory block.
+struct SharedAllocatorBlock
+{
+    /// Number of nodes in this block.
+    unsigned capacity_;
+    /// Number of nodes that are in use or held in a thread cache.
+    unsigned used_;
+    /// Next block.
+    SharedAllocatorBlock* next_;
+    /// Nodes follow.
+};
+
+/// %Shared allocator node.
+struct SharedAllocatorNode
+{
+    /// Block the node belongs to.
+    SharedAllocatorBlock* block_;
+    /// Next free node.
+    SharedAllocatorNode* next_;
+    /// Data follows.
+};
+
+/// %Shared allocator per-thread free node cache. Padded to avoid false sharing between threads.
+struct SharedAllocatorCache
+{
+    /// First free node.
+    SharedAllocatorNode* free_;
+    /// Number of free nodes.
+    unsigned numFree_;
+    /// Lock, only contended if several threads map to the same cache.
+    SpinLock lock_;
+    /// Padding to cache line size.
+    unsigned char padding_[64 - sizeof(void*) - sizeof(unsigned) - sizeof(SpinLock)];
+};
+
+/// Thread-safe fixed-size allocator. Each thread reserves and frees nodes through its own cache, which exchanges nodes with a central pool in batches.
+struct SharedAllocator
+{
+    /// Per-thread free node caches.
+    SharedAllocatorCache caches_[SHARED_ALLOCATOR_CACHES];
+    /// Size of a node.
+    unsigned nodeSize_;
+    /// Total number of nodes in all blocks.
+    unsigned capacity_;
+    /// Central pool lock.
+    SpinLock lock_;
+    /// Central pool first free node.
+    SharedAllocatorNode* free_;
+    /// Memory blocks.
+    SharedAllocatorBlock* blocks_;
+    /// Number of nodes currently reserved.
+    volatile int liveNodes_;
+    /// Highest number of nodes reserved at the same time.
+    volatile int peakNodes_;
+};
+
+/// Initialize a thread-safe shared allocator with the node size and initial capacity.
+SharedAllocator* SharedAllocatorInitialize(unsigned nodeSize, unsigned initialCapacity = 64);
+/// Uninitialize a shared allocator. Frees all blocks. No nodes may be in use by other threads.
+void SharedAllocatorUninitialize(SharedAllocator* allocator);
+/// Reserve a node. Takes nodes from the central pool in batches and creates a new block if necessary.
+void* SharedAllocatorReserve(SharedAllocator* allocator);
+/// Free a node to the calling thread's cache. Returns surplus nodes to the central pool.
+void SharedAllocatorFree(SharedAllocator* allocator, void* ptr);
+/// Return cached nodes to the central pool and free blocks that have no nodes in use. Return number of bytes freed.
+unsigned SharedAllocatorTrim(SharedAllocator* allocator);
+
 /// %Allocator template class. Allocates objects of a specific class.
 template <class T> class Allocator
 {
@@ -0,0 +1,104 @@
+//
+// Copyright (c) 2008-2013 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace Urho3D
+{
+
+/// Atomically increment an integer. Return the incremented value.
+inline int AtomicIncrement(volatile int& value)
+{
+    #ifdef _MSC_VER
+    return _InterlockedIncrement((volatile long*)&value);
+    #else
+    return __sync_add_and_fetch(&value, 1);
+    #endif
+}
+
+/// Atomically decrement an integer. Return the decremented value.
+inline int AtomicDecrement(volatile int& value)
+{
+    #ifdef _MSC_VER
+    return _InterlockedDecrement((volatile long*)&value);
+    #else
+    return __sync_sub_and_fetch(&value, 1);
+    #endif
+}
+
+/// Atomically set an integer to a new value if it equals the comparand. Return true if the value was set.
+inline bool AtomicCompareExchange(volatile int& value, int exchange, int comparand)
+{
+    #ifdef _MSC_VER
+    return _InterlockedCompareExchange((volatile long*)&value, exchange, comparand) == comparand;
+    #else
+    return __sync_bool_compare_and_swap(&value, comparand, exchange);
+    #endif
+}
+
+/// Atomically set a pointer to a new value if it equals the comparand. Return true if the value was set.
+inline bool AtomicCompareExchangePointer(void* volatile& value, void* exchange, void* comparand)
+{
+    #if defined(_MSC_VER) && defined(_WIN64)
+    return _InterlockedCompareExchangePointer(&value, exchange, comparand) == comparand;
+    #elif defined(_MSC_VER)
+    return _InterlockedCompareExchange((volatile long*)&value, (long)exchange, (long)comparand) == (long)comparand;
+    #else
+    return __sync_bool_compare_and_swap(&value, comparand, exchange);
+    #endif
+}
+
+/// Lock that busy-waits instead of blocking. Only for short critical sections that are rarely contended.
+class SpinLock
+{
+public:
+    /// Construct unlocked.
+    SpinLock() :
+        locked_(0)
+    {
+    }
+    
+    /// Acquire the lock. Spin if already acquired.
+    void Acquire()
+    {
+        while (!AtomicCompareExchange(locked_, 1, 0))
+        {
+        }
+    }
+    
+    /// Release the lock.
+    void Release()
+    {
+        AtomicDecrement(locked_);
+    }
+    
+private:
+    /// Locked flag.
+    volatile int locked_;
+};
+
+}
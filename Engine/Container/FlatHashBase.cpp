@@ -0,0 +1,56 @@
+//
+// Copyright (c) 2008-2013 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "FlatHashBase.h"
+
+#include <cstring>
+
+#include "DebugNew.h"
+
+namespace Urho3D
+{
+
+void FlatHashBase::AllocateHashes(unsigned capacity)
+{
+    hashes_ = new unsigned[capacity];
+    memset(hashes_, 0, capacity * sizeof(unsigned));
+    capacity_ = capacity;
+    deleted_ = 0;
+    
+    shift_ = 32;
+    while (capacity > 1)
+    {
+        capacity >>= 1;
+        --shift_;
+    }
+}
+
+unsigned FlatHashBase::CalculateCapacity(unsigned size)
+{
+    // Keep the load factor at or below one half after a rehash, so that several insertions fit before the next
+    unsigned capacity = MIN_CAPACITY;
+    while (capacity < size * 2)
+        capacity <<= 1;
+    return capacity;
+}
+
+}
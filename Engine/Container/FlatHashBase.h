@@ -0,0 +1,169 @@
+//
+// Copyright (c) 2008-2013 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "Hash.h"
+#include "Swap.h"
+
+namespace Urho3D
+{
+
+/// Stored hash value of an empty flat hash slot.
+static const unsigned FLAT_HASH_EMPTY = 0;
+/// Stored hash value of an erased flat hash slot.
+static const unsigned FLAT_HASH_DELETED = 1;
+
+/// Flat hash set/map iterator base class.
+struct FlatHashIteratorBase
+{
+    /// Construct.
+    FlatHashIteratorBase() :
+        hashes_(0),
+        index_(0),
+        capacity_(0)
+    {
+    }
+    
+    /// Construct with slot hash array, slot index and capacity.
+    FlatHashIteratorBase(const unsigned* hashes, unsigned index, unsigned capacity) :
+        hashes_(hashes),
+        index_(index),
+        capacity_(capacity)
+    {
+    }
+    
+    /// Test for equality with another iterator.
+    bool operator == (const FlatHashIteratorBase& rhs) const { return index_ == rhs.index_ && hashes_ == rhs.hashes_; }
+    /// Test for inequality with another iterator.
+    bool operator != (const FlatHashIteratorBase& rhs) const { return index_ != rhs.index_ || hashes_ != rhs.hashes_; }
+    
+    /// Go to the next occupied slot, or to the end.
+    void GotoNext()
+    {
+        if (index_ >= capacity_)
+            return;
+        
+        ++index_;
+        while (index_ < capacity_ && hashes_[index_] <= FLAT_HASH_DELETED)
+            ++index_;
+    }
+    
+    /// Go to the previous occupied slot. Stay in place if there is none.
+    void GotoPrev()
+    {
+        unsigned index = index_;
+        while (index)
+        {
+            --index;
+            if (hashes_[index] > FLAT_HASH_DELETED)
+            {
+                index_ = index;
+                return;
+            }
+        }
+    }
+    
+    /// Slot hash array.
+    const unsigned* hashes_;
+    /// Slot index.
+    unsigned index_;
+    /// Slot count.
+    unsigned capacity_;
+};
+
+/// Flat (open addressing) hash set/map base class.
+class FlatHashBase
+{
+public:
+    /// Initial amount of slots.
+    static const unsigned MIN_CAPACITY = 8;
+    
+    /// Construct.
+    FlatHashBase() :
+        hashes_(0),
+        capacity_(0),
+        shift_(0),
+        size_(0),
+        deleted_(0)
+    {
+    }
+    
+    /// Destruct.
+    ~FlatHashBase()
+    {
+        delete[] hashes_;
+    }
+    
+    /// Return number of elements.
+    unsigned Size() const { return size_; }
+    /// Return number of slots.
+    unsigned Capacity() const { return capacity_; }
+    /// Return whether has no elements.
+    bool Empty() const { return size_ == 0; }
+
+protected:
+    /// Swap with another flat hash set or map.
+    void Swap(FlatHashBase& rhs)
+    {
+        Urho3D::Swap(hashes_, rhs.hashes_);
+        Urho3D::Swap(capacity_, rhs.capacity_);
+        Urho3D::Swap(shift_, rhs.shift_);
+        Urho3D::Swap(size_, rhs.size_);
+        Urho3D::Swap(deleted_, rhs.deleted_);
+    }
+    
+    /// Allocate and clear a new slot hash array. The old array is not freed; the caller must take ownership of it first.
+    void AllocateHashes(unsigned capacity);
+    /// Return the smallest power of two capacity that holds the given amount of elements below the maximum load factor.
+    static unsigned CalculateCapacity(unsigned size);
+    
+    /// Return whether inserting one more element would exceed the maximum load factor.
+    bool NeedRehash() const { return (size_ + deleted_ + 1) * 4 > capacity_ * 3; }
+    /// Return first index of the probe sequence for a stored hash value. Fibonacci hashing spreads low-entropy keys such as pointers and IDs.
+    unsigned StartIndex(unsigned hash) const { return (hash * 2654435769u) >> shift_; }
+    /// Return the next index of the probe sequence.
+    unsigned NextIndex(unsigned index) const { return (index + 1) & (capacity_ - 1); }
+    /// Return a key hash adjusted to not collide with the empty and deleted markers.
+    static unsigned StoredHash(unsigned hash) { return hash > FLAT_HASH_DELETED ? hash : hash + 2; }
+    /// Return index of the first occupied slot, or capacity if none.
+    unsigned FirstIndex() const
+    {
+        unsigned index = 0;
+        while (index < capacity_ && hashes_[index] <= FLAT_HASH_DELETED)
+            ++index;
+        return index;
+    }
+    
+    /// Slot hash values.
+    unsigned* hashes_;
+    /// Slot count, always zero or a power of two.
+    unsigned capacity_;
+    /// Right shift to map a 32-bit hash to a slot index.
+    unsigned shift_;
+    /// Number of elements.
+    unsigned size_;
+    /// Number of erased slots not yet reclaimed.
+    unsigned deleted_;
+};
+
+}
@@ -0,0 +1,407 @@
+//
+// Copyright (c) 2008-2013 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "FlatHashBase.h"
+
+#include <cstring>
+#include <new>
+
+namespace Urho3D
+{
+
+/// Open addressing hash set template class. Stores the keys in one contiguous slot array with linear probing, so lookups
+/// touch few cache lines and insertions do not allocate per element. Unlike HashSet, iteration order is unspecified and
+/// inserting may move existing keys, invalidating iterators. Erasing does not move other keys.
+template <class T> class FlatHashSet : public FlatHashBase
+{
+public:
+    /// Flat hash set iterator.
+    struct Iterator : public FlatHashIteratorBase
+    {
+        /// Construct.
+        Iterator() :
+            slots_(0)
+        {
+        }
+        
+        /// Construct with slot arrays and index.
+        Iterator(const unsigned* hashes, T* slots, unsigned index, unsigned capacity) :
+            FlatHashIteratorBase(hashes, index, capacity),
+            slots_(slots)
+        {
+        }
+        
+        /// Preincrement the pointer.
+        Iterator& operator ++ () { GotoNext(); return *this; }
+        /// Postincrement the pointer.
+        Iterator operator ++ (int) { Iterator it = *this; GotoNext(); return it; }
+        /// Predecrement the pointer.
+        Iterator& operator -- () { GotoPrev(); return *this; }
+        /// Postdecrement the pointer.
+        Iterator operator -- (int) { Iterator it = *this; GotoPrev(); return it; }
+        
+        /// Point to the key.
+        const T* operator -> () const { return slots_ + index_; }
+        /// Dereference the key.
+        const T& operator * () const { return slots_[index_]; }
+        
+        /// Slot keys.
+        T* slots_;
+    };
+    
+    /// Flat hash set const iterator.
+    struct ConstIterator : public FlatHashIteratorBase
+    {
+        /// Construct.
+        ConstIterator() :
+            slots_(0)
+        {
+        }
+        
+        /// Construct with slot arrays and index.
+        ConstIterator(const unsigned* hashes, const T* slots, unsigned index, unsigned capacity) :
+            FlatHashIteratorBase(hashes, index, capacity),
+            slots_(slots)
+        {
+        }
+        
+        /// Construct from a non-const iterator.
+        ConstIterator(const Iterator& rhs) :
+            FlatHashIteratorBase(rhs.hashes_, rhs.index_, rhs.capacity_),
+            slots_(rhs.slots_)
+        {
+        }
+        
+        /// Assign from a non-const iterator.
+        ConstIterator& operator = (const Iterator& rhs)
+        {
+            hashes_ = rhs.hashes_;
+            index_ = rhs.index_;
+            capacity_ = rhs.capacity_;
+            slots_ = rhs.slots_;
+            return *this;
+        }
+        
+        /// Preincrement the pointer.
+        ConstIterator& operator ++ () { GotoNext(); return *this; }
+        /// Postincrement the pointer.
+        ConstIterator operator ++ (int) { ConstIterator it = *this; GotoNext(); return it; }
+        /// Predecrement the pointer.
+        ConstIterator& operator -- () { GotoPrev(); return *this; }
+        /// Postdecrement the pointer.
+        ConstIterator operator -- (int) { ConstIterator it = *this; GotoPrev(); return it; }
+        
+        /// Point to the key.
+        const T* operator -> () const { return slots_ + index_; }
+        /// Dereference the key.
+        const T& operator * () const { return slots_[index_]; }
+        
+        /// Slot keys.
+        const T* slots_;
+    };
+    
+    /// Construct empty.
+    FlatHashSet() :
+        slots_(0)
+    {
+    }
+    
+    /// Construct from another flat hash set.
+    FlatHashSet(const FlatHashSet<T>& set) :
+        slots_(0)
+    {
+        *this = set;
+    }
+    
+    /// Destruct.
+    ~FlatHashSet()
+    {
+        Clear();
+        FreeSlots(slots_);
+    }
+    
+    /// Assign a flat hash set.
+    FlatHashSet& operator = (const FlatHashSet<T>& rhs)
+    {
+        if (&rhs != this)
+        {
+            Clear();
+            Insert(rhs);
+        }
+        return *this;
+    }
+    
+    /// Add-assign a value.
+    FlatHashSet& operator += (const T& rhs)
+    {
+        Insert(rhs);
+        return *this;
+    }
+    
+    /// Add-assign a flat hash set.
+    FlatHashSet& operator += (const FlatHashSet<T>& rhs)
+    {
+        Insert(rhs);
+        return *this;
+    }
+    
+    /// Test for equality with another flat hash set.
+    bool operator == (const FlatHashSet<T>& rhs) const
+    {
+        if (rhs.Size() != Size())
+            return false;
+        
+        for (ConstIterator i = Begin(); i != End(); ++i)
+        {
+            if (!rhs.Contains(*i))
+                return false;
+        }
+        
+        return true;
+    }
+    
+    /// Test for inequality with another flat hash set.
+    bool operator != (const FlatHashSet<T>& rhs) const { return !(*this == rhs); }
+    
+    /// Insert a key. Return an iterator to it.
+    Iterator Insert(const T& key)
+    {
+        unsigned hash = StoredHash(MakeHash(key));
+        
+        if (capacity_)
+        {
+            unsigned index = FindIndex(key, hash);
+            if (index < capacity_)
+                return MakeIterator(index);
+        }
+        
+        return MakeIterator(InsertSlot(key, hash));
+    }
+    
+    /// Insert a set.
+    void Insert(const FlatHashSet<T>& set)
+    {
+        if (&set == this)
+            return;
+        
+        Reserve(Size() + set.Size());
+        for (ConstIterator i = set.Begin(); i != set.End(); ++i)
+            Insert(*i);
+    }
+    
+    /// Insert a key by iterator. Return iterator to the value.
+    Iterator Insert(const ConstIterator& it) { return Insert(*it); }
+    
+    /// Erase a key. Return true if was found.
+    bool Erase(const T& key)
+    {
+        if (!capacity_)
+            return false;
+        
+        unsigned index = FindIndex(key, StoredHash(MakeHash(key)));
+        if (index == capacity_)
+            return false;
+        
+        EraseSlot(index);
+        return true;
+    }
+    
+    /// Erase a key by iterator. Return iterator to the next key.
+    Iterator Erase(const Iterator& it)
+    {
+        if (it.index_ >= capacity_ || hashes_[it.index_] <= FLAT_HASH_DELETED)
+            return End();
+        
+        Iterator next = it;
+        ++next;
+        EraseSlot(it.index_);
+        return next;
+    }
+    
+    /// Clear the set. The slots are retained for reuse.
+    void Clear()
+    {
+        if (size_)
+        {
+            for (unsigned i = 0; i < capacity_; ++i)
+            {
+                if (hashes_[i] > FLAT_HASH_DELETED)
+                    (slots_ + i)->~T();
+            }
+        }
+        
+        if (capacity_)
+            memset(hashes_, 0, capacity_ * sizeof(unsigned));
+        size_ = 0;
+        deleted_ = 0;
+    }
+    
+    /// Reserve slots for at least the given amount of keys, so that inserting up to it does not move existing keys.
+    void Reserve(unsigned size)
+    {
+        unsigned capacity = CalculateCapacity(size);
+        if (capacity > capacity_)
+            Rehash(capacity);
+    }
+    
+    /// Swap with another flat hash set.
+    void Swap(FlatHashSet<T>& rhs)
+    {
+        FlatHashBase::Swap(rhs);
+        Urho3D::Swap(slots_, rhs.slots_);
+    }
+    
+    /// Return iterator to the key, or end iterator if not found.
+    Iterator Find(const T& key)
+    {
+        if (!capacity_)
+            return End();
+        
+        return MakeIterator(FindIndex(key, StoredHash(MakeHash(key))));
+    }
+    
+    /// Return const iterator to the key, or end iterator if not found.
+    ConstIterator Find(const T& key) const
+    {
+        if (!capacity_)
+            return End();
+        
+        return MakeIterator(FindIndex(key, StoredHash(MakeHash(key))));
+    }
+    
+    /// Return whether contains a key.
+    bool Contains(const T& key) const
+    {
+        if (!capacity_)
+            return false;
+        
+        return FindIndex(key, StoredHash(MakeHash(key))) != capacity_;
+    }
+    
+    /// Return iterator to the beginning.
+    Iterator Begin() { return MakeIterator(FirstIndex()); }
+    /// Return iterator to the beginning.
+    ConstIterator Begin() const { return MakeIterator(FirstIndex()); }
+    /// Return iterator to the end.
+    Iterator End() { return MakeIterator(capacity_); }
+    /// Return iterator to the end.
+    ConstIterator End() const { return MakeIterator(capacity_); }
+
+private:
+    /// Return iterator to a slot index.
+    Iterator MakeIterator(unsigned index) { return Iterator(hashes_, slots_, index, capacity_); }
+    /// Return const iterator to a slot index.
+    ConstIterator MakeIterator(unsigned index) const { return ConstIterator(hashes_, slots_, index, capacity_); }
+    
+    /// Find the slot index of a key, or return capacity if not found. Do not call if the slots have not been allocated.
+    unsigned FindIndex(const T& key, unsigned hash) const
+    {
+        unsigned index = StartIndex(hash);
+        for (;;)
+        {
+            unsigned slotHash = hashes_[index];
+            if (slotHash == FLAT_HASH_EMPTY)
+                return capacity_;
+            if (slotHash == hash && slots_[index] == key)
+                return index;
+            index = NextIndex(index);
+        }
+    }
+    
+    /// Insert a key known not to exist. Return the slot index.
+    unsigned InsertSlot(const T& key, unsigned hash)
+    {
+        // Rehash if the maximum load factor would be exceeded. Only grow if there are not enough erased slots to reclaim
+        if (NeedRehash())
+        {
+            unsigned capacity = CalculateCapacity(size_ + 1);
+            Rehash(capacity > capacity_ ? capacity : capacity_);
+        }
+        
+        unsigned index = StartIndex(hash);
+        while (hashes_[index] > FLAT_HASH_DELETED)
+            index = NextIndex(index);
+        
+        if (hashes_[index] == FLAT_HASH_DELETED)
+            --deleted_;
+        hashes_[index] = hash;
+        new(slots_ + index) T(key);
+        ++size_;
+        
+        return index;
+    }
+    
+    /// Erase an occupied slot.
+    void EraseSlot(unsigned index)
+    {
+        (slots_ + index)->~T();
+        --size_;
+        
+        // If the next slot is empty, no probe sequence continues past this one and it can be emptied directly
+        if (hashes_[NextIndex(index)] == FLAT_HASH_EMPTY)
+            hashes_[index] = FLAT_HASH_EMPTY;
+        else
+        {
+            hashes_[index] = FLAT_HASH_DELETED;
+            ++deleted_;
+        }
+    }
+    
+    /// Reallocate the slots to a new power of two capacity and reinsert the keys.
+    void Rehash(unsigned capacity)
+    {
+        unsigned* oldHashes = hashes_;
+        T* oldSlots = slots_;
+        unsigned oldCapacity = capacity_;
+        
+        AllocateHashes(capacity);
+        slots_ = reinterpret_cast<T*>(new unsigned char[capacity * sizeof(T)]);
+        
+        for (unsigned i = 0; i < oldCapacity; ++i)
+        {
+            unsigned hash = oldHashes[i];
+            if (hash > FLAT_HASH_DELETED)
+            {
+                unsigned index = StartIndex(hash);
+                while (hashes_[index] != FLAT_HASH_EMPTY)
+                    index = NextIndex(index);
+                
+                hashes_[index] = hash;
+                new(slots_ + index) T(oldSlots[i]);
+                (oldSlots + i)->~T();
+            }
+        }
+        
+        delete[] oldHashes;
+        FreeSlots(oldSlots);
+    }
+    
+    /// Free slot storage without destructing.
+    static void FreeSlots(T* slots) { delete[] reinterpret_cast<unsigned char*>(slots); }
+    
+    /// Slot keys, constructed only where the slot hash marks them occupied.
+    T* slots_;
+};
+
+}
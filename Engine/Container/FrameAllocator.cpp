@@ -0,0 +1,118 @@
+//
+// Copyright (c) 2008-2013 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "FrameAllocator.h"
+
+#include "DebugNew.h"
+
+namespace Urho3D
+{
+
+static const unsigned FRAME_ALLOCATOR_ALIGNMENT = 16;
+
+FrameAllocator::FrameAllocator(unsigned blockSize) :
+    blockSize_(blockSize ? blockSize : DEFAULT_FRAME_BLOCK_SIZE),
+    currentBlock_(0),
+    offset_(0),
+    used_(0),
+    peak_(0)
+{
+}
+
+FrameAllocator::~FrameAllocator()
+{
+    FreeBlocks();
+}
+
+void* FrameAllocator::Allocate(unsigned size)
+{
+    size = (size + FRAME_ALLOCATOR_ALIGNMENT - 1) & ~(FRAME_ALLOCATOR_ALIGNMENT - 1);
+    
+    // Continue to the next already allocated block if the current one is full
+    while (currentBlock_ < blocks_.Size())
+    {
+        FrameAllocatorBlock& block = blocks_[currentBlock_];
+        if (offset_ + size <= block.size_)
+        {
+            void* ptr = block.data_ + offset_;
+            offset_ += size;
+            used_ += size;
+            return ptr;
+        }
+        
+        ++currentBlock_;
+        offset_ = 0;
+    }
+    
+    AllocateBlock(size > blockSize_ ? size : blockSize_);
+    offset_ = size;
+    used_ += size;
+    return blocks_.Back().data_;
+}
+
+void FrameAllocator::Reset()
+{
+    if (used_ > peak_)
+        peak_ = used_;
+    
+    // If the frame needed several blocks, replace them with one block large enough for all, so that the following frames
+    // allocate linearly from a single block
+    if (blocks_.Size() > 1)
+    {
+        unsigned totalSize = GetReservedMemory();
+        FreeBlocks();
+        AllocateBlock(totalSize);
+    }
+    
+    currentBlock_ = 0;
+    offset_ = 0;
+    used_ = 0;
+}
+
+unsigned FrameAllocator::GetReservedMemory() const
+{
+    unsigned totalSize = 0;
+    for (unsigned i = 0; i < blocks_.Size(); ++i)
+        totalSize += blocks_[i].size_;
+    return totalSize;
+}
+
+void FrameAllocator::AllocateBlock(unsigned size)
+{
+    // Operator new may guarantee only 8-byte alignment, so allocate extra to align the start of the block
+    FrameAllocatorBlock newBlock;
+    newBlock.memory_ = new unsigned char[size + FRAME_ALLOCATOR_ALIGNMENT - 1];
+    newBlock.data_ = reinterpret_cast<unsigned char*>(((size_t)newBlock.memory_ + FRAME_ALLOCATOR_ALIGNMENT - 1) &
+        ~(size_t)(FRAME_ALLOCATOR_ALIGNMENT - 1));
+    newBlock.size_ = size;
+    blocks_.Push(newBlock);
+    currentBlock_ = blocks_.Size() - 1;
+}
+
+void FrameAllocator::FreeBlocks()
+{
+    for (unsigned i = 0; i < blocks_.Size(); ++i)
+        delete[] blocks_[i].memory_;
+    blocks_.Clear();
+}
+
+}
@@ -0,0 +1,283 @@
+//
+// Copyright (c) 2008-2013 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "RefCounted.h"
+#include "Vector.h"
+
+namespace Urho3D
+{
+
+/// Default size of a frame allocator memory block.
+static const unsigned DEFAULT_FRAME_BLOCK_SIZE = 65536;
+
+/// %Frame allocator memory block.
+struct FrameAllocatorBlock
+{
+    /// Allocated memory.
+    unsigned char* memory_;
+    /// Start of the usable memory, aligned to 16 bytes.
+    unsigned char* data_;
+    /// Size in bytes.
+    unsigned size_;
+};
+
+/// Linear allocator for transient data that lives at most until the end of the frame. Allocations are not freed individually, but all at once by Reset(). Not thread-safe, use one allocator per thread.
+class FrameAllocator : public RefCounted
+{
+public:
+    /// Construct with memory block size.
+    FrameAllocator(unsigned blockSize = DEFAULT_FRAME_BLOCK_SIZE);
+    /// Destruct. Free all memory blocks.
+    ~FrameAllocator();
+    
+    /// Allocate memory. The memory is aligned to 16 bytes and remains valid until Reset().
+    void* Allocate(unsigned size);
+    /// Release all allocations. If several memory blocks were needed, they are combined into one.
+    void Reset();
+    
+    /// Return amount of memory allocated since the last reset.
+    unsigned GetUsedMemory() const { return used_; }
+    /// Return the highest amount of memory allocated between two resets.
+    unsigned GetPeakMemory() const { return used_ > peak_ ? used_ : peak_; }
+    /// Return total size of the memory blocks.
+    unsigned GetReservedMemory() const;
+    
+private:
+    /// Prevent copy construction.
+    FrameAllocator(const FrameAllocator& rhs);
+    /// Prevent assignment.
+    FrameAllocator& operator = (const FrameAllocator& rhs);
+    
+    /// Allocate a new memory block and make it current.
+    void AllocateBlock(unsigned size);
+    /// Free all memory blocks.
+    void FreeBlocks();
+    
+    /// Memory blocks.
+    PODVector<FrameAllocatorBlock> blocks_;
+    /// Memory block size.
+    unsigned blockSize_;
+    /// Index of the block currently being allocated from.
+    unsigned currentBlock_;
+    /// Allocation offset in the current block.
+    unsigned offset_;
+    /// Memory allocated since the last reset.
+    unsigned used_;
+    /// Highest memory use between two resets.
+    unsigned peak_;
+};
+
+/// %Vector template class for POD types that allocates from a frame allocator. Growing the vector does not free the previous buffer, as the frame allocator reclaims all memory at once. The vector must be cleared before reuse after the allocator has been reset.
+template <class T> class FrameVector
+{
+public:
+    typedef RandomAccessIterator<T> Iterator;
+    typedef RandomAccessConstIterator<T> ConstIterator;
+    
+    /// Construct empty without an allocator.
+    FrameVector() :
+        allocator_(0),
+        buffer_(0),
+        size_(0),
+        capacity_(0)
+    {
+    }
+    
+    /// Construct empty with an allocator.
+    explicit FrameVector(FrameAllocator* allocator) :
+        allocator_(allocator),
+        buffer_(0),
+        size_(0),
+        capacity_(0)
+    {
+    }
+    
+    /// Construct from another vector. Uses the same allocator.
+    FrameVector(const FrameVector<T>& vector) :
+        allocator_(vector.allocator_),
+        buffer_(0),
+        size_(0),
+        capacity_(0)
+    {
+        *this = vector;
+    }
+    
+    /// Assign from another vector. Uses the other vector's allocator if one has not been set.
+    FrameVector<T>& operator = (const FrameVector<T>& rhs)
+    {
+        if (&rhs != this)
+        {
+            if (!allocator_)
+                allocator_ = rhs.allocator_;
+            Resize(rhs.size_);
+            CopyElements(buffer_, rhs.buffer_, rhs.size_);
+        }
+        return *this;
+    }
+    
+    /// Return element at index.
+    T& operator [] (unsigned index) { assert(index < size_); return buffer_[index]; }
+    /// Return const element at index.
+    const T& operator [] (unsigned index) const { assert(index < size_); return buffer_[index]; }
+    /// Return element at index.
+    T& At(unsigned index) { assert(index < size_); return buffer_[index]; }
+    /// Return const element at index.
+    const T& At(unsigned index) const { assert(index < size_); return buffer_[index]; }
+    
+    /// Set the allocator and clear the vector.
+    void SetAllocator(FrameAllocator* allocator)
+    {
+        allocator_ = allocator;
+        Clear();
+    }
+    
+    /// Add an element at the end.
+    void Push(const T& value)
+    {
+        if (size_ < capacity_)
+            ++size_;
+        else
+            Resize(size_ + 1);
+        Back() = value;
+    }
+    
+    /// Remove the last element.
+    void Pop()
+    {
+        if (size_)
+            --size_;
+    }
+    
+    /// Erase a range of elements.
+    void Erase(unsigned pos, unsigned length = 1)
+    {
+        // Return if the range is illegal
+        if (!length || pos + length > size_)
+            return;
+        
+        if (size_ - pos - length)
+            memmove(buffer_ + pos, buffer_ + pos + length, (size_ - pos - length) * sizeof(T));
+        size_ -= length;
+    }
+    
+    /// Clear the vector and forget its buffer, so that the next frame's allocations are not overwritten.
+    void Clear()
+    {
+        buffer_ = 0;
+        size_ = 0;
+        capacity_ = 0;
+    }
+    
+    /// Resize the vector.
+    void Resize(unsigned newSize)
+    {
+        if (newSize > capacity_)
+        {
+            unsigned newCapacity = capacity_ ? capacity_ + ((capacity_ + 1) >> 1) : MIN_CAPACITY;
+            Reserve(newCapacity > newSize ? newCapacity : newSize);
+        }
+        
+        size_ = newSize;
+    }
+    
+    /// Reserve capacity. Only grows the vector.
+    void Reserve(unsigned newCapacity)
+    {
+        if (newCapacity <= capacity_)
+            return;
+        
+        assert(allocator_);
+        T* newBuffer = reinterpret_cast<T*>(allocator_->Allocate(newCapacity * sizeof(T)));
+        CopyElements(newBuffer, buffer_, size_);
+        buffer_ = newBuffer;
+        capacity_ = newCapacity;
+    }
+    
+    /// Return iterator to value, or to the end if not found.
+    Iterator Find(const T& value)
+    {
+        Iterator it = Begin();
+        while (it != End() && *it != value)
+            ++it;
+        return it;
+    }
+    
+    /// Return const iterator to value, or to the end if not found.
+    ConstIterator Find(const T& value) const
+    {
+        ConstIterator it = Begin();
+        while (it != End() && *it != value)
+            ++it;
+        return it;
+    }
+    
+    /// Return whether contains a specific value.
+    bool Contains(const T& value) const { return Find(value) != End(); }
+    /// Return iterator to the beginning.
+    Iterator Begin() { return Iterator(buffer_); }
+    /// Return const iterator to the beginning.
+    ConstIterator Begin() const { return ConstIterator(buffer_); }
+    /// Return iterator to the end.
+    Iterator End() { return Iterator(buffer_ + size_); }
+    /// Return const iterator to the end.
+    ConstIterator End() const { return ConstIterator(buffer_ + size_); }
+    /// Return first element.
+    T& Front() { assert(size_); return buffer_[0]; }
+    /// Return const first element.
+    const T& Front() const { assert(size_); return buffer_[0]; }
+    /// Return last element.
+    T& Back() { assert(size_); return buffer_[size_ - 1]; }
+    /// Return const last element.
+    const T& Back() const { assert(size_); return buffer_[size_ - 1]; }
+    /// Return number of elements.
+    unsigned Size() const { return size_; }
+    /// Return capacity of vector.
+    unsigned Capacity() const { return capacity_; }
+    /// Return whether vector is empty.
+    bool Empty() const { return size_ == 0; }
+    /// Return the allocator.
+    FrameAllocator* GetAllocator() const { return allocator_; }
+    
+    /// Initial capacity when the first element is added.
+    static const unsigned MIN_CAPACITY = 8;
+    
+private:
+    /// Copy elements from one buffer to another.
+    static void CopyElements(T* dest, const T* src, unsigned count)
+    {
+        if (count)
+            memcpy(dest, src, count * sizeof(T));
+    }
+    
+    /// Frame allocator.
+    FrameAllocator* allocator_;
+    /// Buffer.
+    T* buffer_;
+    /// Size of vector.
+    unsigned size_;
+    /// Buffer capacity.
+    unsigned capacity_;
+};
+
+}
@@ -123,6 +123,8 @@ public:
     unsigned NumBuckets() const { return ptrs_ ? (reinterpret_cast<unsigned*>(ptrs_))[1] : 0; }
     /// Return whether has no elements.
     bool Empty() const { return Size() == 0; }
+    /// Return the shared node allocator, or null if the own allocator is used.
+    SharedAllocator* GetSharedAllocator() const { return allocator_ ? allocator_->shared_ : 0; }
     
 protected:
     /// Allocate bucket head pointers + room for size and bucket count variables.
@@ -133,6 +135,16 @@ protected:
     void SetSize(unsigned size) { if (ptrs_) (reinterpret_cast<unsigned*>(ptrs_))[0] = size; }
     /// Return bucket head pointers.
     HashNodeBase** Ptrs() const { return ptrs_ ? ptrs_ + 2 : 0; }
+    /// Reserve memory for a node from the shared or own allocator.
+    void* AllocateNodeMemory() { return allocator_->shared_ ? SharedAllocatorReserve(allocator_->shared_) : AllocatorReserve(allocator_); }
+    /// Free node memory to the shared or own allocator.
+    void FreeNodeMemory(void* ptr)
+    {
+        if (allocator_->shared_)
+            SharedAllocatorFree(allocator_->shared_, ptr);
+        else
+            AllocatorFree(allocator_, ptr);
+    }
     
     /// List head node pointer.
     HashNodeBase* head_;
@@ -140,7 +152,7 @@ protected:
     HashNodeBase* tail_;
     /// Bucket head pointers.
     HashNodeBase** ptrs_;
-    /// Node allocator.
+    /// Node allocator. Also holds the thread-safe node allocator shared with other containers, if set, so that a hash set or map stays within the size of four pointers and fits inside a Variant.
     AllocatorBlock* allocator_;
 };
 
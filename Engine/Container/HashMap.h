@@ -52,6 +52,15 @@ public:
         {
         }
         
+        #ifdef URHO3D_CXX11
+        /// Construct with key and value constructed in place.
+        template <class... Args> KeyValue(const T& first, Args&&... args) :
+            first_(first),
+            second_(Forward<Args>(args)...)
+        {
+        }
+        #endif
+        
         /// Test for equality with another pair.
         bool operator == (const KeyValue& rhs) const { return first_ == rhs.first_ && second_ == rhs.second_; }
         /// Test for inequality with another pair.
@@ -77,6 +86,14 @@ public:
         {
         }
         
+        #ifdef URHO3D_CXX11
+        /// Construct with key and value constructed in place.
+        template <class... Args> Node(const T& key, Args&&... args) :
+            pair_(key, Forward<Args>(args)...)
+        {
+        }
+        #endif
+        
         /// Key-value pair.
         KeyValue pair_;
         
@@ -171,6 +188,16 @@ public:
         *this = map;
     }
     
+    #ifdef URHO3D_CXX11
+    /// Move-construct from another hash map.
+    HashMap(HashMap<T, U>&& map)
+    {
+        allocator_ = AllocatorInitialize(sizeof(Node));
+        head_ = tail_ = ReserveNode();
+        Swap(map);
+    }
+    #endif
+    
     /// Destruct.
     ~HashMap()
     {
@@ -187,6 +214,15 @@ public:
         return *this;
     }
     
+    #ifdef URHO3D_CXX11
+    /// Move-assign a hash map.
+    HashMap& operator = (HashMap<T, U>&& rhs)
+    {
+        Swap(rhs);
+        return *this;
+    }
+    #endif
+    
     /// Add-assign a pair.
     HashMap& operator += (const Pair<T, U>& rhs)
     {
@@ -258,6 +294,30 @@ public:
         return Iterator(InsertNode(pair.first_, pair.second_));
     }
     
+    #ifdef URHO3D_CXX11
+    /// Insert a value constructed in place, or replace the value if the key exists. Return an iterator to the pair.
+    template <class... Args> Iterator Emplace(const T& key, Args&&... args)
+    {
+        // If no pointers yet, allocate with minimum bucket count
+        if (!ptrs_)
+        {
+            AllocateBuckets(Size(), MIN_BUCKETS);
+            Rehash();
+        }
+        
+        unsigned hashKey = Hash(key);
+        
+        Node* existing = FindNode(key, hashKey);
+        if (existing)
+        {
+            existing->pair_.second_ = U(Forward<Args>(args)...);
+            return Iterator(existing);
+        }
+        
+        return Iterator(LinkNode(InsertNode(Tail(), ReserveNode(key, Forward<Args>(args)...)), hashKey));
+    }
+    #endif
+    
     /// Insert a map.
     void Insert(const HashMap<T, U>& map)
     {
@@ -333,6 +393,22 @@ public:
         return Iterator(next);
     }
     
+    /// Set a thread-safe node allocator shared with other containers, or null to use the own allocator. Its node size must be at least the size of the map's nodes, and it must outlive the map. Existing elements are kept.
+    void SetSharedAllocator(SharedAllocator* allocator)
+    {
+        if (allocator == GetSharedAllocator())
+            return;
+        assert(!allocator || allocator->nodeSize_ >= sizeof(Node));
+        
+        // Take the elements out, then copy them back into nodes from the new allocator
+        HashMap<T, U> elements;
+        Swap(elements);
+        FreeNode(Tail());
+        allocator_->shared_ = allocator;
+        head_ = tail_ = ReserveNode();
+        Insert(elements);
+    }
+    
     /// Clear the map.
     void Clear()
     {
@@ -513,7 +589,12 @@ private:
             }
         }
         
-        Node* newNode = InsertNode(Tail(), key, value);
+        return LinkNode(InsertNode(Tail(), ReserveNode(key, value)), hashKey);
+    }
+    
+    /// Link a new node into its bucket and rehash if necessary. Return the node.
+    Node* LinkNode(Node* newNode, unsigned hashKey)
+    {
         newNode->down_ = Ptrs()[hashKey];
         Ptrs()[hashKey] = newNode;
         
@@ -527,13 +608,9 @@ private:
         return newNode;
     }
     
-    /// Insert a node into the list. Return the new node.
-    Node* InsertNode(Node* dest, const T& key, const U& value)
+    /// Insert a reserved node into the list. Return the new node.
+    Node* InsertNode(Node* dest, Node* newNode)
     {
-        if (!dest)
-            return 0;
-        
-        Node* newNode = ReserveNode(key, value);
         Node* prev = dest->Prev();
         newNode->next_ = dest;
         newNode->prev_ = prev;
@@ -577,7 +654,7 @@ private:
     Node* ReserveNode()
     {
         assert(allocator_);
-        Node* newNode = static_cast<Node*>(AllocatorReserve(allocator_));
+        Node* newNode = static_cast<Node*>(AllocateNodeMemory());
         new(newNode) Node();
         return newNode;
     }
@@ -586,16 +663,27 @@ private:
     Node* ReserveNode(const T& key, const U& value)
     {
         assert(allocator_);
-        Node* newNode = static_cast<Node*>(AllocatorReserve(allocator_));
+        Node* newNode = static_cast<Node*>(AllocateNodeMemory());
         new(newNode) Node(key, value);
         return newNode;
     }
     
+    #ifdef URHO3D_CXX11
+    /// Reserve a node with specified key and value constructed in place.
+    template <class... Args> Node* ReserveNode(const T& key, Args&&... args)
+    {
+        assert(allocator_);
+        Node* newNode = static_cast<Node*>(AllocateNodeMemory());
+        new(newNode) Node(key, Forward<Args>(args)...);
+        return newNode;
+    }
+    #endif
+    
     /// Free a node.
     void FreeNode(Node* node)
     {
         (node)->~Node();
-        AllocatorFree(allocator_, node);
+        FreeNodeMemory(node);
     }
     
     /// Rehash the buckets.
@@ -303,6 +303,22 @@ public:
         return Iterator(next);
     }
     
+    /// Set a thread-safe node allocator shared with other containers, or null to use the own allocator. Its node size must be at least the size of the set's nodes, and it must outlive the set. Existing elements are kept.
+    void SetSharedAllocator(SharedAllocator* allocator)
+    {
+        if (allocator == GetSharedAllocator())
+            return;
+        assert(!allocator || allocator->nodeSize_ >= sizeof(Node));
+        
+        // Take the elements out, then copy them back into nodes from the new allocator
+        HashSet<T> elements;
+        Swap(elements);
+        FreeNode(Tail());
+        allocator_->shared_ = allocator;
+        head_ = tail_ = ReserveNode();
+        Insert(elements);
+    }
+    
     /// Clear the set.
     void Clear()
     {
@@ -509,7 +525,7 @@ private:
     /// Reserve a node.
     Node* ReserveNode()
     {
-        Node* newNode = static_cast<Node*>(AllocatorReserve(allocator_));
+        Node* newNode = static_cast<Node*>(AllocateNodeMemory());
         new(newNode) Node();
         return newNode;
     }
@@ -519,7 +535,7 @@ private:
     {
         if (!allocator_)
             allocator_ = AllocatorInitialize(sizeof(Node));
-        Node* newNode = static_cast<Node*>(AllocatorReserve(allocator_));
+        Node* newNode = static_cast<Node*>(AllocateNodeMemory());
         new(newNode) Node(key);
         return newNode;
     }
@@ -528,7 +544,7 @@ private:
     void FreeNode(Node* node)
     {
         (node)->~Node();
-        AllocatorFree(allocator_, node);
+        FreeNodeMemory(node);
     }
     
     /// Rehash the buckets.
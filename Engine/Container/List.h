@@ -24,6 +24,8 @@
 
 #include "ListBase.h"
 
+#include <cassert>
+
 namespace Urho3D
 {
 
@@ -45,6 +47,14 @@ public:
         {
         }
         
+        #ifdef URHO3D_CXX11
+        /// Construct value in place.
+        template <class... Args> Node(Args&&... args) :
+            value_(Forward<Args>(args)...)
+        {
+        }
+        #endif
+        
         /// Node value.
         T value_;
         
@@ -135,6 +145,16 @@ public:
         *this = list;
     }
     
+    #ifdef URHO3D_CXX11
+    /// Move-construct from another list.
+    List(List<T>&& list)
+    {
+        allocator_ = AllocatorInitialize(sizeof(Node));
+        head_ = tail_ = ReserveNode();
+        Swap(list);
+    }
+    #endif
+    
     /// Destruct.
     ~List()
     {
@@ -152,6 +172,15 @@ public:
         return *this;
     }
     
+    #ifdef URHO3D_CXX11
+    /// Move-assign from another list.
+    List& operator = (List<T>&& rhs)
+    {
+        Swap(rhs);
+        return *this;
+    }
+    #endif
+    
     /// Add-assign an element.
     List& operator += (const T& rhs)
     {
@@ -211,6 +240,18 @@ public:
     /// Insert an element at position.
     void Insert(const Iterator& dest, const T& value) { InsertNode(static_cast<Node*>(dest.ptr_), value); }
     
+    #ifdef URHO3D_CXX11
+    /// Insert an element to the end by moving it.
+    void Push(T&& value) { LinkNode(Tail(), ReserveNode(Move(value))); }
+    /// Construct an element in place at the end. Return reference to it.
+    template <class... Args> T& EmplaceBack(Args&&... args)
+    {
+        Node* newNode = ReserveNode(Forward<Args>(args)...);
+        LinkNode(Tail(), newNode);
+        return newNode->value_;
+    }
+    #endif
+    
     /// Insert a list at position.
     void Insert(const Iterator& dest, const List<T>& list)
     {
@@ -269,6 +310,22 @@ public:
         return it;
     }
     
+    /// Set a thread-safe node allocator shared with other containers, or null to use the own allocator. Its node size must be at least the size of the list's nodes, and it must outlive the list. Existing elements are kept.
+    void SetSharedAllocator(SharedAllocator* allocator)
+    {
+        if (allocator == GetSharedAllocator())
+            return;
+        assert(!allocator || allocator->nodeSize_ >= sizeof(Node));
+        
+        // Take the elements out, then copy them back into nodes from the new allocator
+        List<T> elements;
+        Swap(elements);
+        FreeNode(Tail());
+        allocator_->shared_ = allocator;
+        head_ = tail_ = ReserveNode();
+        Insert(End(), elements);
+    }
+    
     /// Clear the list.
     void Clear()
     {
@@ -348,7 +405,12 @@ private:
         if (!dest)
             return;
         
-        Node* newNode = ReserveNode(value);
+        LinkNode(dest, ReserveNode(value));
+    }
+    
+    /// Link an allocated node into the list before the destination node.
+    void LinkNode(Node* dest, Node* newNode)
+    {
         Node* prev = dest->Prev();
         newNode->next_ = dest;
         newNode->prev_ = prev;
@@ -389,7 +451,7 @@ private:
     /// Reserve a node.
     Node* ReserveNode()
     {
-        Node* newNode = static_cast<Node*>(AllocatorReserve(allocator_));
+        Node* newNode = static_cast<Node*>(AllocateNodeMemory());
         new(newNode) Node();
         return newNode;
     }
@@ -397,16 +459,26 @@ private:
     /// Reserve a node with initial value.
     Node* ReserveNode(const T& value)
     {
-        Node* newNode = static_cast<Node*>(AllocatorReserve(allocator_));
+        Node* newNode = static_cast<Node*>(AllocateNodeMemory());
         new(newNode) Node(value);
         return newNode;
     }
     
+    #ifdef URHO3D_CXX11
+    /// Reserve a node and construct its value in place.
+    template <class... Args> Node* ReserveNode(Args&&... args)
+    {
+        Node* newNode = static_cast<Node*>(AllocateNodeMemory());
+        new(newNode) Node(Forward<Args>(args)...);
+        return newNode;
+    }
+    #endif
+    
     /// Free a node.
     void FreeNode(Node* node)
     {
         (node)->~Node();
-        AllocatorFree(allocator_, node);
+        FreeNodeMemory(node);
     }
 };
 
@@ -102,12 +102,26 @@ public:
         Urho3D::Swap(size_, rhs.size_);
     }
     
+    /// Return the shared node allocator, or null if the own allocator is used.
+    SharedAllocator* GetSharedAllocator() const { return allocator_ ? allocator_->shared_ : 0; }
+    
 protected:
+    /// Reserve memory for a node from the shared or own allocator.
+    void* AllocateNodeMemory() { return allocator_->shared_ ? SharedAllocatorReserve(allocator_->shared_) : AllocatorReserve(allocator_); }
+    /// Free node memory to the shared or own allocator.
+    void FreeNodeMemory(void* ptr)
+    {
+        if (allocator_->shared_)
+            SharedAllocatorFree(allocator_->shared_, ptr);
+        else
+            AllocatorFree(allocator_, ptr);
+    }
+    
     /// Head node pointer.
     ListNodeBase* head_;
     /// Tail node pointer.
     ListNodeBase* tail_;
-    /// Node allocator.
+    /// Node allocator. Also holds the thread-safe node allocator shared with other containers, if set.
     AllocatorBlock* allocator_;
     /// Number of nodes.
     unsigned size_;
@@ -0,0 +1,80 @@
+//
+// Copyright (c) 2008-2013 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+// Enable rvalue references, move operations and in-place construction when the compiler supports C++11
+#if !defined(URHO3D_CXX11) && (__cplusplus >= 201103L || defined(__GXX_EXPERIMENTAL_CXX0X__) || (defined(_MSC_VER) && _MSC_VER >= 1800))
+#define URHO3D_CXX11
+#endif
+
+// Allow functions and constructors to be evaluated at compile time when the compiler supports it (Visual Studio only from 2015)
+#if defined(URHO3D_CXX11) && (!defined(_MSC_VER) || _MSC_VER >= 1900)
+#define URHO3D_HAS_CONSTEXPR
+#define URHO3D_CONSTEXPR constexpr
+#else
+#define URHO3D_CONSTEXPR
+#endif
+
+namespace Urho3D
+{
+
+#ifdef URHO3D_CXX11
+/// Strip the reference from a type.
+template <class T> struct RemoveReference { typedef T Type; };
+/// Strip the reference from a type.
+template <class T> struct RemoveReference<T&> { typedef T Type; };
+/// Strip the reference from a type.
+template <class T> struct RemoveReference<T&&> { typedef T Type; };
+
+/// Cast a value to an rvalue reference so that it can be moved from.
+template <class T> inline typename RemoveReference<T>::Type&& Move(T&& value)
+{
+    return static_cast<typename RemoveReference<T>::Type&&>(value);
+}
+
+/// Forward an lvalue argument preserving its value category.
+template <class T> inline T&& Forward(typename RemoveReference<T>::Type& value)
+{
+    return static_cast<T&&>(value);
+}
+
+/// Forward an rvalue argument preserving its value category.
+template <class T> inline T&& Forward(typename RemoveReference<T>::Type&& value)
+{
+    return static_cast<T&&>(value);
+}
+#else
+/// Return the value as is, so that moves become copies without C++11.
+template <class T> inline T& Move(T& value)
+{
+    return value;
+}
+
+/// Return the value as is, so that moves become copies without C++11.
+template <class T> inline const T& Move(const T& value)
+{
+    return value;
+}
+#endif
+
+}
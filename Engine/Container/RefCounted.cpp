@@ -62,7 +62,27 @@ void RefCounted::ReleaseRef()
     assert(refCount_->refs_ > 0);
     (refCount_->refs_)--;
     if (!refCount_->refs_)
-        delete this;
+        Dispose();
+}
+
+void RefCounted::Dispose()
+{
+    delete this;
+}
+
+void RefCounted::RenewRefCount()
+{
+    assert(refCount_->refs_ == 0);
+    
+    // If no outside weak refs exist, the reference count structure can be kept as is. Otherwise mark it expired and leave
+    // it to the weak pointers
+    if (refCount_->weakRefs_ > 1)
+    {
+        refCount_->refs_ = -1;
+        (refCount_->weakRefs_)--;
+        refCount_ = new RefCount();
+        (refCount_->weakRefs_)++;
+    }
 }
 
 int RefCounted::Refs() const
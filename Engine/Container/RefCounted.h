@@ -69,6 +69,12 @@ public:
     /// Return pointer to the reference count structure.
     RefCount* RefCountPtr() { return refCount_; }
     
+protected:
+    /// Dispose of self when no more references. Default implementation deletes self, subclasses may recycle instead.
+    virtual void Dispose();
+    /// Expire weak references and reset the reference count, as if the object had been deleted and constructed again.
+    void RenewRefCount();
+    
 private:
     /// Prevent copy construction.
     RefCounted(const RefCounted& rhs);
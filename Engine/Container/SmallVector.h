@@ -0,0 +1,411 @@
+//
+// Copyright (c) 2008-2013 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "VectorBase.h"
+
+#include <cassert>
+#include <cstring>
+
+namespace Urho3D
+{
+
+/// %Vector template class for POD types that stores up to N elements inline, and only allocates memory when more are added. Like PODVector, the elements must need no construction or destruction. N must be at least 1.
+template <class T, unsigned N> class SmallVector : public VectorBase
+{
+public:
+    typedef RandomAccessIterator<T> Iterator;
+    typedef RandomAccessConstIterator<T> ConstIterator;
+    
+    /// Construct empty.
+    SmallVector()
+    {
+        SetLocalBuffer();
+    }
+    
+    /// Construct with initial size.
+    explicit SmallVector(unsigned size)
+    {
+        SetLocalBuffer();
+        Resize(size);
+    }
+    
+    /// Construct with initial data.
+    SmallVector(const T* data, unsigned size)
+    {
+        SetLocalBuffer();
+        Resize(size);
+        CopyElements(Buffer(), data, size);
+    }
+    
+    /// Construct from another vector.
+    SmallVector(const SmallVector<T, N>& vector)
+    {
+        SetLocalBuffer();
+        *this = vector;
+    }
+    
+    #ifdef URHO3D_CXX11
+    /// Move-construct from another vector.
+    SmallVector(SmallVector<T, N>&& vector)
+    {
+        SetLocalBuffer();
+        Swap(vector);
+    }
+    #endif
+    
+    /// Destruct.
+    ~SmallVector()
+    {
+        if (!IsLocal())
+            delete[] buffer_;
+    }
+    
+    /// Assign from another vector.
+    SmallVector<T, N>& operator = (const SmallVector<T, N>& rhs)
+    {
+        Resize(rhs.size_);
+        CopyElements(Buffer(), rhs.Buffer(), rhs.size_);
+        return *this;
+    }
+    
+    #ifdef URHO3D_CXX11
+    /// Move-assign from another vector.
+    SmallVector<T, N>& operator = (SmallVector<T, N>&& rhs)
+    {
+        Swap(rhs);
+        return *this;
+    }
+    #endif
+    
+    /// Add-assign an element.
+    SmallVector<T, N>& operator += (const T& rhs)
+    {
+        Push(rhs);
+        return *this;
+    }
+    
+    /// Add-assign another vector.
+    SmallVector<T, N>& operator += (const SmallVector<T, N>& rhs)
+    {
+        Push(rhs);
+        return *this;
+    }
+    
+    /// Add an element.
+    SmallVector<T, N> operator + (const T& rhs) const
+    {
+        SmallVector<T, N> ret(*this);
+        ret.Push(rhs);
+        return ret;
+    }
+    
+    /// Add another vector.
+    SmallVector<T, N> operator + (const SmallVector<T, N>& rhs) const
+    {
+        SmallVector<T, N> ret(*this);
+        ret.Push(rhs);
+        return ret;
+    }
+    
+    /// Test for equality with another vector.
+    bool operator == (const SmallVector<T, N>& rhs) const
+    {
+        if (rhs.size_ != size_)
+            return false;
+        
+        T* buffer = Buffer();
+        T* rhsBuffer = rhs.Buffer();
+        for (unsigned i = 0; i < size_; ++i)
+        {
+            if (buffer[i] != rhsBuffer[i])
+                return false;
+        }
+        
+        return true;
+    }
+    
+    /// Test for inequality with another vector.
+    bool operator != (const SmallVector<T, N>& rhs) const { return !(*this == rhs); }
+    
+    /// Return element at index.
+    T& operator [] (unsigned index) { assert(index < size_); return Buffer()[index]; }
+    /// Return const element at index.
+    const T& operator [] (unsigned index) const { assert(index < size_); return Buffer()[index]; }
+    /// Return element at index.
+    T& At(unsigned index) { assert(index < size_); return Buffer()[index]; }
+    /// Return const element at index.
+    const T& At(unsigned index) const { assert(index < size_); return Buffer()[index]; }
+    
+    /// Add an element at the end.
+    void Push(const T& value)
+    {
+        // Copy the value first, as it may refer to an element in the buffer that is about to be reallocated
+        T copy = value;
+        if (size_ < capacity_)
+            ++size_;
+        else
+            Resize(size_ + 1);
+        Back() = copy;
+    }
+    
+    /// Add another vector at the end.
+    void Push(const SmallVector<T, N>& vector)
+    {
+        unsigned oldSize = size_;
+        unsigned count = vector.size_;
+        Resize(size_ + count);
+        // Read the source after resizing, in case of adding the vector to itself
+        CopyElements(Buffer() + oldSize, vector.Buffer(), count);
+    }
+    
+    /// Remove the last element.
+    void Pop()
+    {
+        if (size_)
+            Resize(size_ - 1);
+    }
+    
+    /// Insert an element at position.
+    void Insert(unsigned pos, const T& value)
+    {
+        if (pos > size_)
+            pos = size_;
+        
+        T copy = value;
+        unsigned oldSize = size_;
+        Resize(size_ + 1);
+        MoveRange(pos + 1, pos, oldSize - pos);
+        Buffer()[pos] = copy;
+    }
+    
+    /// Insert an element using an iterator.
+    Iterator Insert(const Iterator& dest, const T& value)
+    {
+        unsigned pos = dest - Begin();
+        if (pos > size_)
+            pos = size_;
+        Insert(pos, value);
+        
+        return Begin() + pos;
+    }
+    
+    /// Insert elements.
+    Iterator Insert(const Iterator& dest, const T* start, const T* end)
+    {
+        unsigned pos = dest - Begin();
+        if (pos > size_)
+            pos = size_;
+        unsigned length = end - start;
+        Resize(size_ + length);
+        MoveRange(pos + length, pos, size_ - pos - length);
+        CopyElements(Buffer() + pos, start, length);
+        
+        return Begin() + pos;
+    }
+    
+    /// Insert a vector partially by iterators.
+    Iterator Insert(const Iterator& dest, const ConstIterator& start, const ConstIterator& end) { return Insert(dest, start.ptr_, end.ptr_); }
+    
+    /// Erase a range of elements.
+    void Erase(unsigned pos, unsigned length = 1)
+    {
+        // Return if the range is illegal
+        if (!length || pos + length > size_)
+            return;
+        
+        MoveRange(pos, pos + length, size_ - pos - length);
+        Resize(size_ - length);
+    }
+    
+    /// Erase an element using an iterator.
+    Iterator Erase(const Iterator& it)
+    {
+        unsigned pos = it - Begin();
+        if (pos >= size_)
+            return End();
+        Erase(pos);
+        
+        return Begin() + pos;
+    }
+    
+    /// Erase a range by iterators.
+    Iterator Erase(const Iterator& start, const Iterator& end)
+    {
+        unsigned pos = start - Begin();
+        if (pos >= size_)
+            return End();
+        unsigned length = end - start;
+        Erase(pos, length);
+        
+        return Begin() + pos;
+    }
+    
+    /// Erase an element if found.
+    bool Remove(const T& value)
+    {
+        Iterator i = Find(value);
+        if (i != End())
+        {
+            Erase(i);
+            return true;
+        }
+        else
+            return false;
+    }
+    
+    /// Clear the vector.
+    void Clear() { Resize(0); }
+    
+    /// Resize the vector.
+    void Resize(unsigned newSize)
+    {
+        if (newSize > capacity_)
+        {
+            unsigned newCapacity = capacity_;
+            while (newCapacity < newSize)
+                newCapacity += (newCapacity + 1) >> 1;
+            
+            SetBuffer(AllocateBuffer(newCapacity * sizeof(T)), newCapacity);
+        }
+        
+        size_ = newSize;
+    }
+    
+    /// Set new capacity. A capacity up to N uses the inline buffer.
+    void Reserve(unsigned newCapacity)
+    {
+        if (newCapacity < size_)
+            newCapacity = size_;
+        if (newCapacity <= N)
+            newCapacity = N;
+        
+        if (newCapacity != capacity_)
+            SetBuffer(newCapacity > N ? AllocateBuffer(newCapacity * sizeof(T)) : localBuffer_, newCapacity);
+    }
+    
+    /// Reallocate so that no extra memory is used, or return to the inline buffer if the elements fit.
+    void Compact() { Reserve(size_); }
+    
+    /// Swap with another vector.
+    void Swap(SmallVector<T, N>& rhs)
+    {
+        if (!IsLocal() && !rhs.IsLocal())
+            VectorBase::Swap(rhs);
+        else
+        {
+            SmallVector<T, N> temp(*this);
+            *this = rhs;
+            rhs = temp;
+        }
+    }
+    
+    /// Return iterator to value, or to the end if not found.
+    Iterator Find(const T& value)
+    {
+        Iterator it = Begin();
+        while (it != End() && *it != value)
+            ++it;
+        return it;
+    }
+    
+    /// Return const iterator to value, or to the end if not found.
+    ConstIterator Find(const T& value) const
+    {
+        ConstIterator it = Begin();
+        while (it != End() && *it != value)
+            ++it;
+        return it;
+    }
+    
+    /// Return whether contains a specific value.
+    bool Contains(const T& value) const { return Find(value) != End(); }
+    /// Return iterator to the beginning.
+    Iterator Begin() { return Iterator(Buffer()); }
+    /// Return const iterator to the beginning.
+    ConstIterator Begin() const { return ConstIterator(Buffer()); }
+    /// Return iterator to the end.
+    Iterator End() { return Iterator(Buffer() + size_); }
+    /// Return const iterator to the end.
+    ConstIterator End() const { return ConstIterator(Buffer() + size_); }
+    /// Return first element.
+    T& Front() { return Buffer()[0]; }
+    /// Return const first element.
+    const T& Front() const { return Buffer()[0]; }
+    /// Return last element.
+    T& Back() { assert(size_); return Buffer()[size_ - 1]; }
+    /// Return const last element.
+    const T& Back() const { assert(size_); return Buffer()[size_ - 1]; }
+    /// Return number of elements.
+    unsigned Size() const { return size_; }
+    /// Return capacity of vector.
+    unsigned Capacity() const { return capacity_; }
+    /// Return whether vector is empty.
+    bool Empty() const { return size_ == 0; }
+    /// Return whether the elements are stored in the inline buffer.
+    bool IsLocal() const { return buffer_ == localBuffer_; }
+    
+private:
+    /// Return the buffer with right type.
+    T* Buffer() const { return reinterpret_cast<T*>(buffer_); }
+    
+    /// Point to the empty inline buffer.
+    void SetLocalBuffer()
+    {
+        capacity_ = N;
+        buffer_ = localBuffer_;
+    }
+    
+    /// Move the elements to a new buffer and delete the old buffer if it was dynamically allocated.
+    void SetBuffer(unsigned char* newBuffer, unsigned newCapacity)
+    {
+        CopyElements(reinterpret_cast<T*>(newBuffer), Buffer(), size_);
+        if (!IsLocal())
+            delete[] buffer_;
+        buffer_ = newBuffer;
+        capacity_ = newCapacity;
+    }
+    
+    /// Move a range of elements within the vector.
+    void MoveRange(unsigned dest, unsigned src, unsigned count)
+    {
+        if (count)
+            memmove(Buffer() + dest, Buffer() + src, count * sizeof(T));
+    }
+    
+    /// Copy elements from one buffer to another.
+    static void CopyElements(T* dest, const T* src, unsigned count)
+    {
+        if (count)
+            memcpy(dest, src, count * sizeof(T));
+    }
+    
+    /// Inline buffer, aligned for the element type.
+    union
+    {
+        unsigned char localBuffer_[N * sizeof(T)];
+        T alignment_;
+    };
+};
+
+}
@@ -23,12 +23,13 @@
 #pragma once
 
 #include "Swap.h"
-#include "VectorBase.h"
+#include "Vector.h"
 
 namespace Urho3D
 {
 
 static const int QUICKSORT_THRESHOLD = 16;
+static const int RADIXSORT_THRESHOLD = 64;
 
 // Based on Comparison of several sorting algorithms by Juha Nieminen
 // http://warp.povusers.org/SortComparison/
@@ -141,4 +142,96 @@ template <class T, class U> void Sort(RandomAccessIterator<T> begin, RandomAcces
     InsertionSort(begin, end, compare);
 }
 
+/// Merge two sorted arrays into a destination array using a compare function. On equal elements, those of the first array come first.
+template <class T, class U> void Merge(const T* first, const T* firstEnd, const T* second, const T* secondEnd, T* dest, U compare)
+{
+    while (first != firstEnd && second != secondEnd)
+    {
+        if (compare(*second, *first))
+            *dest++ = *second++;
+        else
+            *dest++ = *first++;
+    }
+    
+    while (first != firstEnd)
+        *dest++ = *first++;
+    while (second != secondEnd)
+        *dest++ = *second++;
+}
+
+/// Return an unsigned integer that sorts in the same order as a float value, for use as a radix sort key.
+inline unsigned FloatRadixKey(float value)
+{
+    // Reinterpret the bits through a union, as a pointer cast would break strict aliasing
+    union
+    {
+        float f;
+        unsigned u;
+    } bits;
+    bits.f = value;
+    return (bits.u & 0x80000000) ? ~bits.u : bits.u | 0x80000000;
+}
+
+/// Sort in ascending order of unsigned integer keys returned by a key function. Uses a least significant digit radix sort, which skips the bytes that are equal in all keys, and an insertion sort for small arrays. Stable, so sorting first by a secondary and then by a primary key sorts by both. The buffer is resized to hold a copy of the array. Only for POD types.
+template <class T, class K> void RadixSort(RandomAccessIterator<T> begin, RandomAccessIterator<T> end, PODVector<T>& buffer, K (*key)(const T&))
+{
+    unsigned count = end - begin;
+    
+    if (count < RADIXSORT_THRESHOLD)
+    {
+        for (RandomAccessIterator<T> i = begin + 1; i < end; ++i)
+        {
+            T temp = *i;
+            K tempKey = key(temp);
+            RandomAccessIterator<T> j = i;
+            while (j > begin && tempKey < key(*(j - 1)))
+            {
+                *j = *(j - 1);
+                --j;
+            }
+            *j = temp;
+        }
+        return;
+    }
+    
+    // Count the occurrences of each value of each key byte in one pass
+    unsigned offsets[sizeof(K)][256];
+    memset(offsets, 0, sizeof offsets);
+    for (RandomAccessIterator<T> i = begin; i < end; ++i)
+    {
+        K value = key(*i);
+        for (unsigned j = 0; j < sizeof(K); ++j)
+            ++offsets[j][(value >> (j * 8)) & 0xff];
+    }
+    
+    buffer.Resize(count);
+    T* src = begin.ptr_;
+    T* dest = &buffer[0];
+    
+    for (unsigned j = 0; j < sizeof(K); ++j)
+    {
+        unsigned shift = j * 8;
+        unsigned* byteOffsets = offsets[j];
+        if (byteOffsets[(key(*src) >> shift) & 0xff] == count)
+            continue;
+        
+        unsigned offset = 0;
+        for (unsigned k = 0; k < 256; ++k)
+        {
+            unsigned byteCount = byteOffsets[k];
+            byteOffsets[k] = offset;
+            offset += byteCount;
+        }
+        
+        for (unsigned k = 0; k < count; ++k)
+            dest[byteOffsets[(key(src[k]) >> shift) & 0xff]++] = src[k];
+        
+        Swap(src, dest);
+    }
+    
+    // After an odd number of passes the result is in the buffer
+    if (src != begin.ptr_)
+        memcpy(begin.ptr_, src, count * sizeof(T));
+}
+
 }
@@ -333,29 +333,39 @@ String::Iterator String::Erase(const String::Iterator& start, const String::Iter
 
 void String::Resize(unsigned newLength)
 {
-    if (!capacity_)
+    unsigned capacity = Capacity();
+    if (!capacity)
     {
-        // Calculate initial capacity
-        capacity_ = newLength + 1;
-        if (capacity_ < MIN_CAPACITY)
-            capacity_ = MIN_CAPACITY;
-        
-        buffer_ = new char[capacity_];
+        // Use the inline buffer if the string fits, otherwise calculate initial capacity
+        if (newLength < LOCAL_CAPACITY)
+            buffer_ = localBuffer_;
+        else
+        {
+            capacity_ = newLength + 1;
+            if (capacity_ < MIN_CAPACITY)
+                capacity_ = MIN_CAPACITY;
+            
+            buffer_ = new char[capacity_];
+        }
     }
     else
     {
-        if (newLength && capacity_ < newLength + 1)
+        if (newLength && capacity < newLength + 1)
         {
             // Increase the capacity with half each time it is exceeded
-            while (capacity_ < newLength + 1)
-                capacity_ += (capacity_ + 1) >> 1;
+            unsigned oldCapacity = capacity;
+            while (capacity < newLength + 1)
+                capacity += (capacity + 1) >> 1;
             
-            char* newBuffer = new char[capacity_];
+            char* newBuffer = new char[capacity];
             // Move the existing data to the new buffer, then delete the old buffer
             if (length_)
                 CopyChars(newBuffer, buffer_, length_);
-            delete[] buffer_;
+            if (oldCapacity > LOCAL_CAPACITY)
+                delete[] buffer_;
             
+            // Store the capacity only after the copy, as it overlaps the inline buffer
+            capacity_ = capacity;
             buffer_ = newBuffer;
         }
     }
@@ -368,22 +378,27 @@ void String::Reserve(unsigned newCapacity)
 {
     if (newCapacity < length_ + 1)
         newCapacity = length_ + 1;
-    if (newCapacity == capacity_)
+    // Use the inline buffer if the requested capacity fits in it
+    if (newCapacity <= LOCAL_CAPACITY)
+        newCapacity = LOCAL_CAPACITY;
+    unsigned capacity = Capacity();
+    if (newCapacity == capacity)
         return;
     
-    char* newBuffer = new char[newCapacity];
+    char* newBuffer = newCapacity > LOCAL_CAPACITY ? new char[newCapacity] : localBuffer_;
     // Move the existing data to the new buffer, then delete the old buffer
     CopyChars(newBuffer, buffer_, length_ + 1);
-    if (capacity_)
+    if (capacity > LOCAL_CAPACITY)
         delete[] buffer_;
     
-    capacity_ = newCapacity;
+    if (newCapacity > LOCAL_CAPACITY)
+        capacity_ = newCapacity;
     buffer_ = newBuffer;
 }
 
 void String::Compact()
 {
-    if (capacity_)
+    if (Capacity())
         Reserve(length_ + 1);
 }
 
@@ -394,9 +409,19 @@ void String::Clear()
 
 void String::Swap(String& str)
 {
+    bool local = buffer_ == localBuffer_;
+    bool strLocal = str.buffer_ == str.localBuffer_;
+    
+    // Exchange the inline buffers, which also exchanges the capacities, then point the buffers to the correct inline storage
+    for (unsigned i = 0; i < LOCAL_CAPACITY; ++i)
+        Urho3D::Swap(localBuffer_[i], str.localBuffer_[i]);
     Urho3D::Swap(length_, str.length_);
-    Urho3D::Swap(capacity_, str.capacity_);
     Urho3D::Swap(buffer_, str.buffer_);
+    
+    if (strLocal)
+        buffer_ = localBuffer_;
+    if (local)
+        str.buffer_ = str.localBuffer_;
 }
 
 String String::Substring(unsigned pos) const
@@ -1124,22 +1149,29 @@ WString::WString(const String& str) :
 
 WString::~WString()
 {
-    delete[] buffer_;
+    if (buffer_ != localBuffer_)
+        delete[] buffer_;
 }
 
 void WString::Resize(unsigned newSize)
 {
     if (!newSize)
     {
-        delete[] buffer_;
+        if (buffer_ != localBuffer_)
+            delete[] buffer_;
         buffer_ = 0;
         length_ = 0;
     }
     else
     {
-        wchar_t* newBuffer = new wchar_t[newSize + 1];
-        if (buffer_)
-            memcpy(newBuffer, buffer_, length_ * sizeof(wchar_t));
+        // Use the inline buffer if the string fits
+        wchar_t* newBuffer = newSize < LOCAL_CAPACITY ? localBuffer_ : new wchar_t[newSize + 1];
+        if (buffer_ && buffer_ != newBuffer)
+        {
+            memcpy(newBuffer, buffer_, (length_ < newSize ? length_ : newSize) * sizeof(wchar_t));
+            if (buffer_ != localBuffer_)
+                delete[] buffer_;
+        }
         newBuffer[newSize] = 0;
         buffer_ = newBuffer;
         length_ = newSize;
@@ -59,6 +59,17 @@ public:
         *this = str;
     }
     
+    #ifdef URHO3D_CXX11
+    /// Move-construct from another string.
+    String(String&& str) :
+        length_(0),
+        capacity_(0),
+        buffer_(&endZero)
+    {
+        Swap(str);
+    }
+    #endif
+    
     /// Construct from a C string.
     String(const char* str) :
         length_(0),
@@ -139,7 +150,7 @@ public:
     /// Destruct.
     ~String()
     {
-        if (capacity_)
+        if (Capacity() > LOCAL_CAPACITY)
             delete[] buffer_;
     }
     
@@ -152,6 +163,15 @@ public:
         return *this;
     }
     
+    #ifdef URHO3D_CXX11
+    /// Move-assign a string.
+    String& operator = (String&& rhs)
+    {
+        Swap(rhs);
+        return *this;
+    }
+    #endif
+    
     /// Assign a C string.
     String& operator = (const char* rhs)
     {
@@ -353,7 +373,7 @@ public:
     /// Return length.
     unsigned Length() const { return length_; }
     /// Return buffer capacity.
-    unsigned Capacity() const { return capacity_; }
+    unsigned Capacity() const { return buffer_ == localBuffer_ ? LOCAL_CAPACITY : capacity_; }
     /// Return whether the string is empty.
     bool Empty() const { return length_ == 0; }
     /// Return comparision result with a string.
@@ -440,6 +460,8 @@ public:
     static const unsigned NPOS = 0xffffffff;
     /// Initial dynamic allocation size.
     static const unsigned MIN_CAPACITY = 8;
+    /// Size of the inline buffer used for short strings instead of a dynamic allocation. Sized so that the string still fits in the value of a Variant.
+    static const unsigned LOCAL_CAPACITY = 4 * sizeof(void*) - sizeof(unsigned) - sizeof(char*);
     /// Empty string.
     static const String EMPTY;
     
@@ -473,9 +495,14 @@ private:
     
     /// String length.
     unsigned length_;
-    /// Capacity, zero if buffer not allocated.
-    unsigned capacity_;
-    /// String buffer, null if not allocated.
+    union
+    {
+        /// Capacity of the dynamically allocated buffer, zero if buffer not allocated.
+        unsigned capacity_;
+        /// Inline buffer for short strings. Overlaps the capacity, which is implied while the inline buffer is in use.
+        char localBuffer_[LOCAL_CAPACITY];
+    };
+    /// String buffer, points to the end zero if not allocated or to the inline buffer.
     char* buffer_;
     
     /// End zero for empty strings.
@@ -518,11 +545,16 @@ public:
     /// Return character data.
     const wchar_t* CString() const { return buffer_; }
     
+    /// Size of the inline buffer used for short strings instead of a dynamic allocation. Sized to 64 bytes: 32 characters on Windows and 16 characters on platforms with 32-bit wchar_t.
+    static const unsigned LOCAL_CAPACITY = 64 / sizeof(wchar_t);
+    
 private:
     /// String length.
     unsigned length_;
     /// String buffer, null if not allocated.
     wchar_t* buffer_;
+    /// Inline buffer for short strings.
+    wchar_t localBuffer_[LOCAL_CAPACITY];
 };
 
 }
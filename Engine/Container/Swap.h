@@ -22,6 +22,8 @@
 
 #pragma once
 
+#include "Move.h"
+
 namespace Urho3D
 {
 
@@ -34,9 +36,9 @@ class VectorBase;
 /// Swap two values.
 template<class T> inline void Swap(T& first, T& second)
 {
-    T temp = first;
-    first = second;
-    second = temp;
+    T temp = Move(first);
+    first = Move(second);
+    second = Move(temp);
 }
 
 template<> void Swap<String>(String& first, String& second);
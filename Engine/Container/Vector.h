@@ -61,6 +61,14 @@ public:
         *this = vector;
     }
     
+    #ifdef URHO3D_CXX11
+    /// Move-construct from another vector.
+    Vector(Vector<T>&& vector)
+    {
+        Swap(vector);
+    }
+    #endif
+    
     /// Destruct.
     ~Vector()
     {
@@ -76,6 +84,15 @@ public:
         return *this;
     }
     
+    #ifdef URHO3D_CXX11
+    /// Move-assign from another vector.
+    Vector<T>& operator = (Vector<T>&& rhs)
+    {
+        Swap(rhs);
+        return *this;
+    }
+    #endif
+    
     /// Add-assign an element.
     Vector<T>& operator += (const T& rhs)
     {
@@ -154,6 +171,57 @@ public:
     /// Add another vector at the end.
     void Push(const Vector<T>& vector) { Resize(size_ + vector.size_, vector.Buffer()); }
     
+    #ifdef URHO3D_CXX11
+    /// Add an element at the end by moving it.
+    void Push(T&& value) { EmplaceBack(Move(value)); }
+    
+    /// Construct an element in place at the end. Return reference to it.
+    template <class... Args> T& EmplaceBack(Args&&... args)
+    {
+        if (size_ < capacity_)
+            new(Buffer() + size_) T(Forward<Args>(args)...);
+        else
+        {
+            unsigned newCapacity = capacity_ ? capacity_ + ((capacity_ + 1) >> 1) : 1;
+            T* newBuffer = reinterpret_cast<T*>(AllocateBuffer(newCapacity * sizeof(T)));
+            // Construct the new element first, as the arguments may refer to elements in the old buffer
+            new(newBuffer + size_) T(Forward<Args>(args)...);
+            if (buffer_)
+            {
+                MoveElements(newBuffer, Buffer(), size_);
+                DestructElements(Buffer(), size_);
+                delete[] buffer_;
+            }
+            buffer_ = reinterpret_cast<unsigned char*>(newBuffer);
+            capacity_ = newCapacity;
+        }
+        
+        return Buffer()[size_++];
+    }
+    
+    /// Insert an element at position by moving it.
+    void Insert(unsigned pos, T&& value)
+    {
+        if (pos > size_)
+            pos = size_;
+        
+        unsigned oldSize = size_;
+        Resize(size_ + 1, 0);
+        MoveRange(pos + 1, pos, oldSize - pos);
+        Buffer()[pos] = Move(value);
+    }
+    
+    /// Construct an element in place at position. Return reference to it.
+    template <class... Args> T& Emplace(unsigned pos, Args&&... args)
+    {
+        if (pos > size_)
+            pos = size_;
+        
+        Insert(pos, T(Forward<Args>(args)...));
+        return Buffer()[pos];
+    }
+    #endif
+    
     /// Remove the last element.
     void Pop()
     {
@@ -308,7 +376,7 @@ public:
             {
                 newBuffer = reinterpret_cast<T*>(AllocateBuffer(capacity_ * sizeof(T)));
                 // Move the data into the new buffer
-                ConstructElements(newBuffer, Buffer(), size_);
+                MoveElements(newBuffer, Buffer(), size_);
             }
             
             // Delete the old buffer
@@ -388,18 +456,22 @@ private:
                         capacity_ += (capacity_ + 1) >> 1;
                 }
                 
-                unsigned char* newBuffer = AllocateBuffer(capacity_ * sizeof(T));
+                T* newBuffer = reinterpret_cast<T*>(AllocateBuffer(capacity_ * sizeof(T)));
+                // Initialize the new elements first, as the source data may be in the old buffer
+                ConstructElements(newBuffer + size_, src, newSize - size_);
                 if (buffer_)
                 {
-                    ConstructElements(reinterpret_cast<T*>(newBuffer), Buffer(), size_);
+                    MoveElements(newBuffer, Buffer(), size_);
                     DestructElements(Buffer(), size_);
                     delete[] buffer_;
                 }
-                buffer_ = newBuffer;
+                buffer_ = reinterpret_cast<unsigned char*>(newBuffer);
+            }
+            else
+            {
+                // Initialize the new elements
+                ConstructElements(Buffer() + size_, src, newSize - size_);
             }
-            
-            // Initialize the new elements
-            ConstructElements(Buffer() + size_, src, newSize - size_);
         }
         
         size_ = newSize;
@@ -412,12 +484,12 @@ private:
         if (src < dest)
         {
             for (unsigned i = count - 1; i < count; --i)
-                buffer[dest + i] = buffer[src + i];
+                buffer[dest + i] = Move(buffer[src + i]);
         }
         if (src > dest)
         {
             for (unsigned i = 0; i < count; ++i)
-                buffer[dest + i] = buffer[src + i];
+                buffer[dest + i] = Move(buffer[src + i]);
         }
     }
     
@@ -436,6 +508,13 @@ private:
         }
     }
     
+    /// Move-construct elements from another buffer. Copy-constructs without C++11.
+    static void MoveElements(T* dest, T* src, unsigned count)
+    {
+        for (unsigned i = 0; i < count; ++i)
+            new(dest + i) T(Move(src[i]));
+    }
+    
     /// Copy elements from one buffer to another.
     static void CopyElements(T* dest, const T* src, unsigned count)
     {
@@ -482,6 +561,14 @@ public:
         *this = vector;
     }
     
+    #ifdef URHO3D_CXX11
+    /// Move-construct from another vector.
+    PODVector(PODVector<T>&& vector)
+    {
+        Swap(vector);
+    }
+    #endif
+    
     /// Destruct.
     ~PODVector()
     {
@@ -496,6 +583,15 @@ public:
         return *this;
     }
     
+    #ifdef URHO3D_CXX11
+    /// Move-assign from another vector.
+    PODVector<T>& operator = (PODVector<T>&& rhs)
+    {
+        Swap(rhs);
+        return *this;
+    }
+    #endif
+    
     /// Add-assign an element.
     PODVector<T>& operator += (const T& rhs)
     {
@@ -21,7 +21,10 @@
 //
 
 #include "Precompiled.h"
+#include "Atomic.h"
 #include "Context.h"
+#include "Profiler.h"
+#include "Thread.h"
 
 #include "DebugNew.h"
 
@@ -51,8 +54,11 @@ void RemoveNamedAttribute(HashMap<ShortStringHash, Vector<AttributeInfo> >& attr
 }
 
 Context::Context() :
-    eventHandler_(0)
+    eventHandler_(0),
+    postedEvents_(0)
 {
+    Thread::SetMainThread();
+    
     #ifdef ANDROID
     // Always reset the random seed on Android, as the Urho3D library might not be unloaded between runs
     SetRandomSeed(1);
@@ -63,6 +69,11 @@ Context::~Context()
 {
     subsystems_.Clear();
     factories_.Clear();
+    
+    // Free posted events that were never sent
+    TakePostedEvents();
+    for (PODVector<PostedEvent*>::Iterator i = pendingPostedEvents_.Begin(); i != pendingPostedEvents_.End(); ++i)
+        delete *i;
 }
 
 SharedPtr<Object> Context::CreateObject(ShortStringHash objectType)
@@ -82,6 +93,13 @@ void Context::RegisterFactory(ObjectFactory* factory)
     factories_[factory->GetType()] = factory;
 }
 
+void Context::SetObjectPooling(ShortStringHash objectType, bool enable, unsigned initialCapacity)
+{
+    HashMap<ShortStringHash, SharedPtr<ObjectFactory> >::Iterator i = factories_.Find(objectType);
+    if (i != factories_.End())
+        i->second_->SetPooling(enable, initialCapacity);
+}
+
 void Context::RegisterSubsystem(Object* object)
 {
     if (!object)
@@ -130,6 +148,39 @@ void Context::CopyBaseAttributes(ShortStringHash baseType, ShortStringHash deriv
     }
 }
 
+void Context::SendPostedEvents()
+{
+    TakePostedEvents();
+    if (pendingPostedEvents_.Empty())
+        return;
+    
+    PROFILE(SendPostedEvents);
+    
+    // Events posted by the event handlers will be sent on the next call
+    unsigned numEvents = pendingPostedEvents_.Size();
+    for (unsigned i = 0; i < numEvents; ++i)
+    {
+        if (!pendingPostedEvents_[i])
+            continue;
+        
+        StringHash eventType = pendingPostedEvents_[i]->eventType_;
+        for (unsigned j = i; j < numEvents; ++j)
+        {
+            PostedEvent* event = pendingPostedEvents_[j];
+            if (!event || event->eventType_ != eventType)
+                continue;
+            
+            // Clear the slot first, so that the event is no longer visible to RemovePostedEvents()
+            pendingPostedEvents_[j] = 0;
+            if (event->sender_)
+                event->sender_->SendEvent(eventType, event->eventData_);
+            delete event;
+        }
+    }
+    
+    pendingPostedEvents_.Erase(0, numEvents);
+}
+
 Object* Context::GetSubsystem(ShortStringHash type) const
 {
     HashMap<ShortStringHash, SharedPtr<Object> >::ConstIterator i = subsystems_.Find(type);
@@ -139,6 +190,12 @@ Object* Context::GetSubsystem(ShortStringHash type) const
         return 0;
 }
 
+ObjectPoolStats Context::GetObjectPoolStats(ShortStringHash objectType) const
+{
+    HashMap<ShortStringHash, SharedPtr<ObjectFactory> >::ConstIterator i = factories_.Find(objectType);
+    return i != factories_.End() ? i->second_->GetPoolStats() : ObjectPoolStats();
+}
+
 Object* Context::GetEventSender() const
 {
     if (!eventSenders_.Empty())
@@ -198,4 +255,50 @@ void Context::EndSendEvent()
     eventSenders_.Pop();
 }
 
+void Context::PostEvent(Object* sender, StringHash eventType, const VariantMap& eventData)
+{
+    PostedEvent* event = new PostedEvent(sender, eventType, eventData);
+    
+    // Push to the stack. As the main thread only ever takes the whole stack, there is no ABA problem
+    for (;;)
+    {
+        void* head = postedEvents_;
+        event->next_ = static_cast<PostedEvent*>(head);
+        if (AtomicCompareExchangePointer(postedEvents_, event, head))
+            break;
+    }
+}
+
+void Context::RemovePostedEvents(Object* sender)
+{
+    TakePostedEvents();
+    
+    for (PODVector<PostedEvent*>::Iterator i = pendingPostedEvents_.Begin(); i != pendingPostedEvents_.End(); ++i)
+    {
+        if (*i && (*i)->sender_ == sender)
+            (*i)->sender_ = 0;
+    }
+}
+
+void Context::TakePostedEvents()
+{
+    if (!postedEvents_)
+        return;
+    
+    void* head;
+    for (;;)
+    {
+        head = postedEvents_;
+        if (AtomicCompareExchangePointer(postedEvents_, 0, head))
+            break;
+    }
+    
+    // The stack is in reverse posting order
+    unsigned oldSize = pendingPostedEvents_.Size();
+    for (PostedEvent* event = static_cast<PostedEvent*>(head); event; event = event->next_)
+        pendingPostedEvents_.Push(event);
+    for (unsigned i = oldSize, j = pendingPostedEvents_.Size() - 1; i < j; ++i, --j)
+        Swap(pendingPostedEvents_[i], pendingPostedEvents_[j]);
+}
+
 }
@@ -29,6 +29,28 @@
 namespace Urho3D
 {
 
+/// %Event posted from any thread, queued to be sent in the main thread.
+struct PostedEvent
+{
+    /// Construct.
+    PostedEvent(Object* sender, StringHash eventType, const VariantMap& eventData) :
+        next_(0),
+        sender_(sender),
+        eventType_(eventType),
+        eventData_(eventData)
+    {
+    }
+    
+    /// Next event in the lock-free stack.
+    PostedEvent* next_;
+    /// Sender. Null if destroyed before the event was sent.
+    Object* sender_;
+    /// Event type.
+    StringHash eventType_;
+    /// Event parameters.
+    VariantMap eventData_;
+};
+
 /// Urho3D execution context. Provides access to subsystems, object factories and attributes, and event receivers.
 class Context : public RefCounted
 {
@@ -44,6 +66,8 @@ public:
     SharedPtr<Object> CreateObject(ShortStringHash objectType);
     /// Register a factory for an object type.
     void RegisterFactory(ObjectFactory* factory);
+    /// Set whether to allocate objects of a type from a memory pool that recycles the memory of destroyed objects. The type must have a registered factory.
+    void SetObjectPooling(ShortStringHash objectType, bool enable, unsigned initialCapacity = 64);
     /// Register a subsystem.
     void RegisterSubsystem(Object* subsystem);
     /// Remove a subsystem.
@@ -54,6 +78,8 @@ public:
     void RemoveAttribute(ShortStringHash objectType, const char* name);
     /// Copy base class attributes to derived class.
     void CopyBaseAttributes(ShortStringHash baseType, ShortStringHash derivedType);
+    /// Send events posted so far. Events of the same type are sent together, otherwise in posting order. Called by the Time subsystem after the begin frame event, but can also be called at any other point in the main thread.
+    void SendPostedEvents();
     /// Template version of registering an object factory.
     template <class T> void RegisterFactory();
     /// Template version of removing a subsystem.
@@ -71,6 +97,8 @@ public:
     const HashMap<ShortStringHash, SharedPtr<Object> >& GetSubsystems() const { return subsystems_; }
     /// Return all object factories.
     const HashMap<ShortStringHash, SharedPtr<ObjectFactory> >& GetObjectFactories() const { return factories_; }
+    /// Return object pool statistics for an object type. All zero if the type has no pool.
+    ObjectPoolStats GetObjectPoolStats(ShortStringHash objectType) const;
     /// Return active event sender. Null outside event handling.
     Object* GetEventSender() const;
     /// Return active event handler. Set by Object. Null outside event handling.
@@ -131,6 +159,12 @@ private:
     void BeginSendEvent(Object* sender) { eventSenders_.Push(sender); }
     /// End event send. Clean up event receivers removed in the meanwhile.
     void EndSendEvent();
+    /// Queue a posted event. Called by Object from any thread.
+    void PostEvent(Object* sender, StringHash eventType, const VariantMap& eventData);
+    /// Forget the posted events of a sender. Called by Object on its destruction.
+    void RemovePostedEvents(Object* sender);
+    /// Move posted events from the lock-free stack to the pending events in posting order.
+    void TakePostedEvents();
 
     /// Object factories.
     HashMap<ShortStringHash, SharedPtr<ObjectFactory> > factories_;
@@ -148,6 +182,10 @@ private:
     PODVector<Object*> eventSenders_;
     /// Active event handler. Not stored in a stack for performance reasons; is needed only in esoteric cases.
     EventHandler* eventHandler_;
+    /// Posted events as a lock-free stack, most recent first.
+    void* volatile postedEvents_;
+    /// Posted events taken from the stack but not yet sent, in posting order. Accessed only in the main thread.
+    PODVector<PostedEvent*> pendingPostedEvents_;
 };
 
 template <class T> void Context::RegisterFactory() { RegisterFactory(new ObjectFactoryImpl<T>(this)); }
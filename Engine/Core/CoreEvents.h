@@ -63,4 +63,12 @@ EVENT(E_ENDFRAME, EndFrame)
 {
 }
 
+/// Frame time exceeded the profiler hitch threshold. Sent by the Profiler at the end of the frame.
+EVENT(E_PROFILERHITCH, ProfilerHitch)
+{
+    PARAM(P_FRAMENUMBER, FrameNumber);      // unsigned
+    PARAM(P_FRAMETIME, FrameTime);          // float
+    PARAM(P_DATA, Data);                    // String
+}
+
 }
@@ -22,6 +22,7 @@
 
 #include "Precompiled.h"
 #include "Context.h"
+#include "FlatHashSet.h"
 
 #include "DebugNew.h"
 
@@ -29,7 +30,9 @@ namespace Urho3D
 {
 
 Object::Object(Context* context) :
-    context_(context)
+    context_(context),
+    factory_(0),
+    hasPostedEvents_(false)
 {
     assert(context_);
 }
@@ -38,6 +41,139 @@ Object::~Object()
 {
     UnsubscribeFromAllEvents();
     context_->RemoveEventSender(this);
+    if (hasPostedEvents_)
+        context_->RemovePostedEvents(this);
+}
+
+void Object::Dispose()
+{
+    if (factory_)
+        factory_->ReleasePooled(this);
+    else
+        delete this;
+}
+
+void Object::PrepareForReuse()
+{
+    UnsubscribeFromAllEvents();
+    context_->RemoveEventSender(this);
+    if (hasPostedEvents_)
+        context_->RemovePostedEvents(this);
+    RenewRefCount();
+}
+
+ObjectFactory::~ObjectFactory()
+{
+    DestroyIdleObjects();
+    SharedAllocatorUninitialize(pool_);
+}
+
+void ObjectFactory::SetPooling(bool enable, unsigned initialCapacity)
+{
+    if (enable && !pool_)
+        pool_ = SharedAllocatorInitialize(objectSize_, initialCapacity);
+    if (!enable)
+        DestroyIdleObjects();
+    
+    pooling_ = enable;
+}
+
+ObjectPoolStats ObjectFactory::GetPoolStats() const
+{
+    ObjectPoolStats stats;
+    if (pool_)
+    {
+        poolLock_.Acquire();
+        stats.capacity_ = pool_->capacity_;
+        stats.used_ = pool_->liveNodes_ - idleObjects_.Size();
+        stats.peak_ = pool_->peakNodes_;
+        stats.created_ = created_;
+        stats.reused_ = reused_;
+        stats.idle_ = idleObjects_.Size();
+        poolLock_.Release();
+    }
+    
+    return stats;
+}
+
+void ObjectFactory::Dispose()
+{
+    // Called when the context releases the factory. Objects still in use keep their memory in the pool, so in that case
+    // the last of them deletes the factory
+    DestroyIdleObjects();
+    
+    poolLock_.Acquire();
+    orphaned_ = true;
+    bool inUse = pool_ && pool_->liveNodes_;
+    poolLock_.Release();
+    
+    if (!inUse)
+        delete this;
+}
+
+Object* ObjectFactory::TakeIdleObject()
+{
+    Object* object = 0;
+    
+    poolLock_.Acquire();
+    if (idleObjects_.Size())
+    {
+        object = idleObjects_.Back();
+        idleObjects_.Pop();
+        ++reused_;
+    }
+    poolLock_.Release();
+    
+    return object;
+}
+
+void* ObjectFactory::ReservePooled()
+{
+    AtomicIncrement(created_);
+    return SharedAllocatorReserve(pool_);
+}
+
+void ObjectFactory::ReleasePooled(Object* object)
+{
+    // Reset or destroy without holding the lock, as that may release other objects of the same type
+    bool reuse = pooling_ && !orphaned_ && object->ResetForReuse();
+    if (reuse)
+    {
+        object->PrepareForReuse();
+        
+        poolLock_.Acquire();
+        if (!orphaned_)
+        {
+            idleObjects_.Push(object);
+            poolLock_.Release();
+            return;
+        }
+        poolLock_.Release();
+    }
+    
+    object->~Object();
+    
+    poolLock_.Acquire();
+    SharedAllocatorFree(pool_, object);
+    bool deleteSelf = orphaned_ && !pool_->liveNodes_;
+    poolLock_.Release();
+    
+    if (deleteSelf)
+        delete this;
+}
+
+void ObjectFactory::DestroyIdleObjects()
+{
+    poolLock_.Acquire();
+    PODVector<Object*> objects;
+    objects.Swap(idleObjects_);
+    poolLock_.Release();
+    
+    for (PODVector<Object*>::Iterator i = objects.Begin(); i != objects.End(); ++i)
+    {
+        (*i)->~Object();
+        SharedAllocatorFree(pool_, *i);
+    }
 }
 
 void Object::OnEvent(Object* sender, StringHash eventType, VariantMap& eventData)
@@ -221,7 +357,7 @@ void Object::SendEvent(StringHash eventType, VariantMap& eventData)
     // Make a weak pointer to self to check for destruction during event handling
     WeakPtr<Object> self(this);
     Context* context = context_;
-    HashSet<Object*> processed;
+    FlatHashSet<Object*> processed;
     
     context->BeginSendEvent(this);
     
@@ -315,6 +451,20 @@ void Object::SendEvent(StringHash eventType, VariantMap& eventData)
     context->EndSendEvent();
 }
 
+void Object::PostEvent(StringHash eventType)
+{
+    VariantMap noEventData;
+    
+    PostEvent(eventType, noEventData);
+}
+
+void Object::PostEvent(StringHash eventType, const VariantMap& eventData)
+{
+    // Set the flag before queuing, so that the event can not be left behind when the object is destroyed
+    hasPostedEvents_ = true;
+    context_->PostEvent(this, eventType, eventData);
+}
+
 Object* Object::GetSubsystem(ShortStringHash type) const
 {
     return context_->GetSubsystem(type);
@@ -22,6 +22,8 @@
 
 #pragma once
 
+#include "Allocator.h"
+#include "Atomic.h"
 #include "LinkedList.h"
 #include "Ptr.h"
 #include "Variant.h"
@@ -31,11 +33,13 @@ namespace Urho3D
 
 class Context;
 class EventHandler;
+class ObjectFactory;
 
 /// Base class for objects with type identification, subsystem access and event sending/receiving capability.
 class Object : public RefCounted
 {
     friend class Context;
+    friend class ObjectFactory;
     
 public:
     /// Construct.
@@ -68,6 +72,10 @@ public:
     void SendEvent(StringHash eventType);
     /// Send event with parameters to all subscribers.
     void SendEvent(StringHash eventType, VariantMap& eventData);
+    /// Post event to be sent later in the main thread. Can be called from any thread. The object must be destroyed in the main thread.
+    void PostEvent(StringHash eventType);
+    /// Post event with parameters to be sent later in the main thread. Can be called from any thread. The object must be destroyed in the main thread.
+    void PostEvent(StringHash eventType, const VariantMap& eventData);
     
     /// Return execution context.
     Context* GetContext() const { return context_; }
@@ -85,6 +93,11 @@ public:
     template <class T> T* GetSubsystem() const;
     
 protected:
+    /// Dispose of self when no more references. Pooled objects are handed back to their factory for reuse or destruction.
+    virtual void Dispose();
+    /// Reset to the state of a newly constructed object so that a pooling factory can reuse it. Event subscriptions are removed and weak pointers expired afterward. Return false if not supported, in which case the object is destroyed instead.
+    virtual bool ResetForReuse() { return false; }
+    
     /// Execution context.
     Context* context_;
     
@@ -97,41 +110,128 @@ private:
     EventHandler* FindSpecificEventHandler(Object* sender, StringHash eventType, EventHandler** previous = 0) const;
     /// Remove event handlers related to a specific sender.
     void RemoveEventSender(Object* sender);
+    /// Remove event subscriptions and posted events and expire weak pointers after being reset for reuse.
+    void PrepareForReuse();
     
     /// Event handlers. Sender is null for non-specific handlers.
     LinkedList<EventHandler> eventHandlers_;
+    /// Factory whose pool the object was allocated from. Null if not pooled.
+    ObjectFactory* factory_;
+    /// Has posted events flag. Never reset, as events may be posted concurrently with sending them.
+    volatile bool hasPostedEvents_;
 };
 
 template <class T> T* Object::GetSubsystem() const { return static_cast<T*>(GetSubsystem(T::GetTypeStatic())); }
 
+/// %Object pool statistics.
+struct ObjectPoolStats
+{
+    /// Construct with zero values.
+    ObjectPoolStats() :
+        capacity_(0),
+        used_(0),
+        peak_(0),
+        created_(0),
+        reused_(0),
+        idle_(0)
+    {
+    }
+    
+    /// Number of objects that fit in the pool's memory blocks.
+    unsigned capacity_;
+    /// Number of objects currently in use.
+    unsigned used_;
+    /// Highest number of objects allocated from the pool at the same time, including the objects kept for reuse.
+    unsigned peak_;
+    /// Total number of objects constructed in pooled memory.
+    unsigned created_;
+    /// Total number of times a reset object was reused instead of constructing a new one.
+    unsigned reused_;
+    /// Number of reset objects currently kept for reuse.
+    unsigned idle_;
+};
+
 /// Base class for object factories.
 class ObjectFactory : public RefCounted
 {
 public:
     /// Construct.
     ObjectFactory(Context* context) :
-        context_(context)
+        context_(context),
+        objectSize_(0),
+        pool_(0),
+        created_(0),
+        reused_(0),
+        pooling_(false),
+        orphaned_(false)
     {
         assert(context_);
     }
     
+    /// Destruct. Free the object pool.
+    virtual ~ObjectFactory();
+    
     /// Create an object. Implemented in templated subclasses.
     virtual SharedPtr<Object> CreateObject() = 0;
     
+    /// Set whether to allocate the objects from a per-type memory pool. Released objects are reset and reused if the type supports it, otherwise destroyed and their memory recycled. The initial capacity is used when the pool is first created.
+    void SetPooling(bool enable, unsigned initialCapacity = 64);
+    
     /// Return execution context.
     Context* GetContext() const { return context_; }
     /// Return type hash of objects created by this factory.
     ShortStringHash GetType() const { return type_; }
     /// Return type name of objects created by this factory.
     const String& GetTypeName() const { return typeName_; }
+    /// Return whether objects are allocated from a memory pool.
+    bool IsPooling() const { return pooling_; }
+    /// Return object pool statistics.
+    ObjectPoolStats GetPoolStats() const;
     
 protected:
+    /// Dispose of self when no more references. If pooled objects are still in use, the last of them deletes the factory.
+    virtual void Dispose();
+    /// Take an object kept for reuse, or return null if none.
+    Object* TakeIdleObject();
+    /// Reserve memory for a new object from the pool.
+    void* ReservePooled();
+    /// Mark an object constructed in pooled memory as belonging to this factory.
+    Object* AddPooled(Object* object)
+    {
+        object->factory_ = this;
+        return object;
+    }
+    
     /// Execution context.
     Context* context_;
     /// Object type.
     ShortStringHash type_;
     /// Object type name.
     String typeName_;
+    /// Object size in bytes.
+    unsigned objectSize_;
+    /// Object memory pool. Kept after disabling pooling, as objects allocated from it may still exist.
+    SharedAllocator* pool_;
+    /// Objects reset and kept for reuse.
+    PODVector<Object*> idleObjects_;
+    /// Lock for the objects kept for reuse and for the pool's object count.
+    mutable SpinLock poolLock_;
+    /// Number of objects created in pooled memory.
+    volatile int created_;
+    /// Number of reset objects reused.
+    unsigned reused_;
+    /// Pooling enabled flag.
+    bool pooling_;
+    /// Released by the context while pooled objects are still in use flag.
+    bool orphaned_;
+    
+private:
+    /// Reset a released pooled object for reuse, or destroy it and free its memory.
+    void ReleasePooled(Object* object);
+    /// Destroy the objects kept for reuse.
+    void DestroyIdleObjects();
+    
+    friend class Object;
 };
 
 /// Template implementation of the object factory.
@@ -144,10 +244,21 @@ public:
     {
         type_ = T::GetTypeStatic();
         typeName_ = T::GetTypeNameStatic();
+        objectSize_ = sizeof(T);
     }
     
     /// Create an object of the specific type.
-    virtual SharedPtr<Object>(CreateObject()) { return SharedPtr<Object>(new T(context_)); }
+    virtual SharedPtr<Object>(CreateObject())
+    {
+        if (!pooling_)
+            return SharedPtr<Object>(new T(context_));
+        
+        // Reuse an object that was reset when released, or construct a new one in pooled memory
+        Object* object = TakeIdleObject();
+        if (!object)
+            object = AddPooled(::new(ReservePooled()) T(context_));
+        return SharedPtr<Object>(object);
+    }
 };
 
 /// Internal helper class for invoking event handler functions.
@@ -250,11 +361,11 @@ private:
         static const String& GetTypeNameStatic() { return typeNameStatic; } \
 
 #define OBJECTTYPESTATIC(typeName) \
-    const ShortStringHash typeName::typeStatic(#typeName); \
+    const ShortStringHash typeName::typeStatic(SHORTHASH(typeName)); \
     const String typeName::typeNameStatic(#typeName); \
 
-#define EVENT(eventID, eventName) static const StringHash eventID(#eventName); namespace eventName
-#define PARAM(paramID, paramName) static const ShortStringHash paramID(#paramName)
+#define EVENT(eventID, eventName) static const StringHash eventID(HASH(eventName)); namespace eventName
+#define PARAM(paramID, paramName) static const ShortStringHash paramID(SHORTHASH(paramName))
 #define HANDLER(className, function) (new EventHandlerImpl<className>(this, &className::function))
 #define HANDLER_USERDATA(className, function, userData) (new EventHandlerImpl<className>(this, &className::function, userData))
 
@@ -0,0 +1,122 @@
+//
+// Copyright (c) 2008-2013 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "Precompiled.h"
+#include "ParallelFor.h"
+
+#include "DebugNew.h"
+
+namespace Urho3D
+{
+
+/// Desired execution time of one work item, to amortize the queueing overhead.
+static const float TARGET_CHUNK_USEC = 50.0f;
+/// Minimum work items per thread for load balancing.
+static const unsigned CHUNKS_PER_THREAD = 4;
+/// Weight of the latest run in the cost measurement.
+static const float COST_SMOOTHING = 0.25f;
+
+ParallelLoop::ParallelLoop(unsigned minChunkSize) :
+    elementCost_(0.0f),
+    minChunkSize_(minChunkSize ? minChunkSize : 1),
+    pendingElements_(0)
+{
+}
+
+unsigned ParallelLoop::GetChunkSize(unsigned numElements, unsigned numThreads) const
+{
+    // Split into at least a few work items per thread, including the main thread, so that uneven costs get balanced
+    unsigned numChunks = (numThreads + 1) * CHUNKS_PER_THREAD;
+    unsigned chunkSize = (numElements + numChunks - 1) / numChunks;
+    
+    // If the element cost is known, make the work items no smaller than necessary to amortize the queueing overhead
+    if (elementCost_ > 0.0f)
+    {
+        float costChunkSize = TARGET_CHUNK_USEC / elementCost_;
+        if (costChunkSize >= (float)numElements)
+            chunkSize = numElements;
+        else if (costChunkSize > (float)chunkSize)
+            chunkSize = (unsigned)costChunkSize;
+    }
+    
+    return chunkSize > minChunkSize_ ? chunkSize : minChunkSize_;
+}
+
+void ParallelLoop::Dispatch(WorkQueue* queue, void* start, unsigned numElements, unsigned elementSize,
+    void (*workFunction)(const WorkItem*, unsigned))
+{
+    // If the previous run was not waited for, its work has been completed by now
+    UpdateElementCost();
+    
+    if (!numElements)
+        return;
+    
+    unsigned numThreads = queue->GetNumThreads();
+    threadUSec_.Resize(numThreads + 1);
+    for (unsigned i = 0; i < threadUSec_.Size(); ++i)
+        threadUSec_[i] = 0;
+    pendingElements_ = numElements;
+    
+    WorkItem item;
+    item.workFunction_ = workFunction;
+    item.aux_ = this;
+    
+    unsigned char* chunkStart = reinterpret_cast<unsigned char*>(start);
+    unsigned chunkSize = GetChunkSize(numElements, numThreads);
+    
+    // If not worth splitting, execute directly
+    if (!numThreads || chunkSize >= numElements)
+    {
+        item.start_ = chunkStart;
+        item.end_ = chunkStart + numElements * elementSize;
+        workFunction(&item, 0);
+        return;
+    }
+    
+    while (numElements)
+    {
+        unsigned count = chunkSize < numElements ? chunkSize : numElements;
+        item.start_ = chunkStart;
+        item.end_ = chunkStart + count * elementSize;
+        queue->AddWorkItem(item);
+        
+        chunkStart += count * elementSize;
+        numElements -= count;
+    }
+}
+
+void ParallelLoop::UpdateElementCost()
+{
+    if (!pendingElements_)
+        return;
+    
+    long long totalUSec = 0;
+    for (unsigned i = 0; i < threadUSec_.Size(); ++i)
+        totalUSec += threadUSec_[i];
+    
+    float cost = (float)totalUSec / (float)pendingElements_;
+    elementCost_ = elementCost_ > 0.0f ? Lerp(elementCost_, cost, COST_SMOOTHING) : cost;
+    pendingElements_ = 0;
+}
+
+}
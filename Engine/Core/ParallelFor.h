@@ -0,0 +1,270 @@
+//
+// Copyright (c) 2008-2013 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "Sort.h"
+#include "Timer.h"
+#include "WorkQueue.h"
+
+namespace Urho3D
+{
+
+/// Minimum elements per chunk in a parallel sort.
+static const unsigned PARALLELSORT_MIN_CHUNK = 4096;
+
+/// Base class for parallel loops over arrays. Measures the per-element cost over successive runs to choose the work item size according to the cost and the number of threads.
+class ParallelLoop
+{
+public:
+    /// Construct with minimum elements per work item.
+    ParallelLoop(unsigned minChunkSize);
+    
+    /// Return elements per work item to use for the given element and worker thread count.
+    unsigned GetChunkSize(unsigned numElements, unsigned numThreads) const;
+    /// Return measured average cost of one element in microseconds, or zero if not measured yet.
+    float GetElementCost() const { return elementCost_; }
+    
+protected:
+    /// Split the elements into work items and queue them, or execute directly in the main thread if not worth splitting.
+    void Dispatch(WorkQueue* queue, void* start, unsigned numElements, unsigned elementSize, void (*workFunction)(const WorkItem*, unsigned));
+    /// Update the per-element cost from the previous run.
+    void UpdateElementCost();
+    
+    /// Per-thread accumulated execution time in microseconds. Each thread writes only its own slot.
+    PODVector<long long> threadUSec_;
+    
+private:
+    /// Average cost of one element in microseconds.
+    float elementCost_;
+    /// Minimum elements per work item.
+    unsigned minChunkSize_;
+    /// Element count of the previous run whose cost has not been measured yet.
+    unsigned pendingElements_;
+};
+
+/// Parallel loop calling a function for sub-ranges of an array in the worker threads and the main thread. Keep one per call site so that the cost measurement persists.
+template <class T> class ParallelFor : public ParallelLoop
+{
+public:
+    /// Loop function. Called with the sub-range, thread index (0 = main thread) and user data.
+    typedef void (*Function)(T* start, T* end, unsigned threadIndex, void* userData);
+    
+    /// Construct with the loop function and minimum elements per work item.
+    ParallelFor(Function function, unsigned minChunkSize = 1) :
+        ParallelLoop(minChunkSize),
+        function_(function),
+        userData_(0)
+    {
+    }
+    
+    /// Process the range and wait for completion.
+    void Run(WorkQueue* queue, RandomAccessIterator<T> start, RandomAccessIterator<T> end, void* userData)
+    {
+        Start(queue, start, end, userData);
+        queue->Complete(M_MAX_UNSIGNED);
+        UpdateElementCost();
+    }
+    
+    /// Queue the range for processing without waiting. WorkQueue::Complete() must be called before the next run.
+    void Start(WorkQueue* queue, RandomAccessIterator<T> start, RandomAccessIterator<T> end, void* userData)
+    {
+        userData_ = userData;
+        Dispatch(queue, (void*)start.ptr_, end - start, sizeof(T), WorkFunction);
+    }
+    
+private:
+    /// Execute one work item.
+    static void WorkFunction(const WorkItem* item, unsigned threadIndex)
+    {
+        ParallelFor<T>* loop = static_cast<ParallelFor<T>*>(reinterpret_cast<ParallelLoop*>(item->aux_));
+        HiresTimer timer;
+        loop->function_(reinterpret_cast<T*>(item->start_), reinterpret_cast<T*>(item->end_), threadIndex, loop->userData_);
+        loop->threadUSec_[threadIndex] += timer.GetUSec(false);
+    }
+    
+    /// Loop function.
+    Function function_;
+    /// User data of the current run.
+    void* userData_;
+};
+
+/// Parallel loop that accumulates into per-thread results, which are merged by the caller after the run. The results are kept between runs to reuse their storage. Keep one per call site.
+template <class T, class R> class ParallelReduce : public ParallelLoop
+{
+public:
+    /// Loop function. Called with the sub-range, the calling thread's result and user data.
+    typedef void (*Function)(T* start, T* end, R& result, void* userData);
+    
+    /// Construct with the loop function and minimum elements per work item.
+    ParallelReduce(Function function, unsigned minChunkSize = 1) :
+        ParallelLoop(minChunkSize),
+        function_(function),
+        userData_(0)
+    {
+    }
+    
+    /// Reset the per-thread results to the initial value, process the range and wait for completion.
+    void Run(WorkQueue* queue, RandomAccessIterator<T> start, RandomAccessIterator<T> end, void* userData, const R& initial)
+    {
+        results_.Resize(queue->GetNumThreads() + 1);
+        for (unsigned i = 0; i < results_.Size(); ++i)
+            results_[i] = initial;
+        
+        userData_ = userData;
+        Dispatch(queue, (void*)start.ptr_, end - start, sizeof(T), WorkFunction);
+        queue->Complete(M_MAX_UNSIGNED);
+        UpdateElementCost();
+    }
+    
+    /// Return number of per-thread results.
+    unsigned GetNumResults() const { return results_.Size(); }
+    /// Return per-thread result by thread index.
+    R& GetResult(unsigned index) { return results_[index]; }
+    
+private:
+    /// Execute one work item.
+    static void WorkFunction(const WorkItem* item, unsigned threadIndex)
+    {
+        ParallelReduce<T, R>* loop = static_cast<ParallelReduce<T, R>*>(reinterpret_cast<ParallelLoop*>(item->aux_));
+        HiresTimer timer;
+        loop->function_(reinterpret_cast<T*>(item->start_), reinterpret_cast<T*>(item->end_), loop->results_[threadIndex],
+            loop->userData_);
+        loop->threadUSec_[threadIndex] += timer.GetUSec(false);
+    }
+    
+    /// Loop function.
+    Function function_;
+    /// User data of the current run.
+    void* userData_;
+    /// Per-thread results.
+    Vector<R> results_;
+};
+
+/// Sort or merge task of a parallel sort.
+template <class T, class U> struct ParallelSortTask
+{
+    /// Start of the range.
+    T* start_;
+    /// End of the first sorted half when merging.
+    T* middle_;
+    /// End of the range.
+    T* end_;
+    /// Merge destination, or null to sort the range in place.
+    T* dest_;
+    /// Compare function.
+    U compare_;
+};
+
+/// Execute a parallel sort task.
+template <class T, class U> void ParallelSortWork(const WorkItem* item, unsigned threadIndex)
+{
+    ParallelSortTask<T, U>* task = reinterpret_cast<ParallelSortTask<T, U>*>(item->aux_);
+    if (!task->dest_)
+        Sort(RandomAccessIterator<T>(task->start_), RandomAccessIterator<T>(task->end_), task->compare_);
+    else
+        Merge(task->start_, task->middle_, task->middle_, task->end_, task->dest_, task->compare_);
+}
+
+/// Sort in ascending order using a compare function in the worker threads and the main thread. The array is split into chunks that are sorted in parallel, then merged pairwise, each merge starting as soon as its two halves are sorted. Not stable. The buffer is resized to hold a copy of the array. Only for POD types, and must be called from the main thread.
+template <class T, class U> void ParallelSort(WorkQueue* queue, RandomAccessIterator<T> begin, RandomAccessIterator<T> end, PODVector<T>& buffer, U compare)
+{
+    unsigned count = end - begin;
+    if (!queue || !queue->GetNumThreads())
+    {
+        Sort(begin, end, compare);
+        return;
+    }
+    
+    // Use a power of two number of chunks, a couple per thread to balance uneven sorting costs, as long as they are large enough
+    unsigned numThreads = queue->GetNumThreads();
+    unsigned numChunks = 1;
+    while (numChunks < (numThreads + 1) * 2 && count / (numChunks * 2) >= PARALLELSORT_MIN_CHUNK)
+        numChunks <<= 1;
+    
+    if (numChunks == 1)
+    {
+        Sort(begin, end, compare);
+        return;
+    }
+    
+    buffer.Resize(count);
+    PODVector<ParallelSortTask<T, U> > tasks(numChunks * 2 - 1);
+    PODVector<WorkItem*> items(numChunks);
+    PODVector<WorkItem*> predecessors(2);
+    
+    T* src = begin.ptr_;
+    T* dest = &buffer[0];
+    unsigned taskIndex = 0;
+    
+    WorkItem item;
+    item.workFunction_ = ParallelSortWork<T, U>;
+    item.start_ = 0;
+    item.end_ = 0;
+    
+    for (unsigned i = 0; i < numChunks; ++i)
+    {
+        ParallelSortTask<T, U>& task = tasks[taskIndex++];
+        task.start_ = src + count * i / numChunks;
+        task.middle_ = 0;
+        task.end_ = src + count * (i + 1) / numChunks;
+        task.dest_ = 0;
+        task.compare_ = compare;
+        
+        item.aux_ = &task;
+        items[i] = queue->AddWorkItem(item);
+    }
+    
+    // Merge between the array and the buffer, doubling the sorted run length on each level
+    for (unsigned width = 1; width < numChunks; width <<= 1)
+    {
+        for (unsigned i = 0; i < numChunks; i += width * 2)
+        {
+            unsigned startIndex = count * i / numChunks;
+            unsigned middleIndex = count * (i + width) / numChunks;
+            unsigned endIndex = count * (i + width * 2) / numChunks;
+            
+            ParallelSortTask<T, U>& task = tasks[taskIndex++];
+            task.start_ = src + startIndex;
+            task.middle_ = src + middleIndex;
+            task.end_ = src + endIndex;
+            task.dest_ = dest + startIndex;
+            task.compare_ = compare;
+            
+            item.aux_ = &task;
+            predecessors[0] = items[i];
+            predecessors[1] = items[i + width];
+            items[i] = queue->AddWorkItem(item, predecessors);
+        }
+        
+        Swap(src, dest);
+    }
+    
+    // The last merge depends on all the other items, so waiting for it leaves unrelated work in the queue
+    queue->CompleteItem(items[0]);
+    
+    if (src != begin.ptr_)
+        memcpy(begin.ptr_, src, count * sizeof(T));
+}
+
+}
@@ -24,6 +24,7 @@
 #include "CoreEvents.h"
 #include "Profiler.h"
 
+#include <cmath>
 #include <cstdio>
 #include <cstring>
 #include <ctype.h>
@@ -42,17 +43,96 @@ Profiler::Profiler(Context* context) :
     Object(context),
     current_(0),
     root_(0),
+    traceFrameCount_(0),
+    traceFrames_(0),
+    numFrameTimes_(0),
+    maxFrameTime_(0),
+    hitchThreshold_(0.0f),
+    numHitches_(0),
     intervalFrames_(0),
     totalFrames_(0)
 {
     root_ = new ProfilerBlock(0, "Root");
     current_ = root_;
+    
+    frameTimeHistogram_.Resize(FRAME_HISTOGRAM_BUCKETS);
+    ResetFrameTimes();
 }
 
 Profiler::~Profiler()
 {
     delete root_;
     root_ = 0;
+    
+    for (PODVector<ProfilerThread*>::Iterator i = threads_.Begin(); i != threads_.End(); ++i)
+        delete *i;
+    threads_.Clear();
+}
+
+void Profiler::SetNumThreads(unsigned num)
+{
+    // The thread trees can only be created once, as the threads access them without locking
+    if (!threads_.Empty())
+        return;
+    
+    for (unsigned i = 0; i < num; ++i)
+    {
+        ProfilerThread* thread = new ProfilerThread(i + 1);
+        if (traceFrames_)
+            thread->trace_.Allocate();
+        threads_.Push(thread);
+    }
+}
+
+void Profiler::RegisterThread(unsigned index)
+{
+    if (!index || index > threads_.Size())
+        return;
+    
+    ProfilerThread* thread = threads_[index - 1];
+    thread->id_ = Thread::GetCurrentThreadID();
+    thread->registered_ = true;
+}
+
+void Profiler::SetTraceFrames(unsigned frames)
+{
+    // Allocate and clear the ring buffers before enabling recording, as the worker threads do not lock them. Events
+    // left from an earlier capture would have times from the previous trace timer
+    if (frames && !traceFrames_)
+    {
+        trace_.Allocate();
+        trace_.Clear();
+        for (PODVector<ProfilerThread*>::Iterator i = threads_.Begin(); i != threads_.End(); ++i)
+        {
+            (*i)->trace_.Allocate();
+            (*i)->trace_.Clear();
+        }
+        
+        traceTimer_.Reset();
+        traceFrameStarts_.Resize(frames);
+        traceFrameCount_ = 0;
+    }
+    else if (frames)
+    {
+        traceFrameStarts_.Resize(frames);
+        traceFrameCount_ = 0;
+    }
+    
+    traceFrames_ = frames;
+}
+
+void Profiler::SetHitchThreshold(float threshold)
+{
+    hitchThreshold_ = Max(threshold, 0.0f);
+}
+
+void Profiler::ResetFrameTimes()
+{
+    for (unsigned i = 0; i < frameTimeHistogram_.Size(); ++i)
+        frameTimeHistogram_[i] = 0;
+    numFrameTimes_ = 0;
+    maxFrameTime_ = 0;
+    numHitches_ = 0;
 }
 
 void Profiler::BeginFrame()
@@ -60,13 +140,24 @@ void Profiler::BeginFrame()
     // End the previous frame if any
     EndFrame();
     
+    if (traceFrames_)
+        traceFrameStarts_[traceFrameCount_++ % traceFrames_] = traceTimer_.GetUSec(false);
+    
     BeginBlock("RunFrame");
+    frameTimer_.Reset();
 }
 
 void Profiler::EndFrame()
 {
     if (current_ != root_)
     {
+        long long frameTime = frameTimer_.GetUSec(false);
+        unsigned bucket = Min((int)(frameTime / FRAME_HISTOGRAM_BUCKET_USEC), (int)FRAME_HISTOGRAM_BUCKETS - 1);
+        ++frameTimeHistogram_[bucket];
+        ++numFrameTimes_;
+        if (frameTime > maxFrameTime_)
+            maxFrameTime_ = frameTime;
+        
         EndBlock();
         ++intervalFrames_;
         ++totalFrames_;
@@ -74,6 +165,28 @@ void Profiler::EndFrame()
             ++totalFrames_;
         root_->EndFrame();
         current_ = root_;
+        
+        // Blocks that are running in worker threads at this point will be accounted to the next frame
+        for (PODVector<ProfilerThread*>::Iterator i = threads_.Begin(); i != threads_.End(); ++i)
+        {
+            MutexLock lock((*i)->mutex_);
+            (*i)->root_->EndFrame();
+        }
+        
+        // Capture the last frame's profiling data if it was a hitch
+        if (hitchThreshold_ > 0.0f && frameTime > (long long)(hitchThreshold_ * 1000.0f))
+        {
+            ++numHitches_;
+            hitchData_ = GetData(false, true);
+            
+            using namespace ProfilerHitch;
+            
+            VariantMap eventData;
+            eventData[P_FRAMENUMBER] = totalFrames_;
+            eventData[P_FRAMETIME] = frameTime / 1000.0f;
+            eventData[P_DATA] = hitchData_;
+            SendEvent(E_PROFILERHITCH, eventData);
+        }
     }
 }
 
@@ -81,6 +194,60 @@ void Profiler::BeginInterval()
 {
     root_->BeginInterval();
     intervalFrames_ = 0;
+    
+    for (PODVector<ProfilerThread*>::Iterator i = threads_.Begin(); i != threads_.End(); ++i)
+    {
+        MutexLock lock((*i)->mutex_);
+        (*i)->root_->BeginInterval();
+    }
+}
+
+float Profiler::GetThreadUtilization(unsigned index) const
+{
+    if (!index || index > threads_.Size())
+        return 0.0f;
+    
+    long long frameTime = 0;
+    for (PODVector<ProfilerBlock*>::ConstIterator i = root_->children_.Begin(); i != root_->children_.End(); ++i)
+        frameTime += (*i)->intervalTime_;
+    if (!frameTime)
+        return 0.0f;
+    
+    ProfilerThread* thread = threads_[index - 1];
+    MutexLock lock(thread->mutex_);
+    
+    long long busyTime = 0;
+    for (PODVector<ProfilerBlock*>::ConstIterator i = thread->root_->children_.Begin(); i != thread->root_->children_.End(); ++i)
+        busyTime += (*i)->intervalTime_;
+    
+    return (float)busyTime / (float)frameTime;
+}
+
+float Profiler::GetFrameTimePercentile(float percentile) const
+{
+    if (!numFrameTimes_)
+        return 0.0f;
+    
+    // Find the bucket of the frame at the percentile rank
+    unsigned rank = (unsigned)ceil(Clamp(percentile, 0.0f, 100.0f) * 0.01 * numFrameTimes_);
+    if (!rank)
+        rank = 1;
+    
+    unsigned count = 0;
+    for (unsigned i = 0; i < frameTimeHistogram_.Size(); ++i)
+    {
+        count += frameTimeHistogram_[i];
+        if (count >= rank)
+        {
+            // Return the bucket's upper bound, but not above the longest frame
+            long long time = (long long)(i + 1) * FRAME_HISTOGRAM_BUCKET_USEC;
+            if (time > maxFrameTime_ || i == frameTimeHistogram_.Size() - 1)
+                time = maxFrameTime_;
+            return time / 1000.0f;
+        }
+    }
+    
+    return maxFrameTime_ / 1000.0f;
 }
 
 String Profiler::GetData(bool showUnused, bool showTotal, unsigned maxDepth) const
@@ -100,6 +267,16 @@ String Profiler::GetData(bool showUnused, bool showTotal, unsigned maxDepth) con
     
     GetData(root_, output, 0, maxDepth, showUnused, showTotal);
     
+    for (unsigned i = 0; i < threads_.Size(); ++i)
+    {
+        char line[LINE_MAX_LENGTH];
+        sprintf(line, "\nWorker thread %u: %.1f%% busy\n\n", i + 1, GetThreadUtilization(i + 1) * 100.0f);
+        output += String(line);
+        
+        MutexLock lock(threads_[i]->mutex_);
+        GetData(threads_[i]->root_, output, 0, maxDepth, showUnused, showTotal);
+    }
+    
     return output;
 }
 
@@ -113,8 +290,8 @@ void Profiler::GetData(ProfilerBlock* block, String& output, unsigned depth, uns
     if (depth >= maxDepth)
         return;
     
-    // Do not print the root block as it does not collect any actual data
-    if (block != root_)
+    // Do not print the root blocks as they do not collect any actual data
+    if (block->parent_)
     {
         if (showUnused || block->intervalCount_ || (showTotal && block->totalCount_))
         {
@@ -157,4 +334,130 @@ void Profiler::GetData(ProfilerBlock* block, String& output, unsigned depth, uns
         GetData(*i, output, depth, maxDepth, showUnused, showTotal);
 }
 
+String Profiler::GetTraceData() const
+{
+    String output = "{\"traceEvents\":[\n";
+    
+    if (traceFrames_)
+    {
+        // Export only the events of the most recent frames. If fewer frames have been started, export everything
+        long long startTime = 0;
+        if (traceFrameCount_ >= traceFrames_)
+            startTime = traceFrameStarts_[traceFrameCount_ % traceFrames_];
+        
+        GetTraceData(trace_, 0, startTime, output);
+        for (unsigned i = 0; i < threads_.Size(); ++i)
+            GetTraceData(threads_[i]->trace_, i + 1, startTime, output);
+        
+        // Remove the trailing comma
+        if (output.Back() == '\n' && output.Length() > 1 && output[output.Length() - 2] == ',')
+            output.Erase(output.Length() - 2, 1);
+    }
+    
+    output += "]}\n";
+    return output;
+}
+
+void Profiler::GetTraceData(const ProfilerTraceBuffer& trace, unsigned threadIndex, long long startTime, String& output) const
+{
+    char line[LINE_MAX_LENGTH];
+    
+    if (trace.events_.Empty())
+        return;
+    
+    if (!threadIndex)
+        sprintf(line, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":0,\"args\":{\"name\":\"Main thread\"}},\n");
+    else
+    {
+        sprintf(line, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":\"Worker thread %u\"}},\n",
+            threadIndex, threadIndex);
+    }
+    output += String(line);
+    
+    // Take a snapshot of the event count, as the thread may still be recording. Skip the oldest quarter of the ring buffer
+    // when it has wrapped, as it may be overwritten during export
+    unsigned end = trace.index_;
+    unsigned begin = end > TRACE_BUFFER_EVENTS ? end - TRACE_BUFFER_EVENTS * 3 / 4 : 0;
+    unsigned depth = 0;
+    long long lastTime = startTime;
+    
+    for (unsigned i = begin; i != end; ++i)
+    {
+        const ProfilerTraceEvent& event = trace.events_[i & (TRACE_BUFFER_EVENTS - 1)];
+        if (event.time_ < startTime)
+            continue;
+        
+        // Drop block ends whose begin is outside the capture
+        if (event.begin_)
+            ++depth;
+        else if (depth)
+            --depth;
+        else
+            continue;
+        
+        sprintf(line, "{\"name\":\"%s\",\"ph\":\"%s\",\"pid\":0,\"tid\":%u,\"ts\":%lld},\n", event.name_,
+            event.begin_ ? "B" : "E", threadIndex, event.time_);
+        output += String(line);
+        lastTime = event.time_;
+    }
+    
+    // Close blocks that are still running
+    while (depth--)
+    {
+        sprintf(line, "{\"ph\":\"E\",\"pid\":0,\"tid\":%u,\"ts\":%lld},\n", threadIndex, lastTime);
+        output += String(line);
+    }
+}
+
+ProfilerThread* Profiler::GetCurrentThread() const
+{
+    for (PODVector<ProfilerThread*>::ConstIterator i = threads_.Begin(); i != threads_.End(); ++i)
+    {
+        if ((*i)->registered_ && Thread::IsCurrentThread((*i)->id_))
+            return *i;
+    }
+    
+    return 0;
+}
+
+void Profiler::BeginThreadBlock(const char* name)
+{
+    // Blocks from threads that are not worker threads are ignored
+    ProfilerThread* thread = GetCurrentThread();
+    if (!thread)
+        return;
+    
+    ProfilerBlock* block = thread->current_->FindChild(name);
+    if (!block)
+    {
+        MutexLock lock(thread->mutex_);
+        block = thread->current_->GetChild(name);
+    }
+    
+    // The call is counted when it ends, see EndThreadBlock()
+    thread->current_ = block;
+    block->timer_.Reset();
+    if (traceFrames_)
+        thread->trace_.Record(block->name_, traceTimer_.GetUSec(false), true);
+}
+
+void Profiler::EndThreadBlock()
+{
+    ProfilerThread* thread = GetCurrentThread();
+    if (!thread || thread->current_ == thread->root_)
+        return;
+    
+    ProfilerBlock* block = thread->current_;
+    long long time = block->timer_.GetUSec(false);
+    {
+        // The main thread reads and resets the frame values at frame end, so update them under the lock
+        MutexLock lock(thread->mutex_);
+        block->AddCall(time);
+    }
+    
+    if (traceFrames_)
+        thread->trace_.Record(block->name_, traceTimer_.GetUSec(false), false);
+    thread->current_ = block->parent_;
+}
+
 }
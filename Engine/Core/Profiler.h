@@ -22,12 +22,71 @@
 
 #pragma once
 
+#include "Mutex.h"
 #include "Str.h"
+#include "Thread.h"
 #include "Timer.h"
 
 namespace Urho3D
 {
 
+/// Number of buckets in the frame time histogram. The last bucket collects all longer frames.
+static const unsigned FRAME_HISTOGRAM_BUCKETS = 1000;
+/// Width of one frame time histogram bucket in microseconds.
+static const unsigned FRAME_HISTOGRAM_BUCKET_USEC = 100;
+/// Number of trace events stored per thread during trace capture. Must be a power of two.
+static const unsigned TRACE_BUFFER_EVENTS = 65536;
+
+/// Timestamped profiling block begin or end for trace capture.
+struct ProfilerTraceEvent
+{
+    /// Block name.
+    const char* name_;
+    /// Time in microseconds since the capture was started.
+    long long time_;
+    /// Begin flag. False for block end.
+    bool begin_;
+};
+
+/// Ring buffer of trace events of one thread. Written only by the thread itself.
+class ProfilerTraceBuffer
+{
+public:
+    /// Construct.
+    ProfilerTraceBuffer() :
+        index_(0)
+    {
+    }
+    
+    /// Allocate the ring buffer. Must be done before recording, and it is never freed during recording.
+    void Allocate()
+    {
+        if (events_.Empty())
+            events_.Resize(TRACE_BUFFER_EVENTS);
+    }
+    
+    /// Discard the recorded events. Must only be done while recording is disabled.
+    void Clear()
+    {
+        index_ = 0;
+    }
+    
+    /// Record a block begin or end, overwriting the oldest event if full.
+    void Record(const char* name, long long time, bool begin)
+    {
+        ProfilerTraceEvent& event = events_[index_ & (TRACE_BUFFER_EVENTS - 1)];
+        event.name_ = name;
+        event.time_ = time;
+        event.begin_ = begin;
+        ++index_;
+    }
+    
+    /// Event ring buffer.
+    PODVector<ProfilerTraceEvent> events_;
+    /// Total number of events recorded.
+    volatile unsigned index_;
+};
+
 /// Profiling data for one block in the profiling tree.
 class ProfilerBlock
 {
@@ -77,6 +136,15 @@ public:
         time_ += time;
     }
     
+    /// Add a finished call with the specified duration. Used for worker thread blocks, which are counted when they end.
+    void AddCall(long long time)
+    {
+        if (time > maxTime_)
+            maxTime_ = time;
+        time_ += time;
+        ++count_;
+    }
+    
     /// End profiling frame and update interval and total values.
     void EndFrame()
     {
@@ -110,8 +178,8 @@ public:
             (*i)->BeginInterval();
     }
     
-    /// Return child block with the specified name.
-    ProfilerBlock* GetChild(const char* name)
+    /// Return child block with the specified name, or null if not found.
+    ProfilerBlock* FindChild(const char* name)
     {
         // First check using string pointers only, then resort to actual strcmp
         for (PODVector<ProfilerBlock*>::Iterator i = children_.Begin(); i != children_.End(); ++i)
@@ -126,10 +194,20 @@ public:
                 return *i;
         }
         
-        ProfilerBlock* newBlock = new ProfilerBlock(this, name);
-        children_.Push(newBlock);
+        return 0;
+    }
+    
+    /// Return child block with the specified name. Create if not found.
+    ProfilerBlock* GetChild(const char* name)
+    {
+        ProfilerBlock* child = FindChild(name);
+        if (!child)
+        {
+            child = new ProfilerBlock(this, name);
+            children_.Push(child);
+        }
         
-        return newBlock;
+        return child;
     }
     
     /// Block name.
@@ -166,6 +244,40 @@ public:
     unsigned totalCount_;
 };
 
+/// Profiling block tree of a worker thread.
+struct ProfilerThread
+{
+    /// Construct with thread index.
+    ProfilerThread(unsigned index) :
+        root_(new ProfilerBlock(0, "Root")),
+        index_(index),
+        registered_(false)
+    {
+        current_ = root_;
+    }
+    
+    /// Destruct.
+    ~ProfilerThread()
+    {
+        delete root_;
+    }
+    
+    /// Root block.
+    ProfilerBlock* root_;
+    /// Current block. Accessed only by the thread itself.
+    ProfilerBlock* current_;
+    /// Mutex for adding child blocks and updating the block times, as the main thread reads the tree at frame end.
+    Mutex mutex_;
+    /// Trace events.
+    ProfilerTraceBuffer trace_;
+    /// Thread ID.
+    ThreadID id_;
+    /// Thread index.
+    unsigned index_;
+    /// Registered flag. Set when the thread ID is known.
+    volatile bool registered_;
+};
+
 /// Hierarchical performance profiler subsystem.
 class Profiler : public Object
 {
@@ -177,29 +289,56 @@ public:
     /// Destruct.
     virtual ~Profiler();
     
-    /// Begin timing a profiling block.
+    /// Begin timing a profiling block. Worker threads use their own block trees.
     void BeginBlock(const char* name)
     {
+        if (!Thread::IsMainThread())
+        {
+            BeginThreadBlock(name);
+            return;
+        }
+        
         current_ = current_->GetChild(name);
         current_->Begin();
+        if (traceFrames_)
+            trace_.Record(current_->name_, traceTimer_.GetUSec(false), true);
     }
     
     /// End timing the current profiling block.
     void EndBlock()
     {
+        if (!Thread::IsMainThread())
+        {
+            EndThreadBlock();
+            return;
+        }
+        
         if (current_ != root_)
         {
             current_->End();
+            if (traceFrames_)
+                trace_.Record(current_->name_, traceTimer_.GetUSec(false), false);
             current_ = current_->parent_;
         }
     }
     
+    /// Create block trees for worker threads. Called by WorkQueue before starting the threads.
+    void SetNumThreads(unsigned num);
+    /// Register the calling thread as the worker thread with the specified index (1 to number of threads.) Called by the worker thread itself on startup.
+    void RegisterThread(unsigned index);
+    
     /// Begin the profiling frame. Called by HandleBeginFrame().
     void BeginFrame();
     /// End the profiling frame. Called by HandleEndFrame().
     void EndFrame();
     /// Begin a new interval.
     void BeginInterval();
+    /// Set number of most recent frames to keep in the trace capture. Zero (default) disables trace capture.
+    void SetTraceFrames(unsigned frames);
+    /// Set frame time in milliseconds above which a frame is considered a hitch, and its profiling data is captured. Zero (default) disables.
+    void SetHitchThreshold(float threshold);
+    /// Clear the frame time histogram and the hitch count.
+    void ResetFrameTimes();
     
     /// Return profiling data as text output.
     String GetData(bool showUnused = false, bool showTotal = false, unsigned maxDepth = M_MAX_UNSIGNED) const;
@@ -207,15 +346,73 @@ public:
     const ProfilerBlock* GetCurrentBlock() { return current_; }
     /// Return the root profiling block.
     const ProfilerBlock* GetRootBlock() { return root_; }
+    /// Return number of worker threads.
+    unsigned GetNumThreads() const { return threads_.Size(); }
+    /// Return the root profiling block of a worker thread (1 to number of threads.) Blocks may be added concurrently by the thread.
+    const ProfilerBlock* GetThreadRootBlock(unsigned index) const { return index && index <= threads_.Size() ? threads_[index - 1]->root_ : 0; }
+    /// Return number of frames kept in the trace capture.
+    unsigned GetTraceFrames() const { return traceFrames_; }
+    /// Return the trace capture of all threads as Chrome trace event JSON, which can be opened in chrome://tracing.
+    String GetTraceData() const;
+    /// Return frame time in milliseconds at the specified percentile (0-100) of the frames since the last reset. Accurate to the histogram bucket width.
+    float GetFrameTimePercentile(float percentile) const;
+    /// Return longest frame time in milliseconds since the last reset.
+    float GetMaxFrameTime() const { return maxFrameTime_ / 1000.0f; }
+    /// Return number of frames in the frame time histogram.
+    unsigned GetNumFrameTimes() const { return numFrameTimes_; }
+    /// Return the frame time histogram.
+    const PODVector<unsigned>& GetFrameTimeHistogram() const { return frameTimeHistogram_; }
+    /// Return hitch threshold in milliseconds.
+    float GetHitchThreshold() const { return hitchThreshold_; }
+    /// Return number of hitches since the last reset.
+    unsigned GetNumHitches() const { return numHitches_; }
+    /// Return profiling data of the last hitch frame as text output.
+    const String& GetHitchData() const { return hitchData_; }
+    /// Return a worker thread's busy time during the current interval as a fraction of the main thread's frame time (1 to number of threads.)
+    float GetThreadUtilization(unsigned index) const;
     
 private:
     /// Return profiling data as text output for a specified profiling block.
     void GetData(ProfilerBlock* block, String& output, unsigned depth, unsigned maxDepth, bool showUnused, bool showTotal) const;
+    /// Return the calling worker thread's block tree, or null if not registered.
+    ProfilerThread* GetCurrentThread() const;
+    /// Begin timing a profiling block in a worker thread.
+    void BeginThreadBlock(const char* name);
+    /// End timing the current profiling block in a worker thread.
+    void EndThreadBlock();
+    /// Append one thread's trace events after the specified time as JSON.
+    void GetTraceData(const ProfilerTraceBuffer& trace, unsigned threadIndex, long long startTime, String& output) const;
     
     /// Current profiling block.
     ProfilerBlock* current_;
     /// Root profiling block.
     ProfilerBlock* root_;
+    /// Worker thread block trees.
+    PODVector<ProfilerThread*> threads_;
+    /// Main thread trace events.
+    ProfilerTraceBuffer trace_;
+    /// Trace capture timer.
+    mutable HiresTimer traceTimer_;
+    /// Start times of the most recent frames for trace capture.
+    PODVector<long long> traceFrameStarts_;
+    /// Number of frames started during trace capture.
+    unsigned traceFrameCount_;
+    /// Number of frames to keep in the trace capture.
+    volatile unsigned traceFrames_;
+    /// Frame timer.
+    HiresTimer frameTimer_;
+    /// Frame time histogram.
+    PODVector<unsigned> frameTimeHistogram_;
+    /// Number of frames in the histogram.
+    unsigned numFrameTimes_;
+    /// Longest frame time in microseconds.
+    long long maxFrameTime_;
+    /// Hitch threshold in milliseconds.
+    float hitchThreshold_;
+    /// Number of hitches.
+    unsigned numHitches_;
+    /// Profiling data of the last hitch frame.
+    String hitchData_;
     /// Frames in the current interval.
     unsigned intervalFrames_;
     /// Total frames.
@@ -34,6 +34,8 @@
 namespace Urho3D
 {
 
+ThreadID Thread::mainThreadID;
+
 #ifdef WIN32
 DWORD WINAPI ThreadFunctionStatic(void* data)
 {
@@ -113,4 +115,33 @@ void Thread::SetPriority(int priority)
     #endif
 }
 
+void Thread::SetMainThread()
+{
+    mainThreadID = GetCurrentThreadID();
+}
+
+ThreadID Thread::GetCurrentThreadID()
+{
+    #ifdef WIN32
+    return GetCurrentThreadId();
+    #else
+    return pthread_self();
+    #endif
+}
+
+bool Thread::IsCurrentThread(ThreadID id)
+{
+    #ifdef WIN32
+    return GetCurrentThreadId() == id;
+    #else
+    // pthread_t is an opaque type, so it can only be compared with pthread_equal()
+    return pthread_equal(pthread_self(), id) != 0;
+    #endif
+}
+
+bool Thread::IsMainThread()
+{
+    return IsCurrentThread(mainThreadID);
+}
+
 }
@@ -22,9 +22,19 @@
 
 #pragma once
 
+#ifndef WIN32
+#include <pthread.h>
+#endif
+
 namespace Urho3D
 {
 
+#ifdef WIN32
+typedef unsigned ThreadID;
+#else
+typedef pthread_t ThreadID;
+#endif
+
 /// Operating system thread.
 class Thread
 {
@@ -47,11 +57,23 @@ public:
     /// Return whether thread exists.
     bool IsStarted() const { return handle_ != 0; }
     
+    /// Set the current thread as the main thread. Called by Context on construction.
+    static void SetMainThread();
+    /// Return the current thread's ID.
+    static ThreadID GetCurrentThreadID();
+    /// Return whether is executing in the thread with the specified ID.
+    static bool IsCurrentThread(ThreadID id);
+    /// Return whether is executing in the main thread.
+    static bool IsMainThread();
+    
 protected:
     /// Thread handle.
     void* handle_;
     /// Running flag.
     volatile bool shouldRun_;
+    
+    /// Main thread's ID.
+    static ThreadID mainThreadID;
 };
 
 }
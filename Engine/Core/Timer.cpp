@@ -21,6 +21,7 @@
 //
 
 #include "Precompiled.h"
+#include "Context.h"
 #include "CoreEvents.h"
 #include "Profiler.h"
 #include "Timer.h"
@@ -91,6 +92,9 @@ void Time::BeginFrame(float timeStep)
         eventData[P_FRAMENUMBER] = frameNumber_;
         eventData[P_TIMESTEP] = timeStep_;
         SendEvent(E_BEGINFRAME, eventData);
+        
+        // Send events posted from other threads
+        context_->SendPostedEvents();
     }
 }
 
@@ -56,7 +56,7 @@ enum VariantType
     MAX_VAR_TYPES
 };
 
-/// Union for the possible variant values. Also stores non-POD objects such as String which must not exceed 16 bytes in size.
+/// Union for the possible variant values. Also stores non-POD objects such as String which must not exceed the size of four pointers.
 struct VariantValue
 {
     union
@@ -260,6 +260,15 @@ public:
         *this = value;
     }
     
+    #ifdef URHO3D_CXX11
+    /// Construct by moving a string.
+    Variant(String&& value) :
+        type_(VAR_NONE)
+    {
+        *this = Move(value);
+    }
+    #endif
+    
     /// Construct from a C string.
     Variant(const char* value) :
         type_(VAR_NONE)
@@ -302,6 +311,15 @@ public:
         *this = value;
     }
     
+    #ifdef URHO3D_CXX11
+    /// Construct by moving a variant vector.
+    Variant(VariantVector&& value) :
+        type_(VAR_NONE)
+    {
+        *this = Move(value);
+    }
+    #endif
+    
     /// Construct from a variant map.
     Variant(const VariantMap& value) :
         type_(VAR_NONE)
@@ -309,6 +327,15 @@ public:
         *this = value;
     }
     
+    #ifdef URHO3D_CXX11
+    /// Construct by moving a variant map.
+    Variant(VariantMap&& value) :
+        type_(VAR_NONE)
+    {
+        *this = Move(value);
+    }
+    #endif
+    
     /// Construct from an integer rect.
     Variant(const IntRect& value) :
         type_(VAR_NONE)
@@ -358,6 +385,15 @@ public:
         *this = value;
     }
     
+    #ifdef URHO3D_CXX11
+    /// Move-construct from another variant.
+    Variant(Variant&& value) :
+        type_(VAR_NONE)
+    {
+        *this = Move(value);
+    }
+    #endif
+    
     /// Destruct.
     ~Variant()
     {
@@ -373,6 +409,24 @@ public:
     /// Assign from another variant.
     Variant& operator = (const Variant& rhs);
     
+    #ifdef URHO3D_CXX11
+    /// Move-assign from another variant. Other values than strings are relocated bitwise, as they do not point to themselves.
+    Variant& operator = (Variant&& rhs)
+    {
+        if (rhs.type_ == VAR_STRING)
+            return *this = Move(*(reinterpret_cast<String*>(&rhs.value_)));
+        
+        if (&rhs != this)
+        {
+            SetType(VAR_NONE);
+            type_ = rhs.type_;
+            value_ = rhs.value_;
+            rhs.type_ = VAR_NONE;
+        }
+        return *this;
+    }
+    #endif
+    
     /// Assign from an integer.
     Variant& operator = (int rhs)
     {
@@ -469,6 +523,16 @@ public:
         return *this;
     }
     
+    #ifdef URHO3D_CXX11
+    /// Move-assign from a string.
+    Variant& operator = (String&& rhs)
+    {
+        SetType(VAR_STRING);
+        *(reinterpret_cast<String*>(&value_)) = Move(rhs);
+        return *this;
+    }
+    #endif
+    
     /// Assign from a C string.
     Variant& operator = (const char* rhs)
     {
@@ -517,6 +581,16 @@ public:
         return *this;
     }
     
+    #ifdef URHO3D_CXX11
+    /// Move-assign from a variant vector.
+    Variant& operator = (VariantVector&& rhs)
+    {
+        SetType(VAR_VARIANTVECTOR);
+        *(reinterpret_cast<VariantVector*>(&value_)) = Move(rhs);
+        return *this;
+    }
+    #endif
+    
     /// Assign from a variant map.
     Variant& operator = (const VariantMap& rhs)
     {
@@ -525,6 +599,16 @@ public:
         return *this;
     }
     
+    #ifdef URHO3D_CXX11
+    /// Move-assign from a variant map.
+    Variant& operator = (VariantMap&& rhs)
+    {
+        SetType(VAR_VARIANTMAP);
+        *(reinterpret_cast<VariantMap*>(&value_)) = Move(rhs);
+        return *this;
+    }
+    #endif
+    
     /// Assign from an integer rect.
     Variant& operator = (const IntRect& rhs)
     {
@@ -21,6 +21,7 @@
 //
 
 #include "Precompiled.h"
+#include "Atomic.h"
 #include "CoreEvents.h"
 #include "ProcessUtils.h"
 #include "Profiler.h"
@@ -33,6 +34,37 @@ namespace Urho3D
 
 const unsigned MAX_NONTHREADED_WORK_USEC = 1000;
 
+/// Work item queue owned by one thread. Sorted by priority so that the highest priority item is last.
+class WorkItemQueue : public RefCounted
+{
+public:
+    /// Insert a work item according to its priority.
+    void Insert(WorkItem* item)
+    {
+        // Work items are usually added in descending priority order, so search for the position from the end
+        unsigned pos = items_.Size();
+        while (pos > 0 && items_[pos - 1]->priority_ > item->priority_)
+            --pos;
+        items_.Insert(pos, item);
+    }
+    
+    /// Take the highest priority work item if it has at least the specified priority. Return null if none.
+    WorkItem* Take(unsigned priority)
+    {
+        if (items_.Empty() || items_.Back()->priority_ < priority)
+            return 0;
+        
+        WorkItem* item = items_.Back();
+        items_.Pop();
+        return item;
+    }
+    
+    /// Work items.
+    PODVector<WorkItem*> items_;
+    /// Mutex for the work items. Contended only when another thread steals work.
+    Mutex mutex_;
+};
+
 /// Worker thread managed by the work queue.
 class WorkerThread : public Thread, public RefCounted
 {
@@ -49,6 +81,11 @@ public:
     {
         // Init FPU state first
         InitFPU();
+        
+        Profiler* profiler = owner_->GetSubsystem<Profiler>();
+        if (profiler)
+            profiler->RegisterThread(index_);
+        
         owner_->ProcessItems(index_);
     }
     
@@ -66,10 +103,13 @@ OBJECTTYPESTATIC(WorkQueue);
 
 WorkQueue::WorkQueue(Context* context) :
     Object(context),
+    nextQueue_(0),
     shutDown_(false),
-    pausing_(false),
     paused_(false)
 {
+    // Create the main thread queue, which is used only if there are no worker threads
+    queues_.Push(SharedPtr<WorkItemQueue>(new WorkItemQueue()));
+    
     SubscribeToEvent(E_BEGINFRAME, HANDLER(WorkQueue, HandleBeginFrame));
 }
 
@@ -93,6 +133,15 @@ void WorkQueue::CreateThreads(unsigned numThreads)
     // Start threads in paused mode
     Pause();
     
+    // Create the threads' profiling block trees before they can be used
+    Profiler* profiler = GetSubsystem<Profiler>();
+    if (profiler)
+        profiler->SetNumThreads(numThreads);
+    
+    // Create all queues before starting any thread, as the threads will access each other's queues
+    for (unsigned i = 0; i < numThreads; ++i)
+        queues_.Push(SharedPtr<WorkItemQueue>(new WorkItemQueue()));
+    
     for (unsigned i = 0; i < numThreads; ++i)
     {
         SharedPtr<WorkerThread> thread(new WorkerThread(this, i + 1));
@@ -101,50 +150,27 @@ void WorkQueue::CreateThreads(unsigned numThreads)
     }
 }
 
-void WorkQueue::AddWorkItem(const WorkItem& item)
+WorkItem* WorkQueue::AddWorkItem(const WorkItem& item)
 {
-    // Push to the main thread list to keep item alive
-    // Clear completed flag in case item is reused
-    workItems_.Push(item);
-    WorkItem* itemPtr = &workItems_.Back();
-    itemPtr->completed_ = false;
-    
-    // Make sure worker threads' list is safe to modify
-    if (threads_.Size() && !paused_)
-        queueMutex_.Acquire();
-    
-    // Find position for new item
-    if (queue_.Empty())
-        queue_.Push(itemPtr);
-    else
-    {
-        for (List<WorkItem*>::Iterator i = queue_.Begin(); i != queue_.End(); ++i)
-        {
-            if ((*i)->priority_ <= itemPtr->priority_)
-            {
-                queue_.Insert(i, itemPtr);
-                break;
-            }
-        }
-    }
-    
-    if (threads_.Size())
-    {
-        queueMutex_.Release();
-        paused_ = false;
-    }
+    return AddWorkItem(item, 0, 0);
+}
+
+WorkItem* WorkQueue::AddWorkItem(const WorkItem& item, WorkItem* predecessor)
+{
+    return AddWorkItem(item, &predecessor, predecessor ? 1 : 0);
+}
+
+WorkItem* WorkQueue::AddWorkItem(const WorkItem& item, const PODVector<WorkItem*>& predecessors)
+{
+    return AddWorkItem(item, predecessors.Size() ? &predecessors[0] : 0, predecessors.Size());
 }
 
 void WorkQueue::Pause()
 {
     if (!paused_)
     {
-        pausing_ = true;
-        
-        queueMutex_.Acquire();
+        pauseMutex_.Acquire();
         paused_ = true;
-        
-        pausing_ = false;
     }
 }
 
@@ -152,7 +178,7 @@ void WorkQueue::Resume()
 {
     if (paused_)
     {
-        queueMutex_.Release();
+        pauseMutex_.Release();
         paused_ = false;
     }
 }
@@ -164,49 +190,55 @@ void WorkQueue::Complete(unsigned priority)
     {
         Resume();
         
-        // Take work items also in the main thread until queue empty or no high-priority items anymore
-        while (!queue_.Empty())
+        // Steal work items also in the main thread until no high-priority items anymore, then wait for threaded work
+        // to complete
+        for (;;)
         {
-            queueMutex_.Acquire();
-            if (!queue_.Empty() && queue_.Front()->priority_ >= priority)
-            {
-                WorkItem* item = queue_.Front();
-                queue_.PopFront();
-                queueMutex_.Release();
-                item->workFunction_(item, 0);
-                item->completed_ = true;
-            }
-            else
-            {
-                queueMutex_.Release();
+            WorkItem* item = TakeWorkItem(0, priority);
+            if (item)
+                ExecuteWorkItem(item, 0);
+            else if (IsCompleted(priority))
                 break;
-            }
         }
         
-        // Wait for threaded work to complete
-        while (!IsCompleted(priority))
+        // If no work at all remaining, pause worker threads by leaving the mutex locked
+        bool empty = true;
+        for (unsigned i = 0; i < queues_.Size(); ++i)
         {
+            if (!queues_[i]->items_.Empty())
+            {
+                empty = false;
+                break;
+            }
         }
-        
-        // If no work at all remaining, pause worker threads by leaving the mutex locked
-        if (queue_.Empty())
+        if (empty)
             Pause();
     }
     else
     {
         // No worker threads: ensure all high-priority items are completed in the main thread
-        while (!queue_.Empty() && queue_.Front()->priority_ >= priority)
-        {
-            WorkItem* item = queue_.Front();
-            queue_.PopFront();
-            item->workFunction_(item, 0);
-            item->completed_ = true;
-        }
+        WorkItemQueue* queue = queues_[0];
+        while (WorkItem* item = queue->Take(priority))
+            ExecuteWorkItem(item, 0);
     }
     
     PurgeCompleted();
 }
 
+void WorkQueue::CompleteItem(WorkItem* item)
+{
+    if (threads_.Size())
+        Resume();
+    
+    // Execute work also in the main thread while waiting. The item's predecessors have at least the same priority
+    while (!item->completed_)
+    {
+        WorkItem* other = TakeWorkItem(0, item->priority_);
+        if (other)
+            ExecuteWorkItem(other, 0);
+    }
+}
+
 bool WorkQueue::IsCompleted(unsigned priority) const
 {
     for (List<WorkItem>::ConstIterator i = workItems_.Begin(); i != workItems_.End(); ++i)
@@ -220,37 +252,122 @@ bool WorkQueue::IsCompleted(unsigned priority) const
 
 void WorkQueue::ProcessItems(unsigned threadIndex)
 {
-    bool wasActive = false;
-    
     for (;;)
     {
         if (shutDown_)
             return;
         
-        if (pausing_ && !wasActive)
-            Time::Sleep(0);
+        WorkItem* item = TakeWorkItem(threadIndex, 0);
+        if (item)
+            ExecuteWorkItem(item, threadIndex);
+        else if (paused_)
+        {
+            // Block until the main thread resumes
+            pauseMutex_.Acquire();
+            pauseMutex_.Release();
+        }
         else
+            Time::Sleep(0);
+    }
+}
+
+WorkItem* WorkQueue::TakeWorkItem(unsigned threadIndex, unsigned priority)
+{
+    // Check the thread's own queue first, then try to steal from the others
+    unsigned numQueues = queues_.Size();
+    for (unsigned i = 0; i < numQueues; ++i)
+    {
+        WorkItemQueue* queue = queues_[(threadIndex + i) % numQueues];
+        // Check emptiness without locking first to avoid contending on idle queues
+        if (queue->items_.Empty())
+            continue;
+        
+        queue->mutex_.Acquire();
+        WorkItem* item = queue->Take(priority);
+        queue->mutex_.Release();
+        if (item)
+            return item;
+    }
+    
+    return 0;
+}
+
+WorkItem* WorkQueue::AddWorkItem(const WorkItem& item, WorkItem* const* predecessors, unsigned numPredecessors)
+{
+    // Push to the main thread list to keep item alive
+    // Clear completed flag and continuations in case item is reused
+    workItems_.Push(item);
+    WorkItem* itemPtr = &workItems_.Back();
+    itemPtr->completed_ = false;
+    itemPtr->executed_ = false;
+    itemPtr->continuations_.Clear();
+    // Hold an extra count until all predecessors have been registered, so that the item can not be queued prematurely
+    itemPtr->pendingPredecessors_ = 1;
+    
+    for (unsigned i = 0; i < numPredecessors; ++i)
+    {
+        WorkItem* predecessor = predecessors[i];
+        
+        predecessor->continuationLock_.Acquire();
+        if (!predecessor->executed_)
         {
-            queueMutex_.Acquire();
-            if (!queue_.Empty())
-            {
-                wasActive = true;
-                
-                WorkItem* item = queue_.Front();
-                queue_.PopFront();
-                queueMutex_.Release();
-                item->workFunction_(item, threadIndex);
-                item->completed_ = true;
-            }
-            else
-            {
-                wasActive = false;
-                
-                queueMutex_.Release();
-                Time::Sleep(0);
-            }
+            AtomicIncrement(itemPtr->pendingPredecessors_);
+            predecessor->continuations_.Push(itemPtr);
+            // The item can not complete before its predecessors, so it should not be waited for at a higher priority
+            if (predecessor->priority_ < itemPtr->priority_)
+                itemPtr->priority_ = predecessor->priority_;
         }
+        predecessor->continuationLock_.Release();
+    }
+    
+    if (!AtomicDecrement(itemPtr->pendingPredecessors_))
+        QueueWorkItem(itemPtr, 0);
+    
+    return itemPtr;
+}
+
+void WorkQueue::QueueWorkItem(WorkItem* item, unsigned threadIndex)
+{
+    if (threads_.Size())
+    {
+        // The main thread distributes work to the worker threads' queues in round-robin order, while worker threads
+        // push continuations to their own queue. Idle threads will steal the rest
+        unsigned queueIndex = threadIndex;
+        if (!queueIndex)
+            queueIndex = nextQueue_ = nextQueue_ % threads_.Size() + 1;
+        WorkItemQueue* queue = queues_[queueIndex];
+        
+        queue->mutex_.Acquire();
+        queue->Insert(item);
+        queue->mutex_.Release();
+        
+        if (!threadIndex)
+            Resume();
+    }
+    else
+        queues_[0]->Insert(item);
+}
+
+void WorkQueue::ExecuteWorkItem(WorkItem* item, unsigned threadIndex)
+{
+    {
+        PROFILE(ExecuteWorkItem);
+        item->workFunction_(item, threadIndex);
     }
+    
+    // Prevent adding further continuations, then queue those whose predecessors have all completed
+    item->continuationLock_.Acquire();
+    item->executed_ = true;
+    item->continuationLock_.Release();
+    
+    for (PODVector<WorkItem*>::ConstIterator i = item->continuations_.Begin(); i != item->continuations_.End(); ++i)
+    {
+        if (!AtomicDecrement((*i)->pendingPredecessors_))
+            QueueWorkItem(*i, threadIndex);
+    }
+    
+    // Mark completed last, as the main thread may purge the item after this
+    item->completed_ = true;
 }
 
 void WorkQueue::PurgeCompleted()
@@ -280,19 +397,15 @@ void WorkQueue::PurgeCompleted()
 void WorkQueue::HandleBeginFrame(StringHash eventType, VariantMap& eventData)
 {
     // If no worker threads, complete low-priority work here
-    if (threads_.Empty() && !queue_.Empty())
+    WorkItemQueue* queue = queues_[0];
+    if (threads_.Empty() && !queue->items_.Empty())
     {
         PROFILE(CompleteWorkNonthreaded);
         
         HiresTimer timer;
         
-        while (!queue_.Empty() && timer.GetUSec(false) < MAX_NONTHREADED_WORK_USEC)
-        {
-            WorkItem* item = queue_.Front();
-            queue_.PopFront();
-            item->workFunction_(item, 0);
-            item->completed_ = true;
-        }
+        while (!queue->items_.Empty() && timer.GetUSec(false) < MAX_NONTHREADED_WORK_USEC)
+            ExecuteWorkItem(queue->Take(0), 0);
     }
     
     PurgeCompleted();
@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include "Atomic.h"
 #include "List.h"
 #include "Mutex.h"
 #include "Object.h"
@@ -36,6 +37,7 @@ EVENT(E_WORKITEMCOMPLETED, WorkItemCompleted)
 }
 
 class WorkerThread;
+class WorkItemQueue;
 
 /// Work queue item.
 struct WorkItem
@@ -44,7 +46,9 @@ struct WorkItem
     WorkItem() :
         priority_(M_MAX_UNSIGNED),
         sendEvent_(false),
-        completed_(false)
+        completed_(false),
+        pendingPredecessors_(0),
+        executed_(false)
     {
     }
     
@@ -62,9 +66,17 @@ struct WorkItem
     bool sendEvent_;
     /// Completed flag.
     volatile bool completed_;
+    /// Number of predecessor work items still to complete, plus one while the item is being added. Managed by the work queue.
+    volatile int pendingPredecessors_;
+    /// Work items to queue once this item has been executed. Managed by the work queue.
+    PODVector<WorkItem*> continuations_;
+    /// Lock for the continuations and the executed flag. Managed by the work queue.
+    SpinLock continuationLock_;
+    /// Executed flag. After this no more continuations can be added. Managed by the work queue.
+    bool executed_;
 };
 
-/// Work queue subsystem for multithreading.
+/// Work queue subsystem for multithreading. Each worker thread owns a prioritized work item queue, and idle threads steal work from the other threads' queues.
 class WorkQueue : public Object
 {
     OBJECT(WorkQueue);
@@ -79,14 +91,20 @@ public:
     
     /// Create worker threads. Can only be called once.
     void CreateThreads(unsigned numThreads);
-    /// Add a work item and resume worker threads.
-    void AddWorkItem(const WorkItem& item);
+    /// Add a work item and resume worker threads. Return the queued item, which can be used as a predecessor for later work items until the next Complete() call.
+    WorkItem* AddWorkItem(const WorkItem& item);
+    /// Add a work item that will be queued once the predecessor item has completed. Return the queued item.
+    WorkItem* AddWorkItem(const WorkItem& item, WorkItem* predecessor);
+    /// Add a work item that will be queued once all the predecessor items have completed. Its priority is limited to the lowest predecessor priority. Return the queued item.
+    WorkItem* AddWorkItem(const WorkItem& item, const PODVector<WorkItem*>& predecessors);
     /// Pause worker threads.
     void Pause();
     /// Resume worker threads.
     void Resume();
     /// Finish all queued work which has at least the specified priority. Main thread will also execute priority work. Pause worker threads if no more work remains.
     void Complete(unsigned priority);
+    /// Finish the specified work item, which has been returned by AddWorkItem(). Main thread will also execute work of at least the same priority meanwhile. Completed items are not purged.
+    void CompleteItem(WorkItem* item);
     
     /// Return number of worker threads.
     unsigned GetNumThreads() const { return threads_.Size(); }
@@ -94,8 +112,16 @@ public:
     bool IsCompleted(unsigned priority) const;
     
 private:
+    /// Add a work item with predecessors.
+    WorkItem* AddWorkItem(const WorkItem& item, WorkItem* const* predecessors, unsigned numPredecessors);
     /// Process work items until shut down. Called by the worker threads.
     void ProcessItems(unsigned threadIndex);
+    /// Take the highest priority work item from a thread's own queue, or steal from the other queues if empty. Return null if no work with at least the specified priority.
+    WorkItem* TakeWorkItem(unsigned threadIndex, unsigned priority);
+    /// Push a work item whose predecessors have completed to a queue. If called from a worker thread, use its own queue.
+    void QueueWorkItem(WorkItem* item, unsigned threadIndex);
+    /// Execute a work item, mark it completed and queue its continuations as necessary.
+    void ExecuteWorkItem(WorkItem* item, unsigned threadIndex);
     /// Purge completed work items and send completion events as necessary.
     void PurgeCompleted();
     /// Handle frame start event. Purge completed work from the main thread queue, and perform work if no threads at all.
@@ -105,16 +131,16 @@ private:
     Vector<SharedPtr<WorkerThread> > threads_;
     /// Work item collection. Accessed only by the main thread.
     List<WorkItem> workItems_;
-    /// Work item prioritized queue for worker threads. Pointers are guaranteed to be valid (point to workItems.)
-    List<WorkItem*> queue_;
-    /// Worker queue mutex.
-    Mutex queueMutex_;
+    /// Per-thread prioritized work item queues. Index 0 is used by the main thread when there are no worker threads. Pointers are guaranteed to be valid (point to workItems.)
+    Vector<SharedPtr<WorkItemQueue> > queues_;
+    /// Pause mutex. Held by the main thread while paused to prevent worker threads using up CPU time.
+    Mutex pauseMutex_;
+    /// Queue to push the next work item into.
+    unsigned nextQueue_;
     /// Shutting down flag.
     volatile bool shutDown_;
-    /// Pausing flag. Indicates the worker threads should not contend for the queue mutex.
-    volatile bool pausing_;
-    /// Paused flag. Indicates the queue mutex being locked to prevent worker threads using up CPU time.
-    bool paused_;
+    /// Paused flag. Indicates the pause mutex being locked.
+    volatile bool paused_;
 };
 
 }
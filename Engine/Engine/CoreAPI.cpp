@@ -24,6 +24,7 @@
 #include "APITemplates.h"
 #include "Context.h"
 #include "ProcessUtils.h"
+#include "Profiler.h"
 #include "StringUtils.h"
 
 namespace Urho3D
@@ -107,6 +108,7 @@ static void RegisterStringHash(asIScriptEngine* engine)
     engine->RegisterObjectMethod("StringHash", "int opCmp(const StringHash&in) const", asFUNCTION(StringHashCmp), asCALL_CDECL_OBJFIRST);
     engine->RegisterObjectMethod("StringHash", "StringHash opAdd(const StringHash&in) const", asMETHOD(StringHash, operator +), asCALL_THISCALL);
     engine->RegisterObjectMethod("StringHash", "String ToString() const", asMETHOD(StringHash, ToString), asCALL_THISCALL);
+    engine->RegisterObjectMethod("StringHash", "String Reverse() const", asMETHOD(StringHash, Reverse), asCALL_THISCALL);
     engine->RegisterObjectMethod("StringHash", "uint get_value()", asMETHOD(StringHash, Value), asCALL_THISCALL);
     
     engine->RegisterObjectType("ShortStringHash", sizeof(ShortStringHash), asOBJ_VALUE | asOBJ_POD | asOBJ_APP_CLASS_CAK);
@@ -119,6 +121,7 @@ static void RegisterStringHash(asIScriptEngine* engine)
     engine->RegisterObjectMethod("ShortStringHash", "bool opEquals(const ShortStringHash&in) const", asMETHOD(ShortStringHash, operator ==), asCALL_THISCALL);
     engine->RegisterObjectMethod("ShortStringHash", "int opCmp(const ShortStringHash&in) const", asFUNCTION(ShortStringHashCmp), asCALL_CDECL_OBJFIRST);
     engine->RegisterObjectMethod("ShortStringHash", "String ToString() const", asMETHOD(ShortStringHash, ToString), asCALL_THISCALL);
+    engine->RegisterObjectMethod("ShortStringHash", "String Reverse() const", asMETHOD(ShortStringHash, Reverse), asCALL_THISCALL);
     engine->RegisterObjectMethod("ShortStringHash", "uint16 get_value()", asMETHOD(ShortStringHash, Value), asCALL_THISCALL);
 }
 
@@ -586,6 +589,29 @@ static void RegisterTimer(asIScriptEngine* engine)
     engine->RegisterGlobalFunction("Time@+ get_time()", asFUNCTION(GetTime), asCALL_CDECL);
 }
 
+static Profiler* GetProfiler()
+{
+    return GetScriptContext()->GetSubsystem<Profiler>();
+}
+
+static void RegisterProfiler(asIScriptEngine* engine)
+{
+    RegisterObject<Profiler>(engine, "Profiler");
+    engine->RegisterObjectMethod("Profiler", "String GetData(bool showUnused = false, bool showTotal = false, uint maxDepth = 0xffffffff) const", asMETHODPR(Profiler, GetData, (bool, bool, unsigned) const, String), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Profiler", "String GetTraceData() const", asMETHODPR(Profiler, GetTraceData, () const, String), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Profiler", "void set_traceFrames(uint)", asMETHOD(Profiler, SetTraceFrames), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Profiler", "uint get_traceFrames() const", asMETHOD(Profiler, GetTraceFrames), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Profiler", "void ResetFrameTimes()", asMETHOD(Profiler, ResetFrameTimes), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Profiler", "float GetFrameTimePercentile(float) const", asMETHOD(Profiler, GetFrameTimePercentile), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Profiler", "float get_maxFrameTime() const", asMETHOD(Profiler, GetMaxFrameTime), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Profiler", "uint get_numFrameTimes() const", asMETHOD(Profiler, GetNumFrameTimes), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Profiler", "void set_hitchThreshold(float)", asMETHOD(Profiler, SetHitchThreshold), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Profiler", "float get_hitchThreshold() const", asMETHOD(Profiler, GetHitchThreshold), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Profiler", "uint get_numHitches() const", asMETHOD(Profiler, GetNumHitches), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Profiler", "const String& get_hitchData() const", asMETHOD(Profiler, GetHitchData), asCALL_THISCALL);
+    engine->RegisterGlobalFunction("Profiler@+ get_profiler()", asFUNCTION(GetProfiler), asCALL_CDECL);
+}
+
 static CScriptArray* GetArgumentsToArray()
 {
     return VectorToArray<String>(GetArguments(), "Array<String>");
@@ -772,6 +798,7 @@ void RegisterCoreAPI(asIScriptEngine* engine)
     RegisterProcessUtils(engine);
     RegisterObject(engine);
     RegisterTimer(engine);
+    RegisterProfiler(engine);
 }
 
 }
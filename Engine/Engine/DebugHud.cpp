@@ -114,13 +114,15 @@ void DebugHud::Update()
         }
         
         String stats;
-        stats.AppendWithFormat("Triangles %u\nBatches %u\nViews %u\nLights %u\nShadowmaps %u\nOccluders %u",
+        stats.AppendWithFormat("Triangles %u\nBatches %u\nViews %u\nLights %u\nShadowmaps %u\nOccluders %u\nFrame memory %u KB (peak %u KB)",
             primitives,
             batches,
             renderer->GetNumViews(),
             renderer->GetNumLights(true),
             renderer->GetNumShadowMaps(true),
-            renderer->GetNumOccluders(true));
+            renderer->GetNumOccluders(true),
+            renderer->GetFrameMemoryUse() / 1024,
+            renderer->GetFrameMemoryPeak() / 1024);
         
         if (!appStats_.Empty())
         {
@@ -162,7 +164,18 @@ void DebugHud::Update()
 
             if (profilerText_->IsVisible())
             {
-                String profilerOutput = profiler->GetData(false, false, profilerMaxDepth_);
+                String profilerOutput;
+                if (profiler->GetNumFrameTimes())
+                {
+                    profilerOutput.AppendWithFormat("Frame time p50 %.2f p95 %.2f p99 %.2f p99.9 %.2f max %.2f ms, hitches %u\n\n",
+                        profiler->GetFrameTimePercentile(50.0f),
+                        profiler->GetFrameTimePercentile(95.0f),
+                        profiler->GetFrameTimePercentile(99.0f),
+                        profiler->GetFrameTimePercentile(99.9f),
+                        profiler->GetMaxFrameTime(),
+                        profiler->GetNumHitches());
+                }
+                profilerOutput += profiler->GetData(false, false, profilerMaxDepth_);
                 profilerText_->SetText(profilerOutput);
             }
 
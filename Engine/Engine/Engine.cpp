@@ -27,6 +27,7 @@
 #include "CoreEvents.h"
 #include "DebugHud.h"
 #include "Engine.h"
+#include "File.h"
 #include "FileSystem.h"
 #include "Graphics.h"
 #include "Input.h"
@@ -84,6 +85,7 @@ Engine::Engine(Context* context) :
     maxInactiveFps_(60),
     pauseMinimized_(false),
     #endif
+    pipelinedFrames_(false),
     initialized_(false),
     exiting_(false),
     headless_(false),
@@ -152,6 +154,8 @@ bool Engine::Initialize(const String& windowTitle, const String& logName, const
                 lqShadows = true;
             else if (argument == "nothreads")
                 threads = false;
+            else if (argument == "pipeline")
+                SetPipelinedFrames(true);
             else if (argument == "sm2")
                 forceSM2 = true;
             else
@@ -215,6 +219,10 @@ bool Engine::Initialize(const String& windowTitle, const String& logName, const
             log->SetLevel(LOG_DEBUG);
     }
     
+    // Log the profiling data of frames that exceed the profiler's hitch threshold
+    if (GetSubsystem<Profiler>())
+        SubscribeToEvent(E_PROFILERHITCH, HANDLER(Engine, HandleProfilerHitch));
+    
     // Set maximally accurate low res timer
     GetSubsystem<Time>()->SetTimerPeriod(1);
     
@@ -251,8 +259,11 @@ bool Engine::Initialize(const String& windowTitle, const String& logName, const
     else if (fileSystem->DirExists(exePath + "Data"))
         cache->AddResourceDir(exePath + "Data");
     
-    // Initialize graphics & audio output
+    // Initialize graphics & audio output. The null graphics backend needs no window or GPU, so it is initialized also
+    // in headless mode to allow profiling the rendering code
+    #ifndef USE_NULL_GRAPHICS
     if (!headless_)
+    #endif
     {
         Graphics* graphics = GetSubsystem<Graphics>();
         Renderer* renderer = GetSubsystem<Renderer>();
@@ -270,7 +281,7 @@ bool Engine::Initialize(const String& windowTitle, const String& logName, const
         if (shadows && lqShadows)
             renderer->SetShadowQuality(SHADOWQUALITY_LOW_16BIT);
         
-        if (sound)
+        if (sound && !headless_)
             GetSubsystem<Audio>()->SetMode(buffer, mixRate, stereo, interpolation);
     }
     
@@ -404,6 +415,12 @@ void Engine::SetPauseMinimized(bool enable)
     pauseMinimized_ = enable;
 }
 
+void Engine::SetPipelinedFrames(bool enable)
+{
+    pipelinedFrames_ = enable;
+    PhysicsWorld::SetPipelined(enable);
+}
+
 void Engine::Exit()
 {
     Graphics* graphics = GetSubsystem<Graphics>();
@@ -420,6 +437,27 @@ void Engine::DumpProfilingData()
         LOGRAW(profiler->GetData(true, true) + "\n");
 }
 
+bool Engine::DumpProfilerTrace(const String& fileName)
+{
+    Profiler* profiler = GetSubsystem<Profiler>();
+    if (!profiler || !profiler->GetTraceFrames())
+    {
+        LOGERROR("Profiler trace capture is not enabled");
+        return false;
+    }
+    
+    File file(context_, fileName, FILE_WRITE);
+    if (!file.IsOpen())
+        return false;
+    
+    String data = profiler->GetTraceData();
+    if (file.Write(data.CString(), data.Length()) != data.Length())
+        return false;
+    
+    LOGINFO("Profiler trace written to " + fileName);
+    return true;
+}
+
 void Engine::DumpResources()
 {
     #ifdef ENABLE_LOGGING
@@ -592,7 +630,9 @@ void Engine::RegisterSubsystems()
     context_->RegisterSubsystem(new ResourceCache(context_));
     context_->RegisterSubsystem(new Network(context_));
     
+    #ifndef USE_NULL_GRAPHICS
     if (!headless_)
+    #endif
     {
         context_->RegisterSubsystem(new Graphics(context_));
         context_->RegisterSubsystem(new Renderer(context_));
@@ -606,4 +646,12 @@ void Engine::RegisterSubsystems()
     #endif
 }
 
+void Engine::HandleProfilerHitch(StringHash eventType, VariantMap& eventData)
+{
+    using namespace ProfilerHitch;
+    
+    LOGWARNING(ToString("Frame %u took %.3f ms", eventData[P_FRAMENUMBER].GetUInt(), eventData[P_FRAMETIME].GetFloat()));
+    LOGRAW(eventData[P_DATA].GetString() + "\n");
+}
+
 }
@@ -60,10 +60,14 @@ public:
     void SetMaxInactiveFps(int fps);
     /// Set whether to pause update events and audio when minimized.
     void SetPauseMinimized(bool enable);
+    /// Set whether to pipeline frames: the physics simulation step is executed in a worker thread from the scene subsystem update until the end of the frame, overlapping the rest of the update, view preparation and rendering. Its results are applied at the end of the frame, which adds one frame of latency to physics.
+    void SetPipelinedFrames(bool enable);
     /// Close the application window and set the exit flag.
     void Exit();
     /// Dump profiling information to the log.
     void DumpProfilingData();
+    /// Write the profiler trace capture of the most recent frames to a Chrome trace event JSON file. Return true if successful.
+    bool DumpProfilerTrace(const String& fileName);
     /// Dump information of all resources to the log.
     void DumpResources();
     /// Dump information of all memory allocations to the log. Supported in MSVC debug mode only.
@@ -77,6 +81,8 @@ public:
     int GetMaxInactiveFps() const { return maxInactiveFps_; }
     /// Return whether to pause update events and audio when minimized.
     bool GetPauseMinimized() const { return pauseMinimized_; }
+    /// Return whether frames are pipelined.
+    bool GetPipelinedFrames() const { return pipelinedFrames_; }
     /// Return whether engine has been initialized.
     bool IsInitialized() const { return initialized_; }
     /// Return whether exit has been requested.
@@ -96,6 +102,8 @@ private:
     void RegisterObjects();
     /// Create and register subsystems. In headless mode graphics, input & UI are not created.
     void RegisterSubsystems();
+    /// Handle profiler hitch event.
+    void HandleProfilerHitch(StringHash eventType, VariantMap& eventData);
     
     /// Frame update timer.
     HiresTimer frameTimer_;
@@ -109,6 +117,8 @@ private:
     unsigned maxInactiveFps_;
     /// Pause when minimized flag.
     bool pauseMinimized_;
+    /// Pipelined frames flag.
+    bool pipelinedFrames_;
     /// Initialized flag.
     bool initialized_;
     /// Exiting flag.
@@ -23,6 +23,7 @@
 #include "Precompiled.h"
 #include "APITemplates.h"
 #include "PackageFile.h"
+#include "PrefabTemplate.h"
 #include "Scene.h"
 #include "SmoothedTransform.h"
 #include "Sort.h"
@@ -150,6 +151,18 @@ static void RegisterSmoothedTransform(asIScriptEngine* engine)
     engine->RegisterObjectMethod("SmoothedTransform", "bool get_active() const", asMETHOD(SmoothedTransform, IsActive), asCALL_THISCALL);
 }
 
+static void RegisterPrefabTemplate(asIScriptEngine* engine)
+{
+    RegisterResource<PrefabTemplate>(engine, "PrefabTemplate");
+    engine->RegisterObjectMethod("PrefabTemplate", "bool LoadXML(const XMLElement&in)", asMETHOD(PrefabTemplate, LoadXML), asCALL_THISCALL);
+    engine->RegisterObjectMethod("PrefabTemplate", "bool Define(Node@+)", asMETHOD(PrefabTemplate, Define), asCALL_THISCALL);
+    engine->RegisterObjectMethod("PrefabTemplate", "void Clear()", asMETHOD(PrefabTemplate, Clear), asCALL_THISCALL);
+    engine->RegisterObjectMethod("PrefabTemplate", "Node@+ Instantiate(Node@+, CreateMode mode = REPLICATED) const", asMETHODPR(PrefabTemplate, Instantiate, (Node*, CreateMode) const, Node*), asCALL_THISCALL);
+    engine->RegisterObjectMethod("PrefabTemplate", "uint get_numNodes() const", asMETHOD(PrefabTemplate, GetNumNodes), asCALL_THISCALL);
+    engine->RegisterObjectMethod("PrefabTemplate", "uint get_numComponents() const", asMETHOD(PrefabTemplate, GetNumComponents), asCALL_THISCALL);
+    engine->RegisterObjectMethod("PrefabTemplate", "uint get_numReferences() const", asMETHOD(PrefabTemplate, GetNumReferences), asCALL_THISCALL);
+}
+
 static void RegisterScene(asIScriptEngine* engine)
 {
     engine->RegisterGlobalProperty("const uint FIRST_REPLICATED_ID", (void*)&FIRST_REPLICATED_ID);
@@ -169,6 +182,7 @@ static void RegisterScene(asIScriptEngine* engine)
     engine->RegisterObjectMethod("Scene", "Node@+ InstantiateXML(File@+, const Vector3&in, const Quaternion&in, CreateMode mode = REPLICATED)", asFUNCTION(SceneInstantiateXML), asCALL_CDECL_OBJLAST);
     engine->RegisterObjectMethod("Scene", "Node@+ InstantiateXML(XMLFile@+, const Vector3&in, const Quaternion&in, CreateMode mode = REPLICATED)", asFUNCTION(SceneInstantiateXMLFile), asCALL_CDECL_OBJLAST);
     engine->RegisterObjectMethod("Scene", "Node@+ InstantiateXML(const XMLElement&in, const Vector3&in, const Quaternion&in, CreateMode mode = REPLICATED)", asMETHODPR(Scene, InstantiateXML, (const XMLElement&, const Vector3&, const Quaternion&, CreateMode), Node*), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Scene", "Node@+ Instantiate(PrefabTemplate@+, const Vector3&in, const Quaternion&in, CreateMode mode = REPLICATED)", asMETHODPR(Scene, Instantiate, (PrefabTemplate*, const Vector3&, const Quaternion&, CreateMode), Node*), asCALL_THISCALL);
     engine->RegisterObjectMethod("Scene", "void Clear()", asMETHOD(Scene, Clear), asCALL_THISCALL);
     engine->RegisterObjectMethod("Scene", "void AddRequiredPackageFile(PackageFile@+)", asMETHOD(Scene, AddRequiredPackageFile), asCALL_THISCALL);
     engine->RegisterObjectMethod("Scene", "void ClearRequiredPackageFiles()", asMETHOD(Scene, ClearRequiredPackageFiles), asCALL_THISCALL);
@@ -179,6 +193,8 @@ static void RegisterScene(asIScriptEngine* engine)
     engine->RegisterObjectMethod("Scene", "Node@+ GetNode(uint)", asMETHOD(Scene, GetNode), asCALL_THISCALL);
     engine->RegisterObjectMethod("Scene", "const String& GetVarName(ShortStringHash) const", asMETHOD(Scene, GetVarName), asCALL_THISCALL);
     engine->RegisterObjectMethod("Scene", "void Update(float)", asMETHOD(Scene, Update), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Scene", "void UpdateTransforms()", asMETHOD(Scene, UpdateTransforms), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Scene", "void NotifyMarkedDirty()", asMETHOD(Scene, NotifyMarkedDirty), asCALL_THISCALL);
     engine->RegisterObjectMethod("Scene", "void set_active(bool)", asMETHOD(Scene, SetActive), asCALL_THISCALL);
     engine->RegisterObjectMethod("Scene", "bool get_active() const", asMETHOD(Scene, IsActive), asCALL_THISCALL);
     engine->RegisterObjectMethod("Scene", "void set_timeScale(float)", asMETHOD(Scene, SetTimeScale), asCALL_THISCALL);
@@ -189,6 +205,12 @@ static void RegisterScene(asIScriptEngine* engine)
     engine->RegisterObjectMethod("Scene", "float get_smoothingConstant() const", asMETHOD(Scene, GetSmoothingConstant), asCALL_THISCALL);
     engine->RegisterObjectMethod("Scene", "void set_snapThreshold(float)", asMETHOD(Scene, SetSnapThreshold), asCALL_THISCALL);
     engine->RegisterObjectMethod("Scene", "float get_snapThreshold() const", asMETHOD(Scene, GetSnapThreshold), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Scene", "void set_batchedTransforms(bool)", asMETHOD(Scene, SetBatchedTransforms), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Scene", "bool get_batchedTransforms() const", asMETHOD(Scene, GetBatchedTransforms), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Scene", "void set_deferredMarkedDirty(bool)", asMETHOD(Scene, SetDeferredMarkedDirty), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Scene", "bool get_deferredMarkedDirty() const", asMETHOD(Scene, GetDeferredMarkedDirty), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Scene", "void set_threadedLoading(bool)", asMETHOD(Scene, SetThreadedLoading), asCALL_THISCALL);
+    engine->RegisterObjectMethod("Scene", "bool get_threadedLoading() const", asMETHOD(Scene, GetThreadedLoading), asCALL_THISCALL);
     engine->RegisterObjectMethod("Scene", "bool get_asyncLoading() const", asMETHOD(Scene, IsAsyncLoading), asCALL_THISCALL);
     engine->RegisterObjectMethod("Scene", "float get_asyncProgress() const", asMETHOD(Scene, GetAsyncProgress), asCALL_THISCALL);
     engine->RegisterObjectMethod("Scene", "uint get_checksum() const", asMETHOD(Scene, GetChecksum), asCALL_THISCALL);
@@ -208,6 +230,7 @@ void RegisterSceneAPI(asIScriptEngine* engine)
     RegisterSerializable(engine);
     RegisterNode(engine);
     RegisterSmoothedTransform(engine);
+    RegisterPrefabTemplate(engine);
     RegisterScene(engine);
 }
 
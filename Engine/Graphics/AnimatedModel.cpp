@@ -116,6 +116,15 @@ bool AnimatedModel::LoadXML(const XMLElement& source)
     return success;
 }
 
+bool AnimatedModel::LoadValues(const Vector<Variant>& values)
+{
+    loading_ = true;
+    bool success = Component::LoadValues(values);
+    loading_ = false;
+    
+    return success;
+}
+
 void AnimatedModel::ApplyAttributes()
 {
     if (assignBonesPending_)
@@ -51,6 +51,8 @@ public:
     virtual bool Load(Deserializer& source);
     /// Load from XML data. Return true if successful.
     virtual bool LoadXML(const XMLElement& source);
+    /// Load from attribute values decoded in advance. Return true if successful.
+    virtual bool LoadValues(const Vector<Variant>& values);
     /// Apply attribute changes that can not be applied immediately. Called after scene load or a network update.
     virtual void ApplyAttributes();
     /// Process octree raycast. May be called from a worker thread.
@@ -199,8 +201,8 @@ private:
     Vector<PODVector<unsigned> > geometryBoneMappings_;
     /// Subgeometry skinning matrices, used if more bones than skinning shader can manage.
     Vector<PODVector<Matrix3x4> > geometrySkinMatrices_;
-    /// Subgeometry skinning matrix pointers, if more bones than skinning shader can manage.
-    Vector<PODVector<Matrix3x4*> > geometrySkinMatrixPtrs_;
+    /// Subgeometry skinning matrix pointers, if more bones than skinning shader can manage. A bone is usually used by one or two subgeometries, so the pointers are stored inline.
+    Vector<SmallVector<Matrix3x4*, 2> > geometrySkinMatrixPtrs_;
    /// Attribute buffer.
     mutable VectorBuffer attrBuffer_;
     /// The frame number animation LOD distance was last calculated on.
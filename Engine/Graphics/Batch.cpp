@@ -43,33 +43,24 @@
 namespace Urho3D
 {
 
-inline bool CompareBatchesState(Batch* lhs, Batch* rhs)
+inline unsigned long long GetBatchStateKey(Batch* const& batch)
 {
-    if (lhs->sortKey_ != rhs->sortKey_)
-        return lhs->sortKey_ < rhs->sortKey_;
-    else
-        return lhs->distance_ < rhs->distance_;
+    return batch->sortKey_;
 }
 
-inline bool CompareBatchesFrontToBack(Batch* lhs, Batch* rhs)
+inline unsigned GetBatchFrontToBackKey(Batch* const& batch)
 {
-    if (lhs->distance_ != rhs->distance_)
-        return lhs->distance_ < rhs->distance_;
-    else
-        return lhs->sortKey_ < rhs->sortKey_;
+    return FloatRadixKey(batch->distance_);
 }
 
-inline bool CompareBatchesBackToFront(Batch* lhs, Batch* rhs)
+inline unsigned GetBatchBackToFrontKey(Batch* const& batch)
 {
-    if (lhs->distance_ != rhs->distance_)
-        return lhs->distance_ > rhs->distance_;
-    else
-        return lhs->sortKey_ < rhs->sortKey_;
+    return ~FloatRadixKey(batch->distance_);
 }
 
-inline bool CompareInstancesFrontToBack(const InstanceData& lhs, const InstanceData& rhs)
+inline unsigned GetInstanceFrontToBackKey(const InstanceData& instance)
 {
-    return lhs.distance_ < rhs.distance_;
+    return FloatRadixKey(instance.distance_);
 }
 
 void CalculateShadowMatrix(Matrix4& dest, LightBatchQueue* queue, unsigned split, Renderer* renderer, const Vector3& translation)
@@ -341,7 +332,7 @@ void Batch::Prepare(View* view, bool setModelTransform) const
         if (graphics->NeedParameterUpdate(SP_VERTEXLIGHTS, lightQueue_) && graphics->HasShaderParameter(VS, VSP_VERTEXLIGHTS))
         {
             Vector4 vertexLights[MAX_VERTEX_LIGHTS * 3];
-            const PODVector<Light*>& lights = lightQueue_->vertexLights_;
+            const LightList& lights = lightQueue_->vertexLights_;
             
             for (unsigned i = 0; i < lights.Size(); ++i)
             {
@@ -741,17 +732,19 @@ void BatchQueue::SortBackToFront()
     for (unsigned i = 0; i < batches_.Size(); ++i)
         sortedBatches_[i] = &batches_[i];
     
-    Sort(sortedBatches_.Begin(), sortedBatches_.End(), CompareBatchesBackToFront);
+    // Sort by state, then stably by distance, so that batches at equal distance remain in state order
+    RadixSort(sortedBatches_.Begin(), sortedBatches_.End(), sortBuffer_, GetBatchStateKey);
+    RadixSort(sortedBatches_.Begin(), sortedBatches_.End(), sortBuffer_, GetBatchBackToFrontKey);
     
     // Do not actually sort batch groups, just list them
     sortedBaseBatchGroups_.Resize(baseBatchGroups_.Size());
     sortedBatchGroups_.Resize(batchGroups_.Size());
     
     unsigned index = 0;
-    for (HashMap<BatchGroupKey, BatchGroup>::Iterator i = baseBatchGroups_.Begin(); i != baseBatchGroups_.End(); ++i)
+    for (FlatHashMap<BatchGroupKey, BatchGroup>::Iterator i = baseBatchGroups_.Begin(); i != baseBatchGroups_.End(); ++i)
         sortedBaseBatchGroups_[index++] = &i->second_;
     index = 0;
-    for (HashMap<BatchGroupKey, BatchGroup>::Iterator i = batchGroups_.Begin(); i != batchGroups_.End(); ++i)
+    for (FlatHashMap<BatchGroupKey, BatchGroup>::Iterator i = batchGroups_.Begin(); i != batchGroups_.End(); ++i)
         sortedBatchGroups_[index++] = &i->second_;
 }
 
@@ -773,35 +766,35 @@ void BatchQueue::SortFrontToBack()
     SortFrontToBack2Pass(sortedBatches_);
     
     // Sort each group front to back
-    for (HashMap<BatchGroupKey, BatchGroup>::Iterator i = baseBatchGroups_.Begin(); i != baseBatchGroups_.End(); ++i)
+    for (FlatHashMap<BatchGroupKey, BatchGroup>::Iterator i = baseBatchGroups_.Begin(); i != baseBatchGroups_.End(); ++i)
     {
         if (i->second_.instances_.Size() <= maxSortedInstances_)
         {
-            Sort(i->second_.instances_.Begin(), i->second_.instances_.End(), CompareInstancesFrontToBack);
+            RadixSort(i->second_.instances_.Begin(), i->second_.instances_.End(), instanceSortBuffer_, GetInstanceFrontToBackKey);
             if (i->second_.instances_.Size())
                 i->second_.distance_ = i->second_.instances_[0].distance_;
         }
         else
         {
             float minDistance = M_INFINITY;
-            for (PODVector<InstanceData>::ConstIterator j = i->second_.instances_.Begin(); j != i->second_.instances_.End(); ++j)
+            for (FrameVector<InstanceData>::ConstIterator j = i->second_.instances_.Begin(); j != i->second_.instances_.End(); ++j)
                 minDistance = Min(minDistance, j->distance_);
             i->second_.distance_ = minDistance;
         }
     }
     
-    for (HashMap<BatchGroupKey, BatchGroup>::Iterator i = batchGroups_.Begin(); i != batchGroups_.End(); ++i)
+    for (FlatHashMap<BatchGroupKey, BatchGroup>::Iterator i = batchGroups_.Begin(); i != batchGroups_.End(); ++i)
     {
         if (i->second_.instances_.Size() <= maxSortedInstances_)
         {
-            Sort(i->second_.instances_.Begin(), i->second_.instances_.End(), CompareInstancesFrontToBack);
+            RadixSort(i->second_.instances_.Begin(), i->second_.instances_.End(), instanceSortBuffer_, GetInstanceFrontToBackKey);
             if (i->second_.instances_.Size())
                 i->second_.distance_ = i->second_.instances_[0].distance_;
         }
         else
         {
             float minDistance = M_INFINITY;
-            for (PODVector<InstanceData>::ConstIterator j = i->second_.instances_.Begin(); j != i->second_.instances_.End(); ++j)
+            for (FrameVector<InstanceData>::ConstIterator j = i->second_.instances_.Begin(); j != i->second_.instances_.End(); ++j)
                 minDistance = Min(minDistance, j->distance_);
             i->second_.distance_ = minDistance;
         }
@@ -811,10 +804,10 @@ void BatchQueue::SortFrontToBack()
     sortedBatchGroups_.Resize(batchGroups_.Size());
     
     unsigned index = 0;
-    for (HashMap<BatchGroupKey, BatchGroup>::Iterator i = baseBatchGroups_.Begin(); i != baseBatchGroups_.End(); ++i)
+    for (FlatHashMap<BatchGroupKey, BatchGroup>::Iterator i = baseBatchGroups_.Begin(); i != baseBatchGroups_.End(); ++i)
         sortedBaseBatchGroups_[index++] = &i->second_;
     index = 0;
-    for (HashMap<BatchGroupKey, BatchGroup>::Iterator i = batchGroups_.Begin(); i != batchGroups_.End(); ++i)
+    for (FlatHashMap<BatchGroupKey, BatchGroup>::Iterator i = batchGroups_.Begin(); i != batchGroups_.End(); ++i)
         sortedBatchGroups_[index++] = &i->second_;
     
     SortFrontToBack2Pass(reinterpret_cast<PODVector<Batch*>& >(sortedBaseBatchGroups_));
@@ -825,11 +818,14 @@ void BatchQueue::SortFrontToBack2Pass(PODVector<Batch*>& batches)
 {
     // Mobile devices likely use a tiled deferred approach, with which front-to-back sorting is irrelevant. The 2-pass
     // method is also time consuming, so just sort with state having priority
+    // The sorts are stable, so sort by the secondary key first
     #ifdef GL_ES_VERSION_2_0
-    Sort(batches.Begin(), batches.End(), CompareBatchesState);
+    RadixSort(batches.Begin(), batches.End(), sortBuffer_, GetBatchFrontToBackKey);
+    RadixSort(batches.Begin(), batches.End(), sortBuffer_, GetBatchStateKey);
     #else
     // For desktop, first sort by distance and remap shader/material/geometry IDs in the sort key
-    Sort(batches.Begin(), batches.End(), CompareBatchesFrontToBack);
+    RadixSort(batches.Begin(), batches.End(), sortBuffer_, GetBatchStateKey);
+    RadixSort(batches.Begin(), batches.End(), sortBuffer_, GetBatchFrontToBackKey);
     
     unsigned freeShaderID = 0;
     unsigned short freeMaterialID = 0;
@@ -840,7 +836,7 @@ void BatchQueue::SortFrontToBack2Pass(PODVector<Batch*>& batches)
         Batch* batch = *i;
         
         unsigned shaderID = (batch->sortKey_ >> 32);
-        HashMap<unsigned, unsigned>::ConstIterator j = shaderRemapping_.Find(shaderID);
+        FlatHashMap<unsigned, unsigned>::ConstIterator j = shaderRemapping_.Find(shaderID);
         if (j != shaderRemapping_.End())
             shaderID = j->second_;
         else
@@ -849,8 +845,8 @@ void BatchQueue::SortFrontToBack2Pass(PODVector<Batch*>& batches)
             ++freeShaderID;
         }
         
-        unsigned short materialID = (unsigned short)(batch->sortKey_ & 0xffff0000);
-        HashMap<unsigned short, unsigned short>::ConstIterator k = materialRemapping_.Find(materialID);
+        unsigned short materialID = (unsigned short)(batch->sortKey_ >> 16);
+        FlatHashMap<unsigned short, unsigned short>::ConstIterator k = materialRemapping_.Find(materialID);
         if (k != materialRemapping_.End())
             materialID = k->second_;
         else
@@ -860,7 +856,7 @@ void BatchQueue::SortFrontToBack2Pass(PODVector<Batch*>& batches)
         }
         
         unsigned short geometryID = (unsigned short)(batch->sortKey_ & 0xffff);
-        HashMap<unsigned short, unsigned short>::ConstIterator l = geometryRemapping_.Find(geometryID);
+        FlatHashMap<unsigned short, unsigned short>::ConstIterator l = geometryRemapping_.Find(geometryID);
         if (l != geometryRemapping_.End())
             geometryID = l->second_;
         else
@@ -869,23 +865,23 @@ void BatchQueue::SortFrontToBack2Pass(PODVector<Batch*>& batches)
             ++freeGeometryID;
         }
         
-        batch->sortKey_ = (((unsigned long long)shaderID) << 32) || (((unsigned long long)materialID) << 16) | geometryID;
+        batch->sortKey_ = (((unsigned long long)shaderID) << 32) | (((unsigned long long)materialID) << 16) | geometryID;
     }
     
     shaderRemapping_.Clear();
     materialRemapping_.Clear();
     geometryRemapping_.Clear();
     
-    // Finally sort again with the rewritten ID's
-    Sort(batches.Begin(), batches.End(), CompareBatchesState);
+    // Finally sort again with the rewritten ID's. Batches with the same ID's stay in distance order
+    RadixSort(batches.Begin(), batches.End(), sortBuffer_, GetBatchStateKey);
     #endif
 }
 
 void BatchQueue::SetTransforms(View* view, void* lockedData, unsigned& freeIndex)
 {
-    for (HashMap<BatchGroupKey, BatchGroup>::Iterator i = baseBatchGroups_.Begin(); i != baseBatchGroups_.End(); ++i)
+    for (FlatHashMap<BatchGroupKey, BatchGroup>::Iterator i = baseBatchGroups_.Begin(); i != baseBatchGroups_.End(); ++i)
         i->second_.SetTransforms(view, lockedData, freeIndex);
-    for (HashMap<BatchGroupKey, BatchGroup>::Iterator i = batchGroups_.Begin(); i != batchGroups_.End(); ++i)
+    for (FlatHashMap<BatchGroupKey, BatchGroup>::Iterator i = batchGroups_.Begin(); i != batchGroups_.End(); ++i)
         i->second_.SetTransforms(view, lockedData, freeIndex);
 }
 
@@ -1002,12 +998,12 @@ unsigned BatchQueue::GetNumInstances() const
 {
     unsigned total = 0;
     
-    for (HashMap<BatchGroupKey, BatchGroup>::ConstIterator i = baseBatchGroups_.Begin(); i != baseBatchGroups_.End(); ++i)
+    for (FlatHashMap<BatchGroupKey, BatchGroup>::ConstIterator i = baseBatchGroups_.Begin(); i != baseBatchGroups_.End(); ++i)
     {
         if (i->second_.geometryType_ == GEOM_INSTANCED)
             total += i->second_.instances_.Size();
     }
-    for (HashMap<BatchGroupKey, BatchGroup>::ConstIterator i = batchGroups_.Begin(); i != batchGroups_.End(); ++i)
+    for (FlatHashMap<BatchGroupKey, BatchGroup>::ConstIterator i = batchGroups_.Begin(); i != batchGroups_.End(); ++i)
     {
        if (i->second_.geometryType_ == GEOM_INSTANCED)
             total += i->second_.instances_.Size();
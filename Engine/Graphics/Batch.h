@@ -23,6 +23,8 @@
 #pragma once
 
 #include "Drawable.h"
+#include "FlatHashMap.h"
+#include "FrameAllocator.h"
 #include "MathDefs.h"
 #include "Ptr.h"
 #include "Rect.h"
@@ -160,8 +162,8 @@ struct BatchGroup : public Batch
     /// Prepare and draw.
     void Draw(View* view) const;
     
-    /// Instance data.
-    PODVector<InstanceData> instances_;
+    /// Instance data. Allocated from the renderer's frame allocator.
+    FrameVector<InstanceData> instances_;
     /// Instance stream start index, or M_MAX_UNSIGNED if transforms not pre-set.
     unsigned startIndex_;
 };
@@ -228,15 +230,15 @@ public:
     bool IsEmpty() const { return batches_.Empty() && baseBatchGroups_.Empty() && batchGroups_.Empty(); }
     
     /// Instanced draw calls with base flag.
-    HashMap<BatchGroupKey, BatchGroup> baseBatchGroups_;
+    FlatHashMap<BatchGroupKey, BatchGroup> baseBatchGroups_;
     /// Instanced draw calls.
-    HashMap<BatchGroupKey, BatchGroup> batchGroups_;
+    FlatHashMap<BatchGroupKey, BatchGroup> batchGroups_;
     /// Shader remapping table for 2-pass state and distance sort.
-    HashMap<unsigned, unsigned> shaderRemapping_;
+    FlatHashMap<unsigned, unsigned> shaderRemapping_;
     /// Material remapping table for 2-pass state and distance sort.
-    HashMap<unsigned short, unsigned short> materialRemapping_;
+    FlatHashMap<unsigned short, unsigned short> materialRemapping_;
     /// Geometry remapping table for 2-pass state and distance sort.
-    HashMap<unsigned short, unsigned short> geometryRemapping_;
+    FlatHashMap<unsigned short, unsigned short> geometryRemapping_;
     
     /// Unsorted non-instanced draw calls.
     PODVector<Batch> batches_;
@@ -248,6 +250,10 @@ public:
     PODVector<BatchGroup*> sortedBaseBatchGroups_;
     /// Sorted instanced draw calls.
     PODVector<BatchGroup*> sortedBatchGroups_;
+    /// Radix sort buffer for draw calls.
+    PODVector<Batch*> sortBuffer_;
+    /// Radix sort buffer for instances.
+    PODVector<InstanceData> instanceSortBuffer_;
     /// Maximum sorted instances.
     unsigned maxSortedInstances_;
 };
@@ -279,7 +285,7 @@ struct LightBatchQueue
     /// Shadow map split queues.
     Vector<ShadowBatchQueue> shadowSplits_;
     /// Per-vertex lights.
-    PODVector<Light*> vertexLights_;
+    LightList vertexLights_;
     /// Light volume draw calls.
     PODVector<Batch> volumeBatches_;
 };
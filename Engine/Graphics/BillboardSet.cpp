@@ -43,9 +43,10 @@ namespace Urho3D
 
 static const float INV_SQRT_TWO = 1.0f / sqrtf(2.0f);
 
-inline bool CompareBillboards(Billboard* lhs, Billboard* rhs)
+inline unsigned GetBillboardSortKey(Billboard* const& billboard)
 {
-    return lhs->sortDistance_ > rhs->sortDistance_;
+    // Sort back to front
+    return ~FloatRadixKey(billboard->sortDistance_);
 }
 
 OBJECTTYPESTATIC(BillboardSet);
@@ -416,7 +417,7 @@ void BillboardSet::UpdateVertexBuffer(const FrameInfo& frame)
         return;
     
     if (sorted_)
-        Sort(sortedBillboards_.Begin(), sortedBillboards_.End(), CompareBillboards);
+        RadixSort(sortedBillboards_.Begin(), sortedBillboards_.End(), sortBuffer_, GetBillboardSortKey);
     
     float* dest = (float*)vertexBuffer_->Lock(0, enabledBillboards * 4, true);
     if (!dest)
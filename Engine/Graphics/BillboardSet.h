@@ -160,6 +160,8 @@ private:
     Vector3 previousOffset_;
     /// Billboard pointers for sorting.
     Vector<Billboard*> sortedBillboards_;
+    /// Radix sort buffer for billboards.
+    PODVector<Billboard*> sortBuffer_;
     /// Attribute buffer for network replication.
     mutable VectorBuffer attrBuffer_;
 };
@@ -25,6 +25,7 @@
 #include "BoundingBox.h"
 #include "Component.h"
 #include "GraphicsDefs.h"
+#include "SmallVector.h"
 
 namespace Urho3D
 {
@@ -37,7 +38,6 @@ static const unsigned DEFAULT_VIEWMASK = M_MAX_UNSIGNED;
 static const unsigned DEFAULT_LIGHTMASK = M_MAX_UNSIGNED;
 static const unsigned DEFAULT_SHADOWMASK = M_MAX_UNSIGNED;
 static const unsigned DEFAULT_ZONEMASK = M_MAX_UNSIGNED;
-static const int DRAWABLES_PER_WORK_ITEM = 16;
 static const int MAX_VERTEX_LIGHTS = 4;
 static const float ANIMATION_LOD_BASESCALE = 2500.0f;
 
@@ -52,6 +52,9 @@ class Zone;
 struct RayQueryResult;
 struct WorkItem;
 
+/// List of lights affecting a drawable. Stored inline as there are usually only a few.
+typedef SmallVector<Light*, MAX_VERTEX_LIGHTS> LightList;
+
 /// Geometry update type.
 enum UpdateGeometryType
 {
@@ -106,7 +109,7 @@ class Drawable : public Component
     
     friend class Octant;
     friend class Octree;
-    friend void UpdateDrawablesWork(const WorkItem* item, unsigned threadIndex);
+    friend void UpdateDrawablesWork(WeakPtr<Drawable>* start, WeakPtr<Drawable>* end, unsigned threadIndex, void* userData);
     
 public:
     /// Construct.
@@ -234,9 +237,9 @@ public:
     /// Return whether has a base pass.
     bool HasBasePass(unsigned batchIndex) const { return (basePassFlags_ & (1 << batchIndex)) != 0; }
     /// Return per-pixel lights.
-    const PODVector<Light*>& GetLights() const { return lights_; }
+    const LightList& GetLights() const { return lights_; }
     /// Return per-vertex lights.
-    const PODVector<Light*>& GetVertexLights() const { return vertexLights_; }
+    const LightList& GetVertexLights() const { return vertexLights_; }
     /// Return the first added per-pixel light.
     Light* GetFirstLight() const { return firstLight_; }
     /// Return the minimum view-space depth.
@@ -313,9 +316,9 @@ protected:
     /// First per-pixel light added this frame.
     Light* firstLight_;
     /// Per-pixel lights affecting this drawable.
-    PODVector<Light*> lights_;
+    LightList lights_;
     /// Per-vertex lights affecting this drawable.
-    PODVector<Light*> vertexLights_;
+    LightList vertexLights_;
     /// Current zone.
     WeakPtr<Zone> zone_;
     /// Previous zone.
@@ -0,0 +1,1452 @@
+//
+// Copyright (c) 2008-2013 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "Precompiled.h"
+#include "AnimatedModel.h"
+#include "Animation.h"
+#include "AnimationController.h"
+#include "BillboardSet.h"
+#include "Camera.h"
+#include "Context.h"
+#include "CustomGeometry.h"
+#include "DebugRenderer.h"
+#include "DecalSet.h"
+#include "Graphics.h"
+#include "GraphicsEvents.h"
+#include "GraphicsImpl.h"
+#include "IndexBuffer.h"
+#include "Log.h"
+#include "Material.h"
+#include "Mutex.h"
+#include "Octree.h"
+#include "ParticleEmitter.h"
+#include "ProcessUtils.h"
+#include "Profiler.h"
+#include "RenderSurface.h"
+#include "Shader.h"
+#include "ShaderProgram.h"
+#include "ShaderVariation.h"
+#include "Skybox.h"
+#include "StringUtils.h"
+#include "Technique.h"
+#include "Terrain.h"
+#include "TerrainPatch.h"
+#include "Texture2D.h"
+#include "TextureCube.h"
+#include "VertexBuffer.h"
+#include "Zone.h"
+
+#include <cstring>
+
+#include "DebugNew.h"
+
+namespace Urho3D
+{
+
+static unsigned numInstances = 0;
+
+OBJECTTYPESTATIC(Graphics);
+
+Graphics::Graphics(Context* context_) :
+    Object(context_),
+    impl_(new GraphicsImpl()),
+    externalWindow_(0),
+    width_(0),
+    height_(0),
+    multiSample_(1),
+    fullscreen_(false),
+    vsync_(false),
+    tripleBuffer_(false),
+    lightPrepassSupport_(false),
+    deferredSupport_(false),
+    anisotropySupport_(false),
+    numPrimitives_(0),
+    numBatches_(0),
+    numStateChanges_(0),
+    numShaderChanges_(0),
+    numParameterUpdates_(0),
+    numTextureChanges_(0),
+    numBufferChanges_(0),
+    numRenderTargetChanges_(0),
+    numClears_(0),
+    maxScratchBufferRequest_(0),
+    shadowMapFormat_(NULL_FORMAT_DEPTH16),
+    hiresShadowMapFormat_(NULL_FORMAT_DEPTH24),
+    defaultTextureFilterMode_(FILTER_BILINEAR),
+    releasingGPUObjects_(false)
+{
+    SetTextureUnitMappings();
+    ResetCachedState();
+    
+    // If first instance in this process, initialize SDL under static mutex. The video subsystem is not needed. Note that Graphics
+    // subsystem will also be in charge of shutting down SDL as a whole, so it should be the last SDL-using subsystem (Audio and
+    // Input also use SDL) alive
+    {
+        MutexLock lock(GetStaticMutex());
+        
+        if (!numInstances)
+            SDL_Init(SDL_INIT_AUDIO | SDL_INIT_JOYSTICK | SDL_INIT_NOPARACHUTE);
+
+        ++numInstances;
+    }
+
+}
+
+Graphics::~Graphics()
+{
+    Close();
+    
+    delete impl_;
+    impl_ = 0;
+    
+    // If last instance in this process, shut down SDL under static mutex
+    {
+        MutexLock lock(GetStaticMutex());
+        
+        --numInstances;
+        if (!numInstances)
+            SDL_Quit();
+    }
+}
+
+void Graphics::SetExternalWindow(void* window)
+{
+    externalWindow_ = window;
+}
+
+void Graphics::SetWindowTitle(const String& windowTitle)
+{
+    windowTitle_ = windowTitle;
+}
+
+bool Graphics::SetMode(int width, int height, bool fullscreen, bool vsync, bool tripleBuffer, int multiSample)
+{
+    PROFILE(SetScreenMode);
+    
+    multiSample = Clamp(multiSample, 1, 16);
+    
+    if (IsInitialized() && width == width_ && height == height_ && fullscreen == fullscreen_ &&
+        vsync == vsync_ && tripleBuffer == tripleBuffer_ && multiSample == multiSample_)
+        return true;
+    
+    // If zero dimensions, set default. There is no desktop mode to use for fullscreen
+    if (!width || !height)
+    {
+        width = 800;
+        height = 600;
+    }
+    
+    // Recreate the emulated device, which marks GPU objects lost and restores them like a real screen mode change
+    Release(false, true);
+    impl_->deviceCreated_ = true;
+    ResetCachedState();
+    
+    width_ = width;
+    height_ = height;
+    fullscreen_ = fullscreen;
+    vsync_ = vsync;
+    tripleBuffer_ = tripleBuffer;
+    multiSample_ = multiSample;
+    
+    // Report the same rendering features as a typical desktop OpenGL device
+    lightPrepassSupport_ = true;
+    deferredSupport_ = true;
+    anisotropySupport_ = true;
+    
+    Restore();
+    
+    // Reset rendertargets and viewport for the new screen mode
+    ResetRenderTargets();
+    
+    LOGINFO("Set null graphics mode " + String(width_) + "x" + String(height_));
+    
+    using namespace ScreenMode;
+    
+    VariantMap eventData;
+    eventData[P_WIDTH] = width_;
+    eventData[P_HEIGHT] = height_;
+    eventData[P_FULLSCREEN] = fullscreen_;
+    SendEvent(E_SCREENMODE, eventData);
+    
+    return true;
+}
+
+bool Graphics::SetMode(int width, int height)
+{
+    return SetMode(width, height, fullscreen_, vsync_, tripleBuffer_, multiSample_);
+}
+
+bool Graphics::ToggleFullscreen()
+{
+    return SetMode(width_, height_, !fullscreen_, vsync_, tripleBuffer_, multiSample_);
+}
+
+void Graphics::Close()
+{
+    if (!IsInitialized())
+        return;
+    
+    // Release all GPU objects
+    Release(true, true);
+}
+
+bool Graphics::TakeScreenShot(Image& destImage)
+{
+    PROFILE(TakeScreenShot);
+    
+    ResetRenderTargets();
+    
+    // No pixels are rendered, so the screenshot is black
+    destImage.SetSize(width_, height_, 3);
+    memset(destImage.GetData(), 0, width_ * height_ * 3);
+    
+    return true;
+}
+
+bool Graphics::BeginFrame()
+{
+    if (!IsInitialized() || IsDeviceLost())
+        return false;
+    
+    // Set default rendertarget and depth buffer
+    ResetRenderTargets();
+    
+    // Cleanup textures from previous frame
+    for (unsigned i = 0; i < MAX_TEXTURE_UNITS; ++i)
+        SetTexture(i, 0);
+    
+    // Enable color and depth write
+    SetColorWrite(true);
+    SetDepthWrite(true);
+    
+    numPrimitives_ = 0;
+    numBatches_ = 0;
+    numStateChanges_ = 0;
+    numShaderChanges_ = 0;
+    numParameterUpdates_ = 0;
+    numTextureChanges_ = 0;
+    numBufferChanges_ = 0;
+    numRenderTargetChanges_ = 0;
+    numClears_ = 0;
+    
+    SendEvent(E_BEGINRENDERING);
+    
+    return true;
+}
+
+void Graphics::EndFrame()
+{
+    if (!IsInitialized())
+        return;
+    
+    PROFILE(Present);
+    
+    SendEvent(E_ENDRENDERING);
+    
+    // Clean up too large scratch buffers
+    CleanupScratchBuffers();
+}
+
+void Graphics::Clear(unsigned flags, const Color& color, float depth, unsigned stencil)
+{
+    if (flags & (CLEAR_COLOR | CLEAR_DEPTH | CLEAR_STENCIL))
+        ++numClears_;
+}
+
+bool Graphics::ResolveToTexture(Texture2D* destination, const IntRect& viewport)
+{
+    if (!destination || !destination->GetRenderSurface() || destination->GetWidth() != width_ ||
+        destination->GetHeight() != height_)
+        return false;
+    
+    PROFILE(ResolveToTexture);
+    
+    // Make sure the destination is not in use as a rendertarget
+    ResetRenderTargets();
+    
+    return true;
+}
+
+void Graphics::Draw(PrimitiveType type, unsigned vertexStart, unsigned vertexCount)
+{
+    if (!vertexCount)
+        return;
+    
+    unsigned primitiveCount = 0;
+    
+    switch (type)
+    {
+    case TRIANGLE_LIST:
+        primitiveCount = vertexCount / 3;
+        break;
+        
+    case LINE_LIST:
+        primitiveCount = vertexCount / 2;
+        break;
+    }
+    
+    numPrimitives_ += primitiveCount;
+    ++numBatches_;
+}
+
+void Graphics::Draw(PrimitiveType type, unsigned indexStart, unsigned indexCount, unsigned minVertex, unsigned vertexCount)
+{
+    if (!indexCount || !indexBuffer_ || !indexBuffer_->GetGPUObject())
+        return;
+    
+    unsigned primitiveCount = 0;
+    
+    switch (type)
+    {
+    case TRIANGLE_LIST:
+        primitiveCount = indexCount / 3;
+        break;
+        
+    case LINE_LIST:
+        primitiveCount = indexCount / 2;
+        break;
+    }
+    
+    numPrimitives_ += primitiveCount;
+    ++numBatches_;
+}
+
+void Graphics::DrawInstanced(PrimitiveType type, unsigned indexStart, unsigned indexCount, unsigned minVertex, unsigned vertexCount, unsigned instanceCount)
+{
+}
+
+void Graphics::SetVertexBuffer(VertexBuffer* buffer)
+{
+    Vector<VertexBuffer*> vertexBuffers(1);
+    PODVector<unsigned> elementMasks(1);
+    vertexBuffers[0] = buffer;
+    elementMasks[0] = MASK_DEFAULT;
+    SetVertexBuffers(vertexBuffers, elementMasks);
+}
+
+bool Graphics::SetVertexBuffers(const Vector<VertexBuffer*>& buffers, const PODVector<unsigned>& elementMasks,
+    unsigned instanceOffset)
+{
+    if (buffers.Size() > MAX_VERTEX_STREAMS)
+    {
+        LOGERROR("Too many vertex buffers");
+        return false;
+    }
+    if (buffers.Size() != elementMasks.Size())
+    {
+        LOGERROR("Amount of element masks and vertex buffers does not match");
+        return false;
+    }
+    
+    for (unsigned i = 0; i < MAX_VERTEX_STREAMS; ++i)
+    {
+        VertexBuffer* buffer = 0;
+        unsigned elementMask = 0;
+        
+        if (i < buffers.Size() && buffers[i])
+        {
+            buffer = buffers[i];
+            if (elementMasks[i] == MASK_DEFAULT)
+                elementMask = buffer->GetElementMask();
+            else
+                elementMask = buffer->GetElementMask() & elementMasks[i];
+        }
+        
+        if (buffer != vertexBuffers_[i] || elementMask != elementMasks_[i])
+        {
+            vertexBuffers_[i] = buffer;
+            elementMasks_[i] = elementMask;
+            ++numBufferChanges_;
+        }
+    }
+    
+    return true;
+}
+
+bool Graphics::SetVertexBuffers(const Vector<SharedPtr<VertexBuffer> >& buffers, const PODVector<unsigned>&
+    elementMasks, unsigned instanceOffset)
+{
+    if (buffers.Size() > MAX_VERTEX_STREAMS)
+    {
+        LOGERROR("Too many vertex buffers");
+        return false;
+    }
+    if (buffers.Size() != elementMasks.Size())
+    {
+        LOGERROR("Amount of element masks and vertex buffers does not match");
+        return false;
+    }
+    
+    for (unsigned i = 0; i < MAX_VERTEX_STREAMS; ++i)
+    {
+        VertexBuffer* buffer = 0;
+        unsigned elementMask = 0;
+        
+        if (i < buffers.Size() && buffers[i])
+        {
+            buffer = buffers[i];
+            if (elementMasks[i] == MASK_DEFAULT)
+                elementMask = buffer->GetElementMask();
+            else
+                elementMask = buffer->GetElementMask() & elementMasks[i];
+        }
+        
+        if (buffer != vertexBuffers_[i] || elementMask != elementMasks_[i])
+        {
+            vertexBuffers_[i] = buffer;
+            elementMasks_[i] = elementMask;
+            ++numBufferChanges_;
+        }
+    }
+    
+    return true;
+}
+
+void Graphics::SetIndexBuffer(IndexBuffer* buffer)
+{
+    if (indexBuffer_ == buffer)
+        return;
+    
+    indexBuffer_ = buffer;
+    ++numBufferChanges_;
+}
+
+void Graphics::SetShaders(ShaderVariation* vs, ShaderVariation* ps)
+{
+    if (vs == vertexShader_ && ps == pixelShader_)
+        return;
+    
+    ClearParameterSources();
+    ++numShaderChanges_;
+    
+    // Compile the shaders now if not yet compiled. If already attempted, do not retry
+    if (vs && !vs->IsCompiled())
+    {
+        if (vs->GetCompilerOutput().Empty())
+        {
+            PROFILE(CompileVertexShader);
+            
+            bool success = vs->Create();
+            if (success)
+                LOGDEBUG("Compiled vertex shader " + vs->GetName());
+            else
+            {
+                LOGERROR("Failed to compile vertex shader " + vs->GetName() + ":\n" + vs->GetCompilerOutput());
+                vs = 0;
+            }
+        }
+        else
+            vs = 0;
+    }
+    
+    if (ps && !ps->IsCompiled())
+    {
+        if (ps->GetCompilerOutput().Empty())
+        {
+            PROFILE(CompilePixelShader);
+            
+            bool success = ps->Create();
+            if (success)
+                LOGDEBUG("Compiled pixel shader " + ps->GetName());
+            else
+            {
+                LOGERROR("Failed to compile pixel shader " + ps->GetName() + ":\n" + ps->GetCompilerOutput());
+                ps = 0;
+            }
+        }
+        else
+            ps = 0;
+    }
+    
+    if (!vs || !ps)
+    {
+        vertexShader_ = 0;
+        pixelShader_ = 0;
+        shaderProgram_ = 0;
+    }
+    else
+    {
+        vertexShader_ = vs;
+        pixelShader_ = ps;
+        
+        Pair<ShaderVariation*, ShaderVariation*> combination(vs, ps);
+        ShaderProgramMap::Iterator i = shaderPrograms_.Find(combination);
+        
+        if (i != shaderPrograms_.End())
+        {
+            // Use the existing linked program
+            if (i->second_->IsLinked())
+                shaderProgram_ = i->second_;
+            else
+                shaderProgram_ = 0;
+        }
+        else
+        {
+            // Link a new combination
+            SharedPtr<ShaderProgram> newProgram(new ShaderProgram(this, vs, ps));
+            if (newProgram->Link())
+            {
+                LOGDEBUG("Linked vertex shader " + vs->GetName() + " and pixel shader " + ps->GetName());
+                shaderProgram_ = newProgram;
+            }
+            else
+            {
+                LOGERROR("Failed to link vertex shader " + vs->GetName() + " and pixel shader " + ps->GetName() + ":\n" +
+                    newProgram->GetLinkerOutput());
+                shaderProgram_ = 0;
+            }
+            
+            shaderPrograms_[combination] = newProgram;
+        }
+    }
+}
+
+void Graphics::SetShaderParameter(StringHash param, const float* data, unsigned count)
+{
+    if (shaderProgram_ && shaderProgram_->GetParameter(param))
+        ++numParameterUpdates_;
+}
+
+void Graphics::SetShaderParameter(StringHash param, float value)
+{
+    SetShaderParameter(param, &value, 1);
+}
+
+void Graphics::SetShaderParameter(StringHash param, const Color& color)
+{
+    SetShaderParameter(param, color.Data(), 4);
+}
+
+void Graphics::SetShaderParameter(StringHash param, const Matrix3& matrix)
+{
+    SetShaderParameter(param, matrix.Data(), 9);
+}
+
+void Graphics::SetShaderParameter(StringHash param, const Vector3& vector)
+{
+    SetShaderParameter(param, vector.Data(), 3);
+}
+
+void Graphics::SetShaderParameter(StringHash param, const Matrix4& matrix)
+{
+    SetShaderParameter(param, matrix.Data(), 16);
+}
+
+void Graphics::SetShaderParameter(StringHash param, const Vector4& vector)
+{
+    SetShaderParameter(param, vector.Data(), 4);
+}
+
+void Graphics::SetShaderParameter(StringHash param, const Matrix3x4& matrix)
+{
+    SetShaderParameter(param, matrix.Data(), 12);
+}
+
+bool Graphics::NeedParameterUpdate(ShaderParameterGroup group, const void* source)
+{
+    if ((unsigned)shaderParameterSources_[group] == M_MAX_UNSIGNED || shaderParameterSources_[group] != source)
+    {
+        shaderParameterSources_[group] = source;
+        return true;
+    }
+    else
+        return false;
+}
+
+bool Graphics::HasShaderParameter(ShaderType type, StringHash param)
+{
+    return shaderProgram_ && shaderProgram_->HasParameter(param);
+    
+}
+
+bool Graphics::HasTextureUnit(TextureUnit unit)
+{
+    return shaderProgram_ && shaderProgram_->HasTextureUnit(unit);
+}
+
+
+void Graphics::ClearParameterSource(ShaderParameterGroup group)
+{
+    shaderParameterSources_[group] = (const void*)M_MAX_UNSIGNED;
+}
+
+void Graphics::ClearParameterSources()
+{
+    for (unsigned i = 0; i < MAX_SHADER_PARAMETER_GROUPS; ++i)
+        shaderParameterSources_[i] = (const void*)M_MAX_UNSIGNED;
+}
+
+void Graphics::ClearTransformSources()
+{
+    shaderParameterSources_[SP_CAMERA] = (const void*)M_MAX_UNSIGNED;
+    shaderParameterSources_[SP_OBJECTTRANSFORM] = (const void*)M_MAX_UNSIGNED;
+}
+
+void Graphics::CleanupShaderPrograms()
+{
+    // Ignore individual call from ShaderVariation instance when Graphics subsystem is in process of
+    // releasing all GPU objects or recreating GPU objects due device lost, because the Graphics subsystem
+    // will eventually erase all the shader programs afterward as part of the release process.
+    if (releasingGPUObjects_)
+        return;
+    
+    for (ShaderProgramMap::Iterator i = shaderPrograms_.Begin(); i != shaderPrograms_.End();)
+    {
+        ShaderVariation* vs = i->second_->GetVertexShader();
+        ShaderVariation* ps = i->second_->GetPixelShader();
+        
+        if (!vs || !ps || !vs->GetGPUObject() || !ps->GetGPUObject())
+            i = shaderPrograms_.Erase(i);
+        else
+            ++i;
+    }
+}
+
+void Graphics::SetTexture(unsigned index, Texture* texture)
+{
+    if (index >= MAX_TEXTURE_UNITS)
+        return;
+    
+    // Check if texture is currently bound as a rendertarget. In that case, use its backup texture, or blank if not defined
+    if (texture)
+    {
+        if (texture == viewTexture_ || (renderTargets_[0] && renderTargets_[0]->GetParentTexture() == texture))
+            texture = texture->GetBackupTexture();
+    }
+    
+    if (texture && texture->GetParametersDirty())
+        texture->UpdateParameters();
+    
+    if (textures_[index] != texture)
+    {
+        textures_[index] = texture;
+        ++numTextureChanges_;
+    }
+}
+
+void Graphics::SetTextureForUpdate(Texture* texture)
+{
+    textures_[0] = texture;
+}
+
+void Graphics::SetDefaultTextureFilterMode(TextureFilterMode mode)
+{
+    if (mode != defaultTextureFilterMode_)
+    {
+        defaultTextureFilterMode_ = mode;
+        SetTextureParametersDirty();
+    }
+}
+
+void Graphics::SetTextureAnisotropy(unsigned level)
+{
+    if (level != textureAnisotropy_)
+    {
+        textureAnisotropy_ = level;
+        SetTextureParametersDirty();
+    }
+}
+
+void Graphics::SetTextureParametersDirty()
+{
+    for (Vector<GPUObject*>::Iterator i = gpuObjects_.Begin(); i != gpuObjects_.End(); ++i)
+    {
+        Texture* texture = dynamic_cast<Texture*>(*i);
+        if (texture)
+            texture->SetParametersDirty();
+    }
+}
+
+void Graphics::ResetRenderTargets()
+{
+    for (unsigned i = 0; i < MAX_RENDERTARGETS; ++i)
+        SetRenderTarget(i, (RenderSurface*)0);
+    SetDepthStencil((RenderSurface*)0);
+    SetViewport(IntRect(0, 0, width_, height_));
+}
+
+void Graphics::ResetRenderTarget(unsigned index)
+{
+    SetRenderTarget(index, (RenderSurface*)0);
+}
+
+void Graphics::ResetDepthStencil()
+{
+    SetDepthStencil((RenderSurface*)0);
+}
+
+void Graphics::SetRenderTarget(unsigned index, RenderSurface* renderTarget)
+{
+    if (index >= MAX_RENDERTARGETS)
+        return;
+    
+    if (renderTarget != renderTargets_[index])
+    {
+        renderTargets_[index] = renderTarget;
+        
+        // If the rendertarget is also bound as a texture, replace with backup texture or null
+        if (renderTarget)
+        {
+            Texture* parentTexture = renderTarget->GetParentTexture();
+            
+            for (unsigned i = 0; i < MAX_TEXTURE_UNITS; ++i)
+            {
+                if (textures_[i] == parentTexture)
+                    SetTexture(i, textures_[i]->GetBackupTexture());
+            }
+        }
+        
+        ++numRenderTargetChanges_;
+    }
+}
+
+void Graphics::SetRenderTarget(unsigned index, Texture2D* texture)
+{
+    RenderSurface* renderTarget = 0;
+    if (texture)
+        renderTarget = texture->GetRenderSurface();
+    
+    SetRenderTarget(index, renderTarget);
+}
+
+void Graphics::SetDepthStencil(RenderSurface* depthStencil)
+{
+    // Emulate the OpenGL requirement of an own depth-stencil for rendertarget textures, so that the same depth textures
+    // get created as on a real device
+
+    if (renderTargets_[0] && !depthStencil)
+    {
+        int width = renderTargets_[0]->GetWidth();
+        int height = renderTargets_[0]->GetHeight();
+        
+        // Direct3D9 default depth-stencil can not be used when rendertarget is larger than the window.
+        // Check size similarly
+        if (width <= width_ && height <= height_)
+        {
+            int searchKey = (width << 16) | height;
+            HashMap<int, SharedPtr<Texture2D> >::Iterator i = depthTextures_.Find(searchKey);
+            if (i != depthTextures_.End())
+                depthStencil = i->second_->GetRenderSurface();
+            else
+            {
+                SharedPtr<Texture2D> newDepthTexture(new Texture2D(context_));
+                newDepthTexture->SetSize(width, height, GetDepthStencilFormat(), TEXTURE_DEPTHSTENCIL);
+                depthTextures_[searchKey] = newDepthTexture;
+                depthStencil = newDepthTexture->GetRenderSurface();
+            }
+        }
+    }
+    
+    if (depthStencil != depthStencil_)
+    {
+        depthStencil_ = depthStencil;
+        ++numRenderTargetChanges_;
+    }
+}
+
+void Graphics::SetDepthStencil(Texture2D* texture)
+{
+    RenderSurface* depthStencil = 0;
+    if (texture)
+        depthStencil = texture->GetRenderSurface();
+    
+    SetDepthStencil(depthStencil);
+}
+
+void Graphics::SetViewTexture(Texture* texture)
+{
+    viewTexture_ = texture;
+    
+    if (viewTexture_)
+    {
+        for (unsigned i = 0; i < MAX_TEXTURE_UNITS; ++i)
+        {
+            if (textures_[i] == viewTexture_)
+                SetTexture(i, textures_[i]->GetBackupTexture());
+        }
+    }
+}
+
+void Graphics::SetViewport(const IntRect& rect)
+{
+    IntVector2 rtSize = GetRenderTargetDimensions();
+    
+    IntRect rectCopy = rect;
+    
+    if (rectCopy.right_ <= rectCopy.left_)
+        rectCopy.right_ = rectCopy.left_ + 1;
+    if (rectCopy.bottom_ <= rectCopy.top_)
+        rectCopy.bottom_ = rectCopy.top_ + 1;
+    rectCopy.left_ = Clamp(rectCopy.left_, 0, rtSize.x_);
+    rectCopy.top_ = Clamp(rectCopy.top_, 0, rtSize.y_);
+    rectCopy.right_ = Clamp(rectCopy.right_, 0, rtSize.x_);
+    rectCopy.bottom_ = Clamp(rectCopy.bottom_, 0, rtSize.y_);
+    
+    viewport_ = rectCopy;
+    
+    // Disable scissor test, needs to be re-enabled by the user
+    SetScissorTest(false);
+}
+
+void Graphics::SetBlendMode(BlendMode mode)
+{
+    if (mode != blendMode_)
+    {
+        blendMode_ = mode;
+        ++numStateChanges_;
+    }
+}
+
+void Graphics::SetColorWrite(bool enable)
+{
+    if (enable != colorWrite_)
+    {
+        colorWrite_ = enable;
+        ++numStateChanges_;
+    }
+}
+
+void Graphics::SetCullMode(CullMode mode)
+{
+    if (mode != cullMode_)
+    {
+        cullMode_ = mode;
+        ++numStateChanges_;
+    }
+}
+
+void Graphics::SetDepthBias(float constantBias, float slopeScaledBias)
+{
+    if (constantBias != constantDepthBias_ || slopeScaledBias != slopeScaledDepthBias_)
+    {
+        constantDepthBias_ = constantBias;
+        slopeScaledDepthBias_ = slopeScaledBias;
+        shaderParameterSources_[SP_CAMERA] = (const void*)M_MAX_UNSIGNED;
+        ++numStateChanges_;
+    }
+}
+
+void Graphics::SetDepthTest(CompareMode mode)
+{
+    if (mode != depthTestMode_)
+    {
+        depthTestMode_ = mode;
+        ++numStateChanges_;
+    }
+}
+
+void Graphics::SetDepthWrite(bool enable)
+{
+    if (enable != depthWrite_)
+    {
+        depthWrite_ = enable;
+        ++numStateChanges_;
+    }
+}
+
+void Graphics::SetFillMode(FillMode mode)
+{
+    if (mode != fillMode_)
+    {
+        fillMode_ = mode;
+        ++numStateChanges_;
+    }
+}
+
+void Graphics::SetScissorTest(bool enable, const Rect& rect, bool borderInclusive)
+{
+    // During some light rendering loops, a full rect is toggled on/off repeatedly.
+    // Disable scissor in that case to reduce state changes
+    if (rect.min_.x_ <= 0.0f && rect.min_.y_ <= 0.0f && rect.max_.x_ >= 1.0f && rect.max_.y_ >= 1.0f)
+        enable = false;
+    
+    if (enable)
+    {
+        IntVector2 rtSize(GetRenderTargetDimensions());
+        IntVector2 viewSize(viewport_.Size());
+        IntVector2 viewPos(viewport_.left_, viewport_.top_);
+        IntRect intRect;
+        int expand = borderInclusive ? 1 : 0;
+        
+        intRect.left_ = Clamp((int)((rect.min_.x_ + 1.0f) * 0.5f * viewSize.x_) + viewPos.x_, 0, rtSize.x_ - 1);
+        intRect.top_ = Clamp((int)((-rect.max_.y_ + 1.0f) * 0.5f * viewSize.y_) + viewPos.y_, 0, rtSize.y_ - 1);
+        intRect.right_ = Clamp((int)((rect.max_.x_ + 1.0f) * 0.5f * viewSize.x_) + viewPos.x_ + expand, 0, rtSize.x_);
+        intRect.bottom_ = Clamp((int)((-rect.min_.y_ + 1.0f) * 0.5f * viewSize.y_) + viewPos.y_ + expand, 0, rtSize.y_);
+        
+        if (intRect.right_ == intRect.left_)
+            intRect.right_++;
+        if (intRect.bottom_ == intRect.top_)
+            intRect.bottom_++;
+        
+        if (intRect.right_ < intRect.left_ || intRect.bottom_ < intRect.top_)
+            enable = false;
+        
+        if (enable && scissorRect_ != intRect)
+        {
+            scissorRect_ = intRect;
+            ++numStateChanges_;
+        }
+    }
+    else
+        scissorRect_ = IntRect::ZERO;
+    
+    if (enable != scissorTest_)
+    {
+        scissorTest_ = enable;
+        ++numStateChanges_;
+    }
+}
+
+void Graphics::SetScissorTest(bool enable, const IntRect& rect)
+{
+    IntVector2 rtSize(GetRenderTargetDimensions());
+    IntVector2 viewPos(viewport_.left_, viewport_.top_);
+    
+    if (enable)
+    {
+        IntRect intRect;
+        intRect.left_ = Clamp(rect.left_ + viewPos.x_, 0, rtSize.x_ - 1);
+        intRect.top_ = Clamp(rect.top_ + viewPos.y_, 0, rtSize.y_ - 1);
+        intRect.right_ = Clamp(rect.right_ + viewPos.x_, 0, rtSize.x_);
+        intRect.bottom_ = Clamp(rect.bottom_ + viewPos.y_, 0, rtSize.y_);
+        
+        if (intRect.right_ == intRect.left_)
+            intRect.right_++;
+        if (intRect.bottom_ == intRect.top_)
+            intRect.bottom_++;
+        
+        if (intRect.right_ < intRect.left_ || intRect.bottom_ < intRect.top_)
+            enable = false;
+        
+        if (enable && scissorRect_ != intRect)
+        {
+            scissorRect_ = intRect;
+            ++numStateChanges_;
+        }
+    }
+    else
+        scissorRect_ = IntRect::ZERO;
+    
+    if (enable != scissorTest_)
+    {
+        scissorTest_ = enable;
+        ++numStateChanges_;
+    }
+}
+
+void Graphics::SetStreamFrequency(unsigned index, unsigned frequency)
+{
+}
+
+void Graphics::ResetStreamFrequencies()
+{
+}
+
+void Graphics::SetStencilTest(bool enable, CompareMode mode, StencilOp pass, StencilOp fail, StencilOp zFail, unsigned stencilRef, unsigned compareMask, unsigned writeMask)
+{
+    if (enable != stencilTest_)
+    {
+        stencilTest_ = enable;
+        ++numStateChanges_;
+    }
+    
+    if (enable)
+    {
+        if (mode != stencilTestMode_ || stencilRef != stencilRef_ || compareMask != stencilCompareMask_)
+        {
+            stencilTestMode_ = mode;
+            stencilRef_ = stencilRef;
+            stencilCompareMask_ = compareMask;
+            ++numStateChanges_;
+        }
+        if (writeMask != stencilWriteMask_)
+        {
+            stencilWriteMask_ = writeMask;
+            ++numStateChanges_;
+        }
+        if (pass != stencilPass_ || fail != stencilFail_ || zFail != stencilZFail_)
+        {
+            stencilPass_ = pass;
+            stencilFail_ = fail;
+            stencilZFail_ = zFail;
+            ++numStateChanges_;
+        }
+    }
+}
+
+void Graphics::SetForceSM2(bool enable)
+{
+}
+
+bool Graphics::IsInitialized() const
+{
+    return impl_->deviceCreated_;
+}
+
+bool Graphics::IsDeviceLost() const
+{
+    return !impl_->deviceCreated_;
+}
+
+PODVector<IntVector2> Graphics::GetResolutions() const
+{
+    // No display to query, so report only the current resolution
+    PODVector<IntVector2> ret;
+    if (IsInitialized())
+        ret.Push(IntVector2(width_, height_));
+    
+    return ret;
+}
+
+PODVector<int> Graphics::GetMultiSampleLevels() const
+{
+    PODVector<int> ret;
+    // No multisampling always supported
+    ret.Push(1);
+    /// \todo Implement properly, if possible
+    
+    return ret;
+}
+
+unsigned Graphics::GetFormat(CompressedFormat format) const
+{
+    switch (format)
+    {
+    case CF_DXT1:
+        return NULL_FORMAT_DXT1;
+        
+    case CF_DXT3:
+        return NULL_FORMAT_DXT3;
+        
+    case CF_DXT5:
+        return NULL_FORMAT_DXT5;
+        
+    default:
+        return 0;
+    }
+}
+
+
+VertexBuffer* Graphics::GetVertexBuffer(unsigned index) const
+{
+    return index < MAX_VERTEX_STREAMS ? vertexBuffers_[index] : 0;
+}
+
+TextureUnit Graphics::GetTextureUnit(const String& name)
+{
+    HashMap<String, TextureUnit>::Iterator i = textureUnits_.Find(name);
+    if (i != textureUnits_.End())
+        return i->second_;
+    else
+        return MAX_TEXTURE_UNITS;
+}
+
+const String& Graphics::GetTextureUnitName(TextureUnit unit)
+{
+    for (HashMap<String, TextureUnit>::Iterator i = textureUnits_.Begin(); i != textureUnits_.End(); ++i)
+    {
+        if (i->second_ == unit)
+            return i->first_;
+    }
+    return String::EMPTY;
+}
+
+Texture* Graphics::GetTexture(unsigned index) const
+{
+    return index < MAX_TEXTURE_UNITS ? textures_[index] : 0;
+}
+
+RenderSurface* Graphics::GetRenderTarget(unsigned index) const
+{
+    return index < MAX_RENDERTARGETS ? renderTargets_[index] : 0;
+}
+
+IntVector2 Graphics::GetRenderTargetDimensions() const
+{
+    int width, height;
+    
+    if (renderTargets_[0])
+    {
+        width = renderTargets_[0]->GetWidth();
+        height = renderTargets_[0]->GetHeight();
+    }
+    else if (depthStencil_)
+    {
+        width = depthStencil_->GetWidth();
+        height = depthStencil_->GetHeight();
+    }
+    else
+    {
+        width = width_;
+        height = height_;
+    }
+    
+    return IntVector2(width, height);
+}
+
+void Graphics::AddGPUObject(GPUObject* object)
+{
+    gpuObjects_.Push(object);
+}
+
+void Graphics::RemoveGPUObject(GPUObject* object)
+{
+    gpuObjects_.Remove(object);
+}
+
+void* Graphics::ReserveScratchBuffer(unsigned size)
+{
+    if (!size)
+        return 0;
+    
+    if (size > maxScratchBufferRequest_)
+        maxScratchBufferRequest_ = size;
+    
+    // First check for a free buffer that is large enough
+    for (Vector<ScratchBuffer>::Iterator i = scratchBuffers_.Begin(); i != scratchBuffers_.End(); ++i)
+    {
+        if (!i->reserved_ && i->size_ >= size)
+        {
+            i->reserved_ = true;
+            return i->data_.Get();
+        }
+    }
+    
+    // Then check if a free buffer can be resized
+    for (Vector<ScratchBuffer>::Iterator i = scratchBuffers_.Begin(); i != scratchBuffers_.End(); ++i)
+    {
+        if (!i->reserved_)
+        {
+            i->data_ = new unsigned char[size];
+            i->size_ = size;
+            i->reserved_ = true;
+            
+            LOGDEBUG("Resized scratch buffer to size " + String(size));
+            
+            return i->data_.Get();
+        }
+    }
+    
+    // Finally allocate a new buffer
+    ScratchBuffer newBuffer;
+    newBuffer.data_ = new unsigned char[size];
+    newBuffer.size_ = size;
+    newBuffer.reserved_ = true;
+    scratchBuffers_.Push(newBuffer);
+    return newBuffer.data_.Get();
+    
+    LOGDEBUG("Allocated scratch buffer with size " + String(size));
+}
+
+void Graphics::FreeScratchBuffer(void* buffer)
+{
+    if (!buffer)
+        return;
+    
+    for (Vector<ScratchBuffer>::Iterator i = scratchBuffers_.Begin(); i != scratchBuffers_.End(); ++i)
+    {
+        if (i->reserved_ && i->data_.Get() == buffer)
+        {
+            i->reserved_ = false;
+            return;
+        }
+    }
+    
+    LOGWARNING("Reserved scratch buffer " + ToStringHex((unsigned)buffer) + " not found");
+}
+
+void Graphics::CleanupScratchBuffers()
+{
+    for (Vector<ScratchBuffer>::Iterator i = scratchBuffers_.Begin(); i != scratchBuffers_.End(); ++i)
+    {
+        if (!i->reserved_ && i->size_ > maxScratchBufferRequest_ * 2)
+        {
+            i->data_ = maxScratchBufferRequest_ > 0 ? new unsigned char[maxScratchBufferRequest_] : 0;
+            i->size_ = maxScratchBufferRequest_;
+            
+            LOGDEBUG("Resized scratch buffer to size " + String(maxScratchBufferRequest_));
+        }
+    }
+    
+    maxScratchBufferRequest_ = 0;
+}
+
+void Graphics::Release(bool clearGPUObjects, bool closeWindow)
+{
+    if (!impl_->deviceCreated_)
+        return;
+    
+    releasingGPUObjects_ = true;
+    
+    if (clearGPUObjects)
+    {
+        // Shutting down: release all GPU objects that still exist
+        for (Vector<GPUObject*>::Iterator i = gpuObjects_.Begin(); i != gpuObjects_.End(); ++i)
+            (*i)->Release();
+        gpuObjects_.Clear();
+    }
+    else
+    {
+        // We are not shutting down, but recreating the device: mark GPU objects lost
+        for (Vector<GPUObject*>::Iterator i = gpuObjects_.Begin(); i != gpuObjects_.End(); ++i)
+            (*i)->OnDeviceLost();
+    }
+    
+    releasingGPUObjects_ = false;
+    
+    depthTextures_.Clear();
+    shaderPrograms_.Clear();
+    
+    // Do not log this message if we are exiting
+    if (!clearGPUObjects)
+        LOGINFO("Null graphics device lost");
+    
+    impl_->deviceCreated_ = false;
+}
+
+void Graphics::Restore()
+{
+    if (!impl_->deviceCreated_)
+        return;
+    
+    for (Vector<GPUObject*>::Iterator i = gpuObjects_.Begin(); i != gpuObjects_.End(); ++i)
+        (*i)->OnDeviceReset();
+}
+
+void Graphics::CleanupRenderSurface(RenderSurface* surface)
+{
+    // Framebuffer objects are not emulated, so there is nothing to clean up
+}
+
+unsigned Graphics::GetAlphaFormat()
+{
+    return NULL_FORMAT_ALPHA;
+}
+
+unsigned Graphics::GetLuminanceFormat()
+{
+    return NULL_FORMAT_LUMINANCE;
+}
+
+unsigned Graphics::GetLuminanceAlphaFormat()
+{
+    return NULL_FORMAT_LUMINANCE_ALPHA;
+}
+
+unsigned Graphics::GetRGBFormat()
+{
+    return NULL_FORMAT_RGB;
+}
+
+unsigned Graphics::GetRGBAFormat()
+{
+    return NULL_FORMAT_RGBA;
+}
+
+unsigned Graphics::GetRGBA16Format()
+{
+    return NULL_FORMAT_RGBA16;
+}
+
+unsigned Graphics::GetRGBAFloat16Format()
+{
+    return NULL_FORMAT_RGBA16F;
+}
+
+unsigned Graphics::GetRGBAFloat32Format()
+{
+    return NULL_FORMAT_RGBA32F;
+}
+
+unsigned Graphics::GetRG16Format()
+{
+    return NULL_FORMAT_RG16;
+}
+
+unsigned Graphics::GetRGFloat16Format()
+{
+    return NULL_FORMAT_RG16F;
+}
+
+unsigned Graphics::GetRGFloat32Format()
+{
+    return NULL_FORMAT_RG32F;
+}
+
+unsigned Graphics::GetFloat16Format()
+{
+    return NULL_FORMAT_R16F;
+}
+
+unsigned Graphics::GetFloat32Format()
+{
+    return NULL_FORMAT_R32F;
+}
+
+unsigned Graphics::GetLinearDepthFormat()
+{
+    // Like on OpenGL, encode linear depth to RGBA
+    return NULL_FORMAT_RGBA;
+}
+
+unsigned Graphics::GetDepthStencilFormat()
+{
+    return NULL_FORMAT_DEPTH24_STENCIL8;
+}
+
+unsigned Graphics::GetFormat(const String& formatName)
+{
+    String nameLower = formatName.ToLower().Trimmed();
+    
+    if (nameLower == "a")
+        return GetAlphaFormat();
+    if (nameLower == "l")
+        return GetLuminanceFormat();
+    if (nameLower == "la")
+        return GetLuminanceAlphaFormat();
+    if (nameLower == "rgb")
+        return GetRGBFormat();
+    if (nameLower == "rgba")
+        return GetRGBAFormat();
+    if (nameLower == "rgba16")
+        return GetRGBA16Format();
+    if (nameLower == "rgba16f")
+        return GetRGBAFloat16Format();
+    if (nameLower == "rgba32f")
+        return GetRGBAFloat32Format();
+    if (nameLower == "rg16")
+        return GetRG16Format();
+    if (nameLower == "rg16f")
+        return GetRGFloat16Format();
+    if (nameLower == "rg32f")
+        return GetRGFloat32Format();
+    if (nameLower == "r16f")
+        return GetFloat16Format();
+    if (nameLower == "r32f" || nameLower == "float")
+        return GetFloat32Format();
+    if (nameLower == "lineardepth" || nameLower == "depth")
+        return GetLinearDepthFormat();
+    if (nameLower == "d24s8")
+        return GetDepthStencilFormat();
+    
+    return GetRGBFormat();
+}
+
+void Graphics::ResetCachedState()
+{
+    for (unsigned i = 0; i < MAX_VERTEX_STREAMS; ++i)
+    {
+        vertexBuffers_[i] = 0;
+        elementMasks_[i] = 0;
+    }
+    
+    for (unsigned i = 0; i < MAX_TEXTURE_UNITS; ++i)
+        textures_[i] = 0;
+    
+    for (unsigned i = 0; i < MAX_RENDERTARGETS; ++i)
+        renderTargets_[i] = 0;
+    
+    depthStencil_ = 0;
+    viewTexture_ = 0;
+    viewport_ = IntRect(0, 0, 0, 0);
+    indexBuffer_ = 0;
+    vertexShader_ = 0;
+    pixelShader_ = 0;
+    shaderProgram_ = 0;
+    blendMode_ = BLEND_REPLACE;
+    textureAnisotropy_ = 1;
+    colorWrite_ = true;
+    cullMode_ = CULL_NONE;
+    constantDepthBias_ = 0.0f;
+    slopeScaledDepthBias_ = 0.0f;
+    depthTestMode_ = CMP_ALWAYS;
+    depthWrite_ = false;
+    fillMode_ = FILL_SOLID;
+    scissorTest_ = false;
+    scissorRect_ = IntRect::ZERO;
+    stencilTest_ = false;
+    stencilTestMode_ = CMP_ALWAYS;
+    stencilPass_ = OP_KEEP;
+    stencilFail_ = OP_KEEP;
+    stencilZFail_ = OP_KEEP;
+    stencilRef_ = 0;
+    stencilCompareMask_ = M_MAX_UNSIGNED;
+    stencilWriteMask_ = M_MAX_UNSIGNED;
+    
+    // Set initial state to match Direct3D
+    if (impl_->deviceCreated_)
+    {
+        SetCullMode(CULL_CCW);
+        SetDepthTest(CMP_LESSEQUAL);
+        SetDepthWrite(true);
+    }
+}
+
+void Graphics::SetTextureUnitMappings()
+{
+    textureUnits_["DiffMap"] = TU_DIFFUSE;
+    textureUnits_["DiffCubeMap"] = TU_DIFFUSE;
+    textureUnits_["NormalMap"] = TU_NORMAL;
+    textureUnits_["SpecMap"] = TU_SPECULAR;
+    textureUnits_["EmissiveMap"] = TU_EMISSIVE;
+    textureUnits_["EnvMap"] = TU_ENVIRONMENT;
+    textureUnits_["EnvCubeMap"] = TU_ENVIRONMENT;
+    textureUnits_["LightRampMap"] = TU_LIGHTRAMP;
+    textureUnits_["LightSpotMap"] = TU_LIGHTSHAPE;
+    textureUnits_["LightCubeMap"]  = TU_LIGHTSHAPE;
+    textureUnits_["ShadowMap"] = TU_SHADOWMAP;
+    textureUnits_["FaceSelectCubeMap"] = TU_FACESELECT;
+    textureUnits_["IndirectionCubeMap"] = TU_INDIRECTION;
+    textureUnits_["AlbedoBuffer"] = TU_ALBEDOBUFFER;
+    textureUnits_["NormalBuffer"] = TU_NORMALBUFFER;
+    textureUnits_["DepthBuffer"] = TU_DEPTHBUFFER;
+    textureUnits_["LightBuffer"] = TU_LIGHTBUFFER;
+}
+
+void RegisterGraphicsLibrary(Context* context)
+{
+    Animation::RegisterObject(context);
+    Material::RegisterObject(context);
+    Model::RegisterObject(context);
+    Shader::RegisterObject(context);
+    Technique::RegisterObject(context);
+    Texture2D::RegisterObject(context);
+    TextureCube::RegisterObject(context);
+    Camera::RegisterObject(context);
+    Drawable::RegisterObject(context);
+    Light::RegisterObject(context);
+    StaticModel::RegisterObject(context);
+    Skybox::RegisterObject(context);
+    AnimatedModel::RegisterObject(context);
+    AnimationController::RegisterObject(context);
+    BillboardSet::RegisterObject(context);
+    ParticleEmitter::RegisterObject(context);
+    CustomGeometry::RegisterObject(context);
+    DecalSet::RegisterObject(context);
+    Terrain::RegisterObject(context);
+    TerrainPatch::RegisterObject(context);
+    DebugRenderer::RegisterObject(context);
+    Octree::RegisterObject(context);
+    Zone::RegisterObject(context);
+}
+
+}
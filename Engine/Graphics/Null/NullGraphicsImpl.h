@@ -0,0 +1,92 @@
+//
+// Copyright (c) 2008-2013 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "Color.h"
+#include "HashMap.h"
+
+#include <SDL.h>
+
+namespace Urho3D
+{
+
+class Context;
+
+/// Texture targets of the null graphics implementation.
+enum NullTextureTarget
+{
+    NULL_TEXTURE_NONE = 0,
+    NULL_TEXTURE_2D,
+    NULL_TEXTURE_CUBE_MAP,
+    NULL_TEXTURE_CUBE_MAP_POSITIVE_X
+};
+
+/// Texture formats of the null graphics implementation.
+enum NullTextureFormat
+{
+    NULL_FORMAT_NONE = 0,
+    NULL_FORMAT_ALPHA,
+    NULL_FORMAT_LUMINANCE,
+    NULL_FORMAT_LUMINANCE_ALPHA,
+    NULL_FORMAT_RGB,
+    NULL_FORMAT_RGBA,
+    NULL_FORMAT_RGBA16,
+    NULL_FORMAT_RGBA16F,
+    NULL_FORMAT_RGBA32F,
+    NULL_FORMAT_RG16,
+    NULL_FORMAT_RG16F,
+    NULL_FORMAT_RG32F,
+    NULL_FORMAT_R16F,
+    NULL_FORMAT_R32F,
+    NULL_FORMAT_DEPTH16,
+    NULL_FORMAT_DEPTH24,
+    NULL_FORMAT_DEPTH24_STENCIL8,
+    NULL_FORMAT_DXT1,
+    NULL_FORMAT_DXT3,
+    NULL_FORMAT_DXT5
+};
+
+/// %Graphics subsystem implementation. Holds the emulated device state.
+class GraphicsImpl
+{
+    friend class Graphics;
+    
+public:
+    /// Construct.
+    GraphicsImpl();
+    /// Return the SDL window. Always null, as no window is opened.
+    SDL_Window* GetWindow() const { return window_; }
+    /// Allocate a nonzero handle for an emulated GPU object.
+    unsigned AllocateObject() { return ++lastObject_; }
+    
+private:
+    /// SDL window.
+    SDL_Window* window_;
+    /// Last allocated GPU object handle.
+    unsigned lastObject_;
+    /// Device created flag.
+    bool deviceCreated_;
+};
+
+}
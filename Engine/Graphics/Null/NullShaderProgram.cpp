@@ -0,0 +1,166 @@
+//
+// Copyright (c) 2008-2013 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "Precompiled.h"
+#include "Graphics.h"
+#include "GraphicsImpl.h"
+#include "ShaderProgram.h"
+#include "ShaderVariation.h"
+
+#include "DebugNew.h"
+
+namespace Urho3D
+{
+
+ShaderProgram::ShaderProgram(Graphics* graphics, ShaderVariation* vertexShader, ShaderVariation* pixelShader) :
+    GPUObject(graphics),
+    vertexShader_(vertexShader),
+    pixelShader_(pixelShader),
+    linked_(false)
+{
+    for (unsigned i = 0; i < MAX_TEXTURE_UNITS; ++i)
+        useTextureUnit_[i] = false;
+}
+
+ShaderProgram::~ShaderProgram()
+{
+    Release();
+}
+
+void ShaderProgram::OnDeviceLost()
+{
+    GPUObject::OnDeviceLost();
+    
+    if (graphics_ && graphics_->GetShaderProgram() == this)
+        graphics_->SetShaders(0, 0);
+    
+    linked_ = false;
+    linkerOutput_.Clear();
+}
+
+void ShaderProgram::Release()
+{
+    if (object_)
+    {
+        if (!graphics_)
+            return;
+        
+        for (unsigned i = 0; i < MAX_TEXTURE_UNITS; ++i)
+            useTextureUnit_[i] = false;
+        shaderParameters_.Clear();
+        
+        if (graphics_->GetShaderProgram() == this)
+            graphics_->SetShaders(0, 0);
+        
+        object_ = 0;
+        linked_ = false;
+        linkerOutput_.Clear();
+    }
+}
+
+bool ShaderProgram::Link()
+{
+    Release();
+    
+    if (!vertexShader_ || !pixelShader_ || !vertexShader_->GetGPUObject() || !pixelShader_->GetGPUObject())
+        return false;
+    
+    object_ = graphics_->GetImpl()->AllocateObject();
+    linked_ = true;
+    linkerOutput_.Clear();
+    
+    // Combine the uniforms referenced by both shaders
+    Vector<String> uniforms = vertexShader_->GetUniforms();
+    const Vector<String>& psUniforms = pixelShader_->GetUniforms();
+    for (unsigned i = 0; i < psUniforms.Size(); ++i)
+    {
+        if (!uniforms.Contains(psUniforms[i]))
+            uniforms.Push(psUniforms[i]);
+    }
+    
+    // Check for shader parameters and texture units
+    for (unsigned i = 0; i < uniforms.Size(); ++i)
+    {
+        const String& name = uniforms[i];
+        
+        if (name[0] == 'c')
+        {
+            // Store the constant uniform mapping
+            String paramName = name.Substring(1);
+            ShaderParameter newParam;
+            newParam.location_ = i;
+            newParam.type_ = 0;
+            shaderParameters_[StringHash(paramName)] = newParam;
+        }
+        else if (name[0] == 's')
+        {
+            int unit = graphics_->GetTextureUnit(name.Substring(1));
+            if (unit >= MAX_TEXTURE_UNITS)
+            {
+                // If texture unit name is not recognized, search for a digit in the name and use that as the unit index
+                for (unsigned j = 1; j < name.Length(); ++j)
+                {
+                    if (name[j] >= '0' && name[j] <= '9')
+                    {
+                        unit = name[j] - '0';
+                        break;
+                    }
+                }
+            }
+            
+            if (unit < MAX_TEXTURE_UNITS)
+                useTextureUnit_[unit] = true;
+        }
+
+    }
+    
+    // Rehash the parameter map to ensure minimal load factor
+    shaderParameters_.Rehash(NextPowerOfTwo(shaderParameters_.Size()));
+    
+    return true;
+}
+
+ShaderVariation* ShaderProgram::GetVertexShader() const
+{
+    return vertexShader_;
+}
+
+ShaderVariation* ShaderProgram::GetPixelShader() const
+{
+    return pixelShader_;
+}
+
+bool ShaderProgram::HasParameter(StringHash param) const
+{
+    return shaderParameters_.Find(param) != shaderParameters_.End();
+}
+
+const ShaderParameter* ShaderProgram::GetParameter(StringHash param) const
+{
+    HashMap<StringHash, ShaderParameter>::ConstIterator i = shaderParameters_.Find(param);
+    if (i != shaderParameters_.End())
+        return &i->second_;
+    else
+        return 0;
+}
+
+}
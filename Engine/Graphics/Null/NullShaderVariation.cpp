@@ -0,0 +1,168 @@
+//
+// Copyright (c) 2008-2013 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "Precompiled.h"
+#include "Graphics.h"
+#include "GraphicsImpl.h"
+#include "Shader.h"
+#include "ShaderProgram.h"
+#include "ShaderVariation.h"
+
+#include "DebugNew.h"
+
+namespace Urho3D
+{
+
+static bool IsIdentifierChar(char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+static unsigned CountReferences(const String& code, const String& name)
+{
+    unsigned count = 0;
+    unsigned pos = code.Find(name);
+    
+    while (pos != String::NPOS)
+    {
+        unsigned end = pos + name.Length();
+        if ((!pos || !IsIdentifierChar(code[pos - 1])) && (end >= code.Length() || !IsIdentifierChar(code[end])))
+            ++count;
+        pos = code.Find(name, end);
+    }
+    
+    return count;
+}
+
+ShaderVariation::ShaderVariation(Shader* owner, ShaderType type) :
+    GPUObject(owner->GetSubsystem<Graphics>()),
+    shaderType_(type),
+    sourceCodeLength_(0),
+    compiled_(false)
+{
+}
+
+ShaderVariation::~ShaderVariation()
+{
+    Release();
+}
+
+void ShaderVariation::OnDeviceLost()
+{
+    GPUObject::OnDeviceLost();
+    
+    compiled_ = false;
+    compilerOutput_.Clear();
+    
+    if (graphics_)
+        graphics_->CleanupShaderPrograms();
+}
+
+void ShaderVariation::Release()
+{
+    if (object_)
+    {
+        if (!graphics_)
+            return;
+        
+        if (shaderType_ == VS)
+        {
+            if (graphics_->GetVertexShader() == this)
+                graphics_->SetShaders(0, 0);
+        }
+        else
+        {
+            if (graphics_->GetPixelShader() == this)
+                graphics_->SetShaders(0, 0);
+        }
+        
+        object_ = 0;
+        compiled_ = false;
+        compilerOutput_.Clear();
+        uniforms_.Clear();
+        
+        graphics_->CleanupShaderPrograms();
+    }
+}
+
+bool ShaderVariation::Create()
+{
+    Release();
+    
+    if (!sourceCode_ || !sourceCodeLength_)
+        return false;
+    
+    object_ = graphics_->GetImpl()->AllocateObject();
+    
+    // There is no compiler, so instead scan the uniform declarations to let the shader program report the parameters and
+    // texture units in use. The preprocessor is not evaluated; a uniform counts as used if it is referenced anywhere besides
+    // its declaration
+    String shaderCode(sourceCode_.Get(), sourceCodeLength_);
+    Vector<String> lines = shaderCode.Split('\n');
+    
+    for (unsigned i = 0; i < lines.Size(); ++i)
+    {
+        String line = lines[i].Trimmed();
+        if (!line.StartsWith("uniform "))
+            continue;
+        
+        unsigned end = line.Find(';');
+        if (end == String::NPOS)
+            continue;
+        
+        Vector<String> tokens = line.Substring(0, end).Split(' ');
+        String name = tokens.Back();
+        unsigned index = name.Find('[');
+        if (index != String::NPOS)
+            name = name.Substring(0, index);
+        
+        if (!name.Empty() && !uniforms_.Contains(name) && CountReferences(shaderCode, name) > 1)
+            uniforms_.Push(name);
+    }
+    
+    compiled_ = true;
+    compilerOutput_.Clear();
+    return compiled_;
+
+}
+
+void ShaderVariation::SetName(const String& name)
+{
+    name_ = name;
+}
+
+void ShaderVariation::SetSourceCode(const SharedArrayPtr<char>& code, unsigned length)
+{
+    sourceCode_ = code;
+    sourceCodeLength_ = length;
+}
+
+void ShaderVariation::SetDefines(const Vector<String>& defines, const Vector<String>& defineValues)
+{
+    if (defines.Size() == defineValues.Size())
+    {
+        defines_ = defines;
+        defineValues_ = defineValues;
+    }
+}
+
+}
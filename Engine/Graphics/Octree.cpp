@@ -43,15 +43,9 @@ namespace Urho3D
 
 static const float DEFAULT_OCTREE_SIZE = 1000.0f;
 static const int DEFAULT_OCTREE_LEVELS = 8;
-static const int RAYCASTS_PER_WORK_ITEM = 4;
-
-void RaycastDrawablesWork(const WorkItem* item, unsigned threadIndex)
+void RaycastDrawablesWork(Drawable** start, Drawable** end, PODVector<RayQueryResult>& results, void* userData)
 {
-    Octree* octree = reinterpret_cast<Octree*>(item->aux_);
-    Drawable** start = reinterpret_cast<Drawable**>(item->start_);
-    Drawable** end = reinterpret_cast<Drawable**>(item->end_);
-    const RayOctreeQuery& query = *octree->rayQuery_;
-    PODVector<RayQueryResult>& results = octree->rayQueryResults_[threadIndex];
+    const RayOctreeQuery& query = *(reinterpret_cast<RayOctreeQuery*>(userData));
     
     while (start != end)
     {
@@ -61,11 +55,9 @@ void RaycastDrawablesWork(const WorkItem* item, unsigned threadIndex)
     }
 }
 
-void UpdateDrawablesWork(const WorkItem* item, unsigned threadIndex)
+void UpdateDrawablesWork(WeakPtr<Drawable>* start, WeakPtr<Drawable>* end, unsigned threadIndex, void* userData)
 {
-    const FrameInfo& frame = *(reinterpret_cast<FrameInfo*>(item->aux_));
-    WeakPtr<Drawable>* start = reinterpret_cast<WeakPtr<Drawable>*>(item->start_);
-    WeakPtr<Drawable>* end = reinterpret_cast<WeakPtr<Drawable>*>(item->end_);
+    const FrameInfo& frame = *(reinterpret_cast<FrameInfo*>(userData));
     
     while (start != end)
     {
@@ -335,10 +327,10 @@ OBJECTTYPESTATIC(Octree);
 Octree::Octree(Context* context) :
     Component(context),
     Octant(BoundingBox(-DEFAULT_OCTREE_SIZE, DEFAULT_OCTREE_SIZE), 0, 0, this),
+    rayQueryLoop_(RaycastDrawablesWork),
+    updateDrawablesLoop_(UpdateDrawablesWork),
     numLevels_(DEFAULT_OCTREE_LEVELS)
 {
-    // Resize threaded ray query intermediate result vector according to number of worker threads
-    rayQueryResults_.Resize(GetSubsystem<WorkQueue>()->GetNumThreads() + 1);
 }
 
 Octree::~Octree()
@@ -391,10 +383,14 @@ void Octree::Resize(const BoundingBox& box, unsigned numLevels)
 
 void Octree::Update(const FrameInfo& frame)
 {
+    // Deliver deferred dirty notifications so that moved drawables are queued for update and reinsertion
+    Scene* scene = GetScene();
+    if (scene)
+        scene->NotifyMarkedDirty();
+    
     UpdateDrawables(frame);
     
     // Notify drawable update being finished. Custom animation (eg. IK) can be done at this point
-    Scene* scene = GetScene();
     if (scene)
     {
         using namespace SceneDrawableUpdateFinished;
@@ -403,6 +399,7 @@ void Octree::Update(const FrameInfo& frame)
         eventData[P_SCENE] = (void*)scene;
         eventData[P_TIMESTEP] = frame.timeStep_;
         scene->SendEvent(E_SCENEDRAWABLEUPDATEFINISHED, eventData);
+        scene->NotifyMarkedDirty();
     }
     
     ReinsertDrawables(frame);
@@ -445,44 +442,15 @@ void Octree::Raycast(RayOctreeQuery& query) const
         GetDrawablesInternal(query);
     else
     {
-        // Threaded ray query: first get the drawables
-        rayQuery_ = &query;
+        // Threaded ray query: first get the drawables, then process them and merge the per-thread results
         rayQueryDrawables_.Clear();
         GetDrawablesOnlyInternal(query, rayQueryDrawables_);
         
-        // Check that amount of drawables is large enough to justify threading
-        if (rayQueryDrawables_.Size() > RAYCASTS_PER_WORK_ITEM)
+        rayQueryLoop_.Run(queue, rayQueryDrawables_.Begin(), rayQueryDrawables_.End(), &query, PODVector<RayQueryResult>());
+        for (unsigned i = 0; i < rayQueryLoop_.GetNumResults(); ++i)
         {
-            for (unsigned i = 0; i < rayQueryResults_.Size(); ++i)
-                rayQueryResults_[i].Clear();
-            
-            WorkItem item;
-            item.workFunction_ = RaycastDrawablesWork;
-            item.aux_ = const_cast<Octree*>(this);
-            
-            PODVector<Drawable*>::Iterator start = rayQueryDrawables_.Begin();
-            while (start != rayQueryDrawables_.End())
-            {
-                PODVector<Drawable*>::Iterator end = rayQueryDrawables_.End();
-                if (end - start > RAYCASTS_PER_WORK_ITEM)
-                    end = start + RAYCASTS_PER_WORK_ITEM;
-                
-                item.start_ = &(*start);
-                item.end_ = &(*end);
-                queue->AddWorkItem(item);
-                
-                start = end;
-            }
-            
-            // Merge per-thread results
-            queue->Complete(M_MAX_UNSIGNED);
-            for (unsigned i = 0; i < rayQueryResults_.Size(); ++i)
-                query.result_.Insert(query.result_.End(), rayQueryResults_[i].Begin(), rayQueryResults_[i].End());
-        }
-        else
-        {
-            for (PODVector<Drawable*>::Iterator i = rayQueryDrawables_.Begin(); i != rayQueryDrawables_.End(); ++i)
-                (*i)->ProcessRayQuery(query, query.result_);
+            const PODVector<RayQueryResult>& results = rayQueryLoop_.GetResult(i);
+            query.result_.Insert(query.result_.End(), results.Begin(), results.End());
         }
     }
     
@@ -567,25 +535,7 @@ void Octree::UpdateDrawables(const FrameInfo& frame)
     WorkQueue* queue = GetSubsystem<WorkQueue>();
     scene->BeginThreadedUpdate();
     
-    WorkItem item;
-    item.workFunction_ = UpdateDrawablesWork;
-    item.aux_ = const_cast<FrameInfo*>(&frame);
-    
-    Vector<WeakPtr<Drawable> >::Iterator start = drawableUpdates_.Begin();
-    while (start != drawableUpdates_.End())
-    {
-        Vector<WeakPtr<Drawable> >::Iterator end = drawableUpdates_.End();
-        if (end - start > DRAWABLES_PER_WORK_ITEM)
-            end = start + DRAWABLES_PER_WORK_ITEM;
-        
-        item.start_ = &(*start);
-        item.end_ = &(*end);
-        queue->AddWorkItem(item);
-        
-        start = end;
-    }
-    
-    queue->Complete(M_MAX_UNSIGNED);
+    updateDrawablesLoop_.Run(queue, drawableUpdates_.Begin(), drawableUpdates_.End(), const_cast<FrameInfo*>(&frame));
     scene->EndThreadedUpdate();
     drawableUpdates_.Clear();
 }
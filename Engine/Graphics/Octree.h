@@ -26,6 +26,7 @@
 #include "List.h"
 #include "Mutex.h"
 #include "OctreeQuery.h"
+#include "ParallelFor.h"
 
 namespace Urho3D
 {
@@ -153,8 +154,6 @@ protected:
 /// %Octree component. Should be added only to the root scene node
 class Octree : public Component, public Octant
 {
-    friend void RaycastDrawablesWork(const WorkItem* item, unsigned threadIndex);
-    
     OBJECT(Octree);
     
 public:
@@ -207,12 +206,12 @@ private:
     Vector<WeakPtr<Drawable> > drawableReinsertions_;
     /// Mutex for octree reinsertions.
     Mutex octreeMutex_;
-    /// Current threaded ray query.
-    mutable RayOctreeQuery* rayQuery_;
     /// Drawable list for threaded ray query.
     mutable PODVector<Drawable*> rayQueryDrawables_;
-    /// Threaded ray query intermediate results.
-    mutable Vector<PODVector<RayQueryResult> > rayQueryResults_;
+    /// Threaded ray query loop. Holds the per-thread intermediate results.
+    mutable ParallelReduce<Drawable*, PODVector<RayQueryResult> > rayQueryLoop_;
+    /// Threaded drawable update loop.
+    ParallelFor<WeakPtr<Drawable> > updateDrawablesLoop_;
     /// Subdivision level.
     unsigned numLevels_;
 };
@@ -28,6 +28,32 @@
 namespace Urho3D
 {
 
+template <class T> void CullDrawables(PODVector<Drawable*>& result, unsigned start, const T& volume)
+{
+    const BoundingBox* boxes[CULLING_BATCH_SIZE];
+    unsigned char inside[CULLING_BATCH_SIZE];
+    unsigned size = result.Size();
+    unsigned dest = start;
+    
+    // Test in batches and compact the result in place, so that the order of the drawables is retained
+    for (unsigned i = start; i < size; i += CULLING_BATCH_SIZE)
+    {
+        unsigned count = Min((int)(size - i), (int)CULLING_BATCH_SIZE);
+        for (unsigned j = 0; j < count; ++j)
+            boxes[j] = &result[i + j]->GetWorldBoundingBox();
+        
+        volume.IsInsideFast(boxes, count, inside);
+        
+        for (unsigned j = 0; j < count; ++j)
+        {
+            if (inside[j])
+                result[dest++] = result[i + j];
+        }
+    }
+    
+    result.Resize(dest);
+}
+
 Intersection PointOctreeQuery::TestOctant(const BoundingBox& box, bool inside)
 {
     if (inside)
@@ -60,16 +86,23 @@ Intersection SphereOctreeQuery::TestOctant(const BoundingBox& box, bool inside)
 
 void SphereOctreeQuery::TestDrawables(Drawable** start, Drawable** end, bool inside)
 {
+    unsigned first = result_.Size();
+    
     while (start != end)
     {
         Drawable* drawable = *start++;
         
         if (drawable->IsVisible() && (drawable->GetDrawableFlags() & drawableFlags_) && (drawable->GetViewMask() & viewMask_))
-        {
-            if (inside || sphere_.IsInsideFast(drawable->GetWorldBoundingBox()))
-                result_.Push(drawable);
-        }
+            result_.Push(drawable);
     }
+    
+    if (!inside)
+        CullResult(first);
+}
+
+void SphereOctreeQuery::CullResult(unsigned start)
+{
+    CullDrawables(result_, start, sphere_);
 }
 
 Intersection BoxOctreeQuery::TestOctant(const BoundingBox& box, bool inside)
@@ -104,16 +137,23 @@ Intersection FrustumOctreeQuery::TestOctant(const BoundingBox& box, bool inside)
 
 void FrustumOctreeQuery::TestDrawables(Drawable** start, Drawable** end, bool inside)
 {
+    unsigned first = result_.Size();
+    
     while (start != end)
     {
         Drawable* drawable = *start++;
         
         if (drawable->IsVisible() && (drawable->GetDrawableFlags() & drawableFlags_) && (drawable->GetViewMask() & viewMask_))
-        {
-            if (inside || frustum_.IsInsideFast(drawable->GetWorldBoundingBox()))
-                result_.Push(drawable);
-        }
+            result_.Push(drawable);
     }
+    
+    if (!inside)
+        CullResult(first);
+}
+
+void FrustumOctreeQuery::CullResult(unsigned start)
+{
+    CullDrawables(result_, start, frustum_);
 }
 
 }
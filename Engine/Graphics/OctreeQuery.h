@@ -34,6 +34,9 @@ namespace Urho3D
 class Drawable;
 class Node;
 
+/// Number of drawables to gather for a batched bounding box test.
+static const unsigned CULLING_BATCH_SIZE = 64;
+
 /// Base class for octree queries.
 class OctreeQuery
 {
@@ -101,6 +104,8 @@ public:
     virtual Intersection TestOctant(const BoundingBox& box, bool inside);
     /// Intersection test for drawables.
     virtual void TestDrawables(Drawable** start, Drawable** end, bool inside);
+    /// Remove drawables outside the sphere from the result, beginning from the index. Tests the bounding boxes in batches.
+    void CullResult(unsigned start);
     
     /// Sphere.
     Sphere sphere_;
@@ -143,6 +148,8 @@ public:
     virtual Intersection TestOctant(const BoundingBox& box, bool inside);
     /// Intersection test for drawables.
     virtual void TestDrawables(Drawable** start, Drawable** end, bool inside);
+    /// Remove drawables outside the frustum from the result, beginning from the index. Tests the bounding boxes in batches.
+    void CullResult(unsigned start);
     
     /// Frustum.
     Frustum frustum_;
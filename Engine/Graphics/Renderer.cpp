@@ -45,6 +45,7 @@
 #include "TextureCube.h"
 #include "VertexBuffer.h"
 #include "View.h"
+#include "WorkQueue.h"
 #include "XMLFile.h"
 #include "Zone.h"
 
@@ -275,6 +276,8 @@ Renderer::Renderer(Context* context) :
     numViews_(0), 
     numOcclusionBuffers_(0),
     numShadowCameras_(0),
+    frameMemoryUse_(0),
+    frameMemoryPeak_(0),
     shadersChangedFrameNumber_(M_MAX_UNSIGNED),
     specularLighting_(true),
     drawShadows_(true),
@@ -285,6 +288,7 @@ Renderer::Renderer(Context* context) :
 {
     SubscribeToEvent(E_SCREENMODE, HANDLER(Renderer, HandleScreenMode));
     SubscribeToEvent(E_GRAPHICSFEATURES, HANDLER(Renderer, HandleGraphicsFeatures));
+    SubscribeToEvent(E_ENDFRAME, HANDLER(Renderer, HandleEndFrame));
 
     // Delay SubscribeToEvent(E_RENDERUPDATE, HANDLER(Renderer, HandleRenderUpdate)) until renderer is initialized
     
@@ -580,6 +584,11 @@ void Renderer::Update(float timeStep)
     numOcclusionBuffers_ = 0;
     updatedOctrees_.Clear();
     
+    // Make sure there is a frame allocator for the main thread and each worker thread
+    unsigned numThreads = GetSubsystem<WorkQueue>()->GetNumThreads() + 1;
+    while (frameAllocators_.Size() < numThreads)
+        frameAllocators_.Push(SharedPtr<FrameAllocator>(new FrameAllocator()));
+    
     // Reload shaders now if needed
     if (shadersDirty_)
         LoadShaders();
@@ -1342,7 +1351,7 @@ const Rect& Renderer::GetLightScissor(Light* light, Camera* camera)
 {
     Pair<Light*, Camera*> combination(light, camera);
     
-    HashMap<Pair<Light*, Camera*>, Rect>::Iterator i = lightScissorCache_.Find(combination);
+    FlatHashMap<Pair<Light*, Camera*>, Rect>::Iterator i = lightScissorCache_.Find(combination);
     if (i != lightScissorCache_.End())
         return i->second_;
     
@@ -1751,4 +1760,18 @@ void Renderer::HandleRenderUpdate(StringHash eventType, VariantMap& eventData)
     Update(eventData[P_TIMESTEP].GetFloat());
 }
 
+void Renderer::HandleEndFrame(StringHash eventType, VariantMap& eventData)
+{
+    // The views' transient batch and light data is no longer needed, so reclaim all of it at once
+    frameMemoryUse_ = 0;
+    for (unsigned i = 0; i < frameAllocators_.Size(); ++i)
+    {
+        frameMemoryUse_ += frameAllocators_[i]->GetUsedMemory();
+        frameAllocators_[i]->Reset();
+    }
+    
+    if (frameMemoryUse_ > frameMemoryPeak_)
+        frameMemoryPeak_ = frameMemoryUse_;
+}
+
 }
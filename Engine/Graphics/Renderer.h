@@ -25,6 +25,8 @@
 #include "Batch.h"
 #include "Color.h"
 #include "Drawable.h"
+#include "FlatHashMap.h"
+#include "FrameAllocator.h"
 #include "HashSet.h"
 #include "Mutex.h"
 #include "Viewport.h"
@@ -288,6 +290,16 @@ public:
     ShaderVariation* GetStencilPS() const { return stencilPS_; }
     /// Return the frame update parameters.
     const FrameInfo& GetFrameInfo() { return frame_; }
+    /// Return the frame allocator of a thread (0 = main thread) for transient render data. Valid until the end of the frame.
+    FrameAllocator* GetFrameAllocator(unsigned threadIndex = 0) const
+    {
+        assert(threadIndex < frameAllocators_.Size());
+        return frameAllocators_[threadIndex];
+    }
+    /// Return frame allocator memory used by the last frame, summed over all threads.
+    unsigned GetFrameMemoryUse() const { return frameMemoryUse_; }
+    /// Return highest frame allocator memory use of a single frame, summed over all threads.
+    unsigned GetFrameMemoryPeak() const { return frameMemoryPeak_; }
     
     /// Update for rendering. Called by HandleRenderUpdate().
     void Update(float timeStep);
@@ -369,6 +381,8 @@ private:
     void HandleGraphicsFeatures(StringHash eventType, VariantMap& eventData);
     /// Handle render update event.
     void HandleRenderUpdate(StringHash eventType, VariantMap& eventData);
+    /// Handle frame end event. Reset the frame allocators.
+    void HandleEndFrame(StringHash eventType, VariantMap& eventData);
     
     /// Graphics subsystem.
     WeakPtr<Graphics> graphics_;
@@ -419,13 +433,15 @@ private:
     /// Saved status of screen buffer allocations for restoring.
     HashMap<long long, unsigned> savedScreenBufferAllocations_;
     /// Cache for light scissor queries.
-    HashMap<Pair<Light*, Camera*>, Rect> lightScissorCache_;
+    FlatHashMap<Pair<Light*, Camera*>, Rect> lightScissorCache_;
     /// Viewports.
     Vector<SharedPtr<Viewport> > viewports_;
     /// Views.
     Vector<SharedPtr<View> > views_;
     /// Octrees that have been updated during the frame.
     HashSet<Octree*> updatedOctrees_;
+    /// Per-thread frame allocators for transient render data.
+    Vector<SharedPtr<FrameAllocator> > frameAllocators_;
     /// Techniques for which missing shader error has been displayed.
     HashSet<Technique*> shaderErrorDisplayed_;
     /// Mutex for shadow camera allocation.
@@ -470,6 +486,10 @@ private:
     unsigned numPrimitives_;
     /// Number of batches (3D geometry only.)
     unsigned numBatches_;
+    /// Frame allocator memory used by the last frame.
+    unsigned frameMemoryUse_;
+    /// Highest frame allocator memory use.
+    unsigned frameMemoryPeak_;
     /// Frame number on which shaders last changed.
     unsigned shadersChangedFrameNumber_;
     /// Current stencil value for light optimization.
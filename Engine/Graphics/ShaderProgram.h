@@ -22,6 +22,8 @@
 
 #pragma once
 
-#ifdef USE_OPENGL
+#if defined(USE_NULL_GRAPHICS)
+#include "Null/NullShaderProgram.h"
+#elif defined(USE_OPENGL)
 #include "OpenGL/OGLShaderProgram.h"
 #endif
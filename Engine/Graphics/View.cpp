@@ -60,7 +60,6 @@ static const Vector3 directions[] =
     Vector3::BACK
 };
 
-static const int CHECK_DRAWABLES_PER_WORK_ITEM = 64;
 static const float LIGHT_INTENSITY_THRESHOLD = 0.001f;
 
 /// %Frustum octree query for shadowcasters.
@@ -77,17 +76,19 @@ public:
     /// Intersection test for drawables.
     virtual void TestDrawables(Drawable** start, Drawable** end, bool inside)
     {
+        unsigned first = result_.Size();
+        
         while (start != end)
         {
             Drawable* drawable = *start++;
             
             if (drawable->GetCastShadows() && drawable->IsVisible() && (drawable->GetDrawableFlags() & drawableFlags_) &&
                 (drawable->GetViewMask() & viewMask_))
-            {
-                if (inside || frustum_.IsInsideFast(drawable->GetWorldBoundingBox()))
-                    result_.Push(drawable);
-            }
+                result_.Push(drawable);
         }
+        
+        if (!inside)
+            CullResult(first);
     }
 };
 
@@ -105,6 +106,8 @@ public:
     /// Intersection test for drawables.
     virtual void TestDrawables(Drawable** start, Drawable** end, bool inside)
     {
+        unsigned first = result_.Size();
+        
         while (start != end)
         {
             Drawable* drawable = *start++;
@@ -112,11 +115,11 @@ public:
             
             if ((flags == DRAWABLE_ZONE || (flags == DRAWABLE_GEOMETRY && drawable->IsOccluder())) && drawable->IsVisible() &&
                 (drawable->GetViewMask() & viewMask_))
-            {
-                if (inside || frustum_.IsInsideFast(drawable->GetWorldBoundingBox()))
-                    result_.Push(drawable);
-            }
+                result_.Push(drawable);
         }
+        
+        if (!inside)
+            CullResult(first);
     }
 };
 
@@ -149,28 +152,31 @@ public:
     /// Intersection test for drawables. Note: drawable occlusion is performed later in worker threads.
     virtual void TestDrawables(Drawable** start, Drawable** end, bool inside)
     {
+        unsigned first = result_.Size();
+        
         while (start != end)
         {
             Drawable* drawable = *start++;
             
             if (drawable->IsVisible() && (drawable->GetDrawableFlags() & drawableFlags_) &&
                 (drawable->GetViewMask() & viewMask_))
-            {
-                if (inside || frustum_.IsInsideFast(drawable->GetWorldBoundingBox()))
-                    result_.Push(drawable);
-            }
+                result_.Push(drawable);
         }
+        
+        if (!inside)
+            CullResult(first);
     }
     
     /// Occlusion buffer.
     OcclusionBuffer* buffer_;
 };
 
-void CheckVisibilityWork(const WorkItem* item, unsigned threadIndex)
+void CheckVisibilityWork(Drawable** start, Drawable** end, unsigned threadIndex, void* userData)
 {
-    View* view = reinterpret_cast<View*>(item->aux_);
-    Drawable** start = reinterpret_cast<Drawable**>(item->start_);
-    Drawable** end = reinterpret_cast<Drawable**>(item->end_);
+    View* view = reinterpret_cast<View*>(userData);
+    #ifdef ENABLE_PROFILING
+    AutoProfileBlock profileBlock(view->GetSubsystem<Profiler>(), "CheckVisibility");
+    #endif
     OcclusionBuffer* buffer = view->occlusionBuffer_;
     const Matrix3x4& viewMatrix = view->camera_->GetInverseWorldTransform();
     Vector3 viewZ = Vector3(viewMatrix.m20_, viewMatrix.m21_, viewMatrix.m22_);
@@ -212,11 +218,9 @@ void ProcessLightWork(const WorkItem* item, unsigned threadIndex)
     view->ProcessLight(*query, threadIndex);
 }
 
-void UpdateDrawableGeometriesWork(const WorkItem* item, unsigned threadIndex)
+void UpdateDrawableGeometriesWork(Drawable** start, Drawable** end, unsigned threadIndex, void* userData)
 {
-    const FrameInfo& frame = *(reinterpret_cast<FrameInfo*>(item->aux_));
-    Drawable** start = reinterpret_cast<Drawable**>(item->start_);
-    Drawable** end = reinterpret_cast<Drawable**>(item->end_);
+    const FrameInfo& frame = *(reinterpret_cast<FrameInfo*>(userData));
     
     while (start != end)
     {
@@ -264,7 +268,9 @@ View::View(Context* context) :
     cameraZone_(0),
     farClipZone_(0),
     renderTarget_(0),
-    tempDrawables_(GetSubsystem<WorkQueue>()->GetNumThreads() + 1)  // Create octree query vector for each thread
+    tempDrawables_(GetSubsystem<WorkQueue>()->GetNumThreads() + 1),  // Create octree query vector for each thread
+    checkVisibilityLoop_(CheckVisibilityWork),
+    updateGeometriesLoop_(UpdateDrawableGeometriesWork)
 {
     frame_.camera_ = 0;
 }
@@ -412,6 +418,13 @@ void View::Update(const FrameInfo& frame)
     vertexLightQueues_.Clear();
     for (HashMap<StringHash, BatchQueue>::Iterator i = batchQueues_.Begin(); i != batchQueues_.End(); ++i)
         i->second_.Clear(maxSortedInstances);
+    // The light queues kept from the last frame refer to frame allocator memory that has since been reset
+    for (Vector<LightBatchQueue>::Iterator i = lightQueues_.Begin(); i != lightQueues_.End(); ++i)
+    {
+        i->litBatches_.Clear(maxSortedInstances);
+        for (unsigned j = 0; j < i->shadowSplits_.Size(); ++j)
+            i->shadowSplits_[j].shadowBatches_.Clear(maxSortedInstances);
+    }
     
     // Set automatic aspect ratio if required
     if (camera_->GetAutoAspectRatio())
@@ -609,27 +622,7 @@ void View::GetDrawables()
     }
     
     // Check drawable occlusion and find zones for moved drawables in worker threads
-    {
-        WorkItem item;
-        item.workFunction_ = CheckVisibilityWork;
-        item.aux_ = this;
-        
-        PODVector<Drawable*>::Iterator start = tempDrawables.Begin();
-        while (start != tempDrawables.End())
-        {
-            PODVector<Drawable*>::Iterator end = tempDrawables.End();
-            if (end - start > CHECK_DRAWABLES_PER_WORK_ITEM)
-                end = start + CHECK_DRAWABLES_PER_WORK_ITEM;
-            
-            item.start_ = &(*start);
-            item.end_ = &(*end);
-            queue->AddWorkItem(item);
-            
-            start = end;
-        }
-        
-        queue->Complete(M_MAX_UNSIGNED);
-    }
+    checkVisibilityLoop_.Run(queue, tempDrawables.Begin(), tempDrawables.End(), this);
     
     // Sort into geometries & lights, and build visible scene bounding boxes in world and view space
     sceneBox_.min_ = sceneBox_.max_ = Vector3::ZERO;
@@ -684,7 +677,7 @@ void View::GetDrawables()
 void View::GetBatches()
 {
     WorkQueue* queue = GetSubsystem<WorkQueue>();
-    PODVector<Light*> vertexLights;
+    LightList vertexLights;
     BatchQueue* alphaQueue = batchQueues_.Contains(PASS_ALPHA) ? &batchQueues_[PASS_ALPHA] : (BatchQueue*)0;
     
     // Check whether to use the lit base pass optimization
@@ -701,6 +694,7 @@ void View::GetBatches()
         PROFILE(ProcessLights);
         
         lightQueryResults_.Resize(lights_.Size());
+        lightQueryItems_.Resize(lights_.Size());
         
         WorkItem item;
         item.workFunction_ = ProcessLightWork;
@@ -712,23 +706,21 @@ void View::GetBatches()
             query.light_ = lights_[i];
             
             item.start_ = &query;
-            queue->AddWorkItem(item);
+            lightQueryItems_[i] = queue->AddWorkItem(item);
         }
-        
-        // Ensure all lights have been processed before proceeding
-        queue->Complete(M_MAX_UNSIGNED);
     }
     
-    // Build light queues and lit batches
+    // Build light queues and lit batches. Each light is handled as soon as its query has completed, so that the remaining
+    // lights are processed in worker threads meanwhile
     {
         PROFILE(GetLightBatches);
         
-        // Preallocate light queues: per-pixel lights which have lit geometries
+        // Preallocate light queues for per-pixel lights. Lights without lit geometries will not use theirs
         unsigned numLightQueues = 0;
         unsigned usedLightQueues = 0;
-        for (Vector<LightQueryResult>::ConstIterator i = lightQueryResults_.Begin(); i != lightQueryResults_.End(); ++i)
+        for (PODVector<Light*>::ConstIterator i = lights_.Begin(); i != lights_.End(); ++i)
         {
-            if (!i->light_->GetPerVertex() && i->litGeometries_.Size())
+            if (!(*i)->GetPerVertex())
                 ++numLightQueues;
         }
         
@@ -736,9 +728,10 @@ void View::GetBatches()
         maxLightsDrawables_.Clear();
         unsigned maxSortedInstances = renderer_->GetMaxSortedInstances();
         
-        for (Vector<LightQueryResult>::Iterator i = lightQueryResults_.Begin(); i != lightQueryResults_.End(); ++i)
+        for (unsigned k = 0; k < lightQueryResults_.Size(); ++k)
         {
-            LightQueryResult& query = *i;
+            queue->CompleteItem(lightQueryItems_[k]);
+            LightQueryResult& query = lightQueryResults_[k];
             
             // If light has no affected geometries, no need to process further
             if (query.litGeometries_.Empty())
@@ -784,7 +777,7 @@ void View::GetBatches()
                     FinalizeShadowCamera(shadowCamera, light, shadowQueue.shadowViewport_, query.shadowCasterBox_[j]);
                     
                     // Loop through shadow casters
-                    for (PODVector<Drawable*>::ConstIterator k = query.shadowCasters_.Begin() + query.shadowCasterBegin_[j];
+                    for (FrameVector<Drawable*>::ConstIterator k = query.shadowCasters_.Begin() + query.shadowCasterBegin_[j];
                         k < query.shadowCasters_.Begin() + query.shadowCasterEnd_[j]; ++k)
                     {
                         Drawable* drawable = *k;
@@ -822,7 +815,7 @@ void View::GetBatches()
                 }
                 
                 // Process lit geometries
-                for (PODVector<Drawable*>::ConstIterator j = query.litGeometries_.Begin(); j != query.litGeometries_.End(); ++j)
+                for (FrameVector<Drawable*>::ConstIterator j = query.litGeometries_.Begin(); j != query.litGeometries_.End(); ++j)
                 {
                     Drawable* drawable = *j;
                     drawable->AddLight(light);
@@ -855,13 +848,19 @@ void View::GetBatches()
             else
             {
                 // Add the vertex light to lit drawables. It will be processed later during base pass batch generation
-                for (PODVector<Drawable*>::ConstIterator j = query.litGeometries_.Begin(); j != query.litGeometries_.End(); ++j)
+                for (FrameVector<Drawable*>::ConstIterator j = query.litGeometries_.Begin(); j != query.litGeometries_.End(); ++j)
                 {
                     Drawable* drawable = *j;
                     drawable->AddVertexLight(light);
                 }
             }
         }
+        
+        // Remove the light queues that were not needed, and purge the completed light work. The light query results are
+        // not needed after this, and their frame allocator memory does not survive to the next frame
+        lightQueues_.Resize(usedLightQueues);
+        lightQueryResults_.Clear();
+        queue->Complete(M_MAX_UNSIGNED);
     }
     
     // Process drawables with limited per-pixel light count
@@ -873,7 +872,7 @@ void View::GetBatches()
         {
             Drawable* drawable = *i;
             drawable->LimitLights();
-            const PODVector<Light*>& lights = drawable->GetLights();
+            const LightList& lights = drawable->GetLights();
             
             for (unsigned i = 0; i < lights.Size(); ++i)
             {
@@ -896,7 +895,7 @@ void View::GetBatches()
             Zone* zone = GetZone(drawable);
             const Vector<SourceBatch>& batches = drawable->GetBatches();
             
-            const PODVector<Light*>& drawableVertexLights = drawable->GetVertexLights();
+            const LightList& drawableVertexLights = drawable->GetVertexLights();
             if (!drawableVertexLights.Empty())
                 drawable->LimitVertexLights();
             
@@ -1038,26 +1037,7 @@ void View::UpdateGeometries()
                 threadedGeometries_.Push(*i);
         }
         
-        if (threadedGeometries_.Size())
-        {
-            WorkItem item;
-            item.workFunction_ = UpdateDrawableGeometriesWork;
-            item.aux_ = const_cast<FrameInfo*>(&frame_);
-            
-            PODVector<Drawable*>::Iterator start = threadedGeometries_.Begin();
-            while (start != threadedGeometries_.End())
-            {
-                PODVector<Drawable*>::Iterator end = threadedGeometries_.End();
-                if (end - start > DRAWABLES_PER_WORK_ITEM)
-                    end = start + DRAWABLES_PER_WORK_ITEM;
-                
-                item.start_ = &(*start);
-                item.end_ = &(*end);
-                queue->AddWorkItem(item);
-                
-                start = end;
-            }
-        }
+        updateGeometriesLoop_.Start(queue, threadedGeometries_.Begin(), threadedGeometries_.End(), const_cast<FrameInfo*>(&frame_));
         
         // While the work queue is processed, update non-threaded geometries
         for (PODVector<Drawable*>::ConstIterator i = nonThreadedGeometries_.Begin(); i != nonThreadedGeometries_.End(); ++i)
@@ -1699,6 +1679,8 @@ void View::DrawOccluders(OcclusionBuffer* buffer, const PODVector<Drawable*>& oc
 
 void View::ProcessLight(LightQueryResult& query, unsigned threadIndex)
 {
+    PROFILE(ProcessLight);
+    
     Light* light = query.light_;
     LightType type = light->GetLightType();
     const Frustum& frustum = camera_->GetFrustum();
@@ -1715,7 +1697,9 @@ void View::ProcessLight(LightQueryResult& query, unsigned threadIndex)
     #endif
     // Get lit geometries. They must match the light mask and be inside the main camera frustum to be considered
     PODVector<Drawable*>& tempDrawables = tempDrawables_[threadIndex];
-    query.litGeometries_.Clear();
+    FrameAllocator* allocator = renderer_->GetFrameAllocator(threadIndex);
+    query.litGeometries_.SetAllocator(allocator);
+    query.shadowCasters_.SetAllocator(allocator);
     
     switch (type)
     {
@@ -1764,7 +1748,6 @@ void View::ProcessLight(LightQueryResult& query, unsigned threadIndex)
     SetupShadowCameras(query);
     
     // Process each split for shadow casters
-    query.shadowCasters_.Clear();
     for (unsigned i = 0; i < query.numSplits_; ++i)
     {
         Camera* shadowCamera = query.shadowCameras_[i];
@@ -2245,10 +2228,10 @@ unsigned View::GetShadowMask(Drawable* drawable)
     return drawable->GetShadowMask() & GetZone(drawable)->GetShadowMask();
 }
 
-unsigned long long View::GetVertexLightQueueHash(const PODVector<Light*>& vertexLights)
+unsigned long long View::GetVertexLightQueueHash(const LightList& vertexLights)
 {
     unsigned long long hash = 0;
-    for (PODVector<Light*>::ConstIterator i = vertexLights.Begin(); i != vertexLights.End(); ++i)
+    for (LightList::ConstIterator i = vertexLights.Begin(); i != vertexLights.End(); ++i)
         hash += (unsigned long long)(*i);
     return hash;
 }
@@ -2343,21 +2326,22 @@ void View::AddBatchToQueue(BatchQueue& batchQueue, Batch& batch, Technique* tech
     
     if (batch.geometryType_ == GEOM_INSTANCED)
     {
-        HashMap<BatchGroupKey, BatchGroup>* groups = batch.isBase_ ? &batchQueue.baseBatchGroups_ : &batchQueue.batchGroups_;
+        FlatHashMap<BatchGroupKey, BatchGroup>* groups = batch.isBase_ ? &batchQueue.baseBatchGroups_ : &batchQueue.batchGroups_;
         BatchGroupKey key(batch);
         
-        HashMap<BatchGroupKey, BatchGroup>::Iterator i = groups->Find(key);
+        FlatHashMap<BatchGroupKey, BatchGroup>::Iterator i = groups->Find(key);
         if (i == groups->End())
         {
-            // Create a new group based on the batch
+            // Create a new group based on the batch. Insert it while the instance vector is still empty, then fill the stored
+            // copy, so that the instance data is not copied into the frame allocator more than once
             renderer_->SetBatchShaders(batch, tech, allowShadows);
             BatchGroup newGroup(batch);
             newGroup.CalculateSortKey();
-            newGroup.instances_.Push(InstanceData(batch.worldTransform_, batch.distance_));
-            groups->Insert(MakePair(key, newGroup));
+            i = groups->Insert(MakePair(key, newGroup));
+            i->second_.instances_.SetAllocator(renderer_->GetFrameAllocator());
         }
-        else
-            i->second_.instances_.Push(InstanceData(batch.worldTransform_, batch.distance_));
+        
+        i->second_.instances_.Push(InstanceData(batch.worldTransform_, batch.distance_));
     }
     else
     {
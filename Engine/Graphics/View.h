@@ -26,6 +26,7 @@
 #include "HashSet.h"
 #include "List.h"
 #include "Object.h"
+#include "ParallelFor.h"
 #include "Polyhedron.h"
 
 namespace Urho3D
@@ -51,10 +52,10 @@ struct LightQueryResult
 {
     /// Light.
     Light* light_;
-    /// Lit geometries.
-    PODVector<Drawable*> litGeometries_;
-    /// Shadow casters.
-    PODVector<Drawable*> shadowCasters_;
+    /// Lit geometries. Allocated from the frame allocator of the processing thread.
+    FrameVector<Drawable*> litGeometries_;
+    /// Shadow casters. Allocated from the frame allocator of the processing thread.
+    FrameVector<Drawable*> shadowCasters_;
     /// Shadow cameras.
     Camera* shadowCameras_[MAX_LIGHT_SPLITS];
     /// Shadow caster start indices.
@@ -91,7 +92,7 @@ struct ScenePassInfo
 /// 3D rendering view. Includes the main view(s) and any auxiliary views, but not shadow cameras.
 class View : public Object
 {
-    friend void CheckVisibilityWork(const WorkItem* item, unsigned threadIndex);
+    friend void CheckVisibilityWork(Drawable** start, Drawable** end, unsigned threadIndex, void* userData);
     friend void ProcessLightWork(const WorkItem* item, unsigned threadIndex);
     
     OBJECT(View);
@@ -184,7 +185,7 @@ private:
     /// Return the drawable's shadow mask, considering also its zone.
     unsigned GetShadowMask(Drawable* drawable);
     /// Return hash code for a vertex light queue.
-    unsigned long long GetVertexLightQueueHash(const PODVector<Light*>& vertexLights);
+    unsigned long long GetVertexLightQueueHash(const LightList& vertexLights);
     /// Return material technique, considering the drawable's LOD distance.
     Technique* GetTechnique(Drawable* drawable, Material* material);
     /// Check if material should render an auxiliary view (if it has a camera attached.)
@@ -282,6 +283,8 @@ private:
     HashMap<StringHash, Texture2D*> renderTargets_;
     /// Intermediate light processing results.
     Vector<LightQueryResult> lightQueryResults_;
+    /// Work items for the light processing, used to wait for each light's results individually.
+    PODVector<WorkItem*> lightQueryItems_;
     /// Info for scene render passes defined by the renderpath.
     Vector<ScenePassInfo> scenePasses_;
     /// Per-pixel light queues.
@@ -290,6 +293,10 @@ private:
     HashMap<unsigned long long, LightBatchQueue> vertexLightQueues_;
     /// Batch queues.
     HashMap<StringHash, BatchQueue> batchQueues_;
+    /// Threaded drawable visibility check loop.
+    ParallelFor<Drawable*> checkVisibilityLoop_;
+    /// Threaded geometry update loop.
+    ParallelFor<Drawable*> updateGeometriesLoop_;
 };
 
 }
@@ -24,7 +24,8 @@
 #include "File.h"
 #include "FileSystem.h"
 #include "FileWatcher.h"
-#include "Log.h"
+#include "IOEvents.h"
+#include "Log.h"
 #include "Timer.h"
 
 #ifdef WIN32
@@ -238,6 +239,7 @@ void FileWatcher::ThreadFunction()
             0))
         {
             unsigned offset = 0;
+            String lastFileName;
             
             while (offset < bytesFilled)
             {
@@ -251,8 +253,11 @@ void FileWatcher::ThreadFunction()
                     while (src < end)
                         fileName.AppendUTF8(String::DecodeUTF16(src));
                     
+                    // If the same file is modified several times in a row, only report the first
                     fileName = GetInternalPath(fileName);
-                    AddChange(fileName);
+                    if (fileName != lastFileName)
+                        AddChange(fileName);
+                    lastFileName = fileName;
                 }
                 
                 if (!record->NextEntryOffset)
@@ -269,6 +274,7 @@ void FileWatcher::ThreadFunction()
     {
         int i = 0;
         int length = read(watchHandle_, buffer, sizeof(buffer));
+        String lastFileName;
 
         if (length < 0)
             return;
@@ -281,9 +287,12 @@ void FileWatcher::ThreadFunction()
             {
                 if (event->mask & IN_MODIFY || event->mask & IN_MOVE)
                 {
+                    // If the same file is modified several times in a row, only report the first
                     String fileName;
                     fileName = dirHandle_[event->wd] + event->name;
-                    AddChange(fileName);
+                    if (fileName != lastFileName)
+                        AddChange(fileName);
+                    lastFileName = fileName;
                 }
             }
 
@@ -292,8 +301,8 @@ void FileWatcher::ThreadFunction()
     }
 #elif defined(__APPLE__) && !defined(IOS)
     while (shouldRun_)
-    {
-        Time::Sleep(100);
+    {
+        Time::Sleep(100);
 
         String changes = ReadFileWatcher(watcher_);
         if (!changes.Empty())
@@ -309,25 +318,11 @@ void FileWatcher::ThreadFunction()
 
 void FileWatcher::AddChange(const String& fileName)
 {
-    MutexLock lock(changesMutex_);
-    
-    // If we have 2 unprocessed modifies in a row into the same file, only record the first
-    if (changes_.Empty() || changes_.Back() != fileName)
-        changes_.Push(fileName);
-}
-
-bool FileWatcher::GetNextChange(String& dest)
-{
-    MutexLock lock(changesMutex_);
+    using namespace FileChanged;
     
-    if (changes_.Empty())
-        return false;
-    else
-    {
-        dest = changes_.Front();
-        changes_.Erase(changes_.Begin());
-        return true;
-    }
+    VariantMap eventData;
+    eventData[P_FILENAME] = fileName;
+    PostEvent(E_FILECHANGED, eventData);
 }
 
 }
@@ -22,8 +22,6 @@
 
 #pragma once
 
-#include "List.h"
-#include "Mutex.h"
 #include "Object.h"
 #include "Thread.h"
 
@@ -50,10 +48,8 @@ public:
     bool StartWatching(const String& pathName, bool watchSubDirs);
     /// Stop watching the directory.
     void StopWatching();
-    /// Add a file change into the changes queue.
+    /// Post a file change event. Called from the watcher thread.
     void AddChange(const String& fileName);
-    /// Return a file change (true if was found, false if not.)
-    bool GetNextChange(String& dest);
     
     /// Return the path being watched, or empty if not watching.
     const String& GetPath() const { return path_; }
@@ -63,10 +59,6 @@ private:
     SharedPtr<FileSystem> fileSystem_;
     /// The path being watched.
     String path_;
-    /// Buffered file changes.
-    List<String> changes_;
-    /// Mutex for the change buffer.
-    Mutex changesMutex_;
     /// Watch subdirectories flag.
     bool watchSubDirs_;
 
@@ -33,4 +33,10 @@ EVENT(E_LOGMESSAGE, LogMessage)
     PARAM(P_MESSAGE, Message);              // String
 }
 
+/// A file in a watched directory has changed. Posted by FileWatcher from its thread.
+EVENT(E_FILECHANGED, FileChanged)
+{
+    PARAM(P_FILENAME, FileName);            // String
+}
+
 }
@@ -127,6 +127,27 @@ BoundingBox BoundingBox::Transformed(const Matrix3& transform) const
 
 BoundingBox BoundingBox::Transformed(const Matrix3x4& transform) const
 {
+    #ifdef URHO3D_SSE
+    __m128 minPt = _mm_set_ps(1.0f, min_.z_, min_.y_, min_.x_);
+    __m128 maxPt = _mm_set_ps(1.0f, max_.z_, max_.y_, max_.x_);
+    __m128 half = _mm_set1_ps(0.5f);
+    __m128 oldCenter = _mm_mul_ps(_mm_add_ps(minPt, maxPt), half);
+    __m128 oldEdge = _mm_mul_ps(_mm_sub_ps(maxPt, minPt), half);
+    __m128 signMask = _mm_set1_ps(-0.0f);
+    __m128 r0 = _mm_loadu_ps(&transform.m00_);
+    __m128 r1 = _mm_loadu_ps(&transform.m10_);
+    __m128 r2 = _mm_loadu_ps(&transform.m20_);
+    __m128 zero = _mm_setzero_ps();
+    __m128 newCenter = SSEHorizontalAdd(_mm_mul_ps(r0, oldCenter), _mm_mul_ps(r1, oldCenter), _mm_mul_ps(r2, oldCenter), zero);
+    __m128 newEdge = SSEHorizontalAdd(_mm_mul_ps(_mm_andnot_ps(signMask, r0), oldEdge), _mm_mul_ps(_mm_andnot_ps(signMask, r1),
+        oldEdge), _mm_mul_ps(_mm_andnot_ps(signMask, r2), oldEdge), zero);
+    float newMin[4];
+    float newMax[4];
+    _mm_storeu_ps(newMin, _mm_sub_ps(newCenter, newEdge));
+    _mm_storeu_ps(newMax, _mm_add_ps(newCenter, newEdge));
+    
+    return BoundingBox(Vector3(newMin), Vector3(newMax));
+    #else
     Vector3 newCenter = transform * Center();
     Vector3 oldEdge = Size() * 0.5f;
     Vector3 newEdge = Vector3(
@@ -136,6 +157,7 @@ BoundingBox BoundingBox::Transformed(const Matrix3x4& transform) const
     );
     
     return BoundingBox(newCenter - newEdge, newCenter + newEdge);
+    #endif
 }
 
 Rect BoundingBox::Projected(const Matrix4& projection) const
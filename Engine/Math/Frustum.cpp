@@ -169,6 +169,68 @@ Frustum Frustum::Transformed(const Matrix3x4& transform) const
     return transformed;
 }
 
+void Frustum::IsInsideFast(const BoundingBox* const* boxes, unsigned count, unsigned char* results) const
+{
+    unsigned i = 0;
+    
+    #ifdef URHO3D_SSE
+    __m128 planeData[NUM_FRUSTUM_PLANES][7];
+    for (unsigned j = 0; j < NUM_FRUSTUM_PLANES; ++j)
+    {
+        const Plane& plane = planes_[j];
+        planeData[j][0] = _mm_set1_ps(plane.normal_.x_);
+        planeData[j][1] = _mm_set1_ps(plane.normal_.y_);
+        planeData[j][2] = _mm_set1_ps(plane.normal_.z_);
+        planeData[j][3] = _mm_set1_ps(plane.absNormal_.x_);
+        planeData[j][4] = _mm_set1_ps(plane.absNormal_.y_);
+        planeData[j][5] = _mm_set1_ps(plane.absNormal_.z_);
+        planeData[j][6] = _mm_set1_ps(plane.intercept_);
+    }
+    
+    __m128 half = _mm_set1_ps(0.5f);
+    __m128 zero = _mm_setzero_ps();
+    
+    for (; i + 4 <= count; i += 4)
+    {
+        // Transpose four boxes into structure of arrays form, then test them against each plane at once
+        const BoundingBox& b0 = *boxes[i];
+        const BoundingBox& b1 = *boxes[i + 1];
+        const BoundingBox& b2 = *boxes[i + 2];
+        const BoundingBox& b3 = *boxes[i + 3];
+        __m128 minX = _mm_set_ps(b3.min_.x_, b2.min_.x_, b1.min_.x_, b0.min_.x_);
+        __m128 minY = _mm_set_ps(b3.min_.y_, b2.min_.y_, b1.min_.y_, b0.min_.y_);
+        __m128 minZ = _mm_set_ps(b3.min_.z_, b2.min_.z_, b1.min_.z_, b0.min_.z_);
+        __m128 centerX = _mm_mul_ps(_mm_add_ps(_mm_set_ps(b3.max_.x_, b2.max_.x_, b1.max_.x_, b0.max_.x_), minX), half);
+        __m128 centerY = _mm_mul_ps(_mm_add_ps(_mm_set_ps(b3.max_.y_, b2.max_.y_, b1.max_.y_, b0.max_.y_), minY), half);
+        __m128 centerZ = _mm_mul_ps(_mm_add_ps(_mm_set_ps(b3.max_.z_, b2.max_.z_, b1.max_.z_, b0.max_.z_), minZ), half);
+        __m128 edgeX = _mm_sub_ps(centerX, minX);
+        __m128 edgeY = _mm_sub_ps(centerY, minY);
+        __m128 edgeZ = _mm_sub_ps(centerZ, minZ);
+        __m128 outside = zero;
+        
+        for (unsigned j = 0; j < NUM_FRUSTUM_PLANES; ++j)
+        {
+            const __m128* plane = planeData[j];
+            __m128 dist = _mm_add_ps(_mm_add_ps(_mm_mul_ps(plane[0], centerX), _mm_mul_ps(plane[1], centerY)),
+                _mm_mul_ps(plane[2], centerZ));
+            dist = _mm_sub_ps(dist, plane[6]);
+            __m128 absDist = _mm_add_ps(_mm_add_ps(_mm_mul_ps(plane[3], edgeX), _mm_mul_ps(plane[4], edgeY)),
+                _mm_mul_ps(plane[5], edgeZ));
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(dist, _mm_sub_ps(zero, absDist)));
+        }
+        
+        int mask = _mm_movemask_ps(outside);
+        results[i] = (mask & 1) ? 0 : 1;
+        results[i + 1] = (mask & 2) ? 0 : 1;
+        results[i + 2] = (mask & 4) ? 0 : 1;
+        results[i + 3] = (mask & 8) ? 0 : 1;
+    }
+    #endif
+    
+    for (; i < count; ++i)
+        results[i] = IsInsideFast(*boxes[i]) != OUTSIDE ? 1 : 0;
+}
+
 Rect Frustum::Projected(const Matrix4& projection) const
 {
     Rect rect;
@@ -151,6 +151,9 @@ public:
         return INSIDE;
     }
     
+    /// Test bounding boxes for being (partially) inside or outside. Write 1 to results for each box that is inside and 0 for each box that is outside. Tests four boxes at a time if SSE is enabled.
+    void IsInsideFast(const BoundingBox* const* boxes, unsigned count, unsigned char* results) const;
+    
     /// Return distance of a point to the frustum, or 0 if inside.
     float Distance(const Vector3& point) const
     {
@@ -27,6 +27,12 @@
 #include <cstdlib>
 #include <cmath>
 
+// Use SSE intrinsics for the matrix, quaternion and vector operations if enabled and supported by the target
+#if defined(ENABLE_SSE) && (defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1))
+#define URHO3D_SSE
+#include <xmmintrin.h>
+#endif
+
 namespace Urho3D
 {
 
@@ -125,4 +131,31 @@ inline float Random(float range) { return Rand() * range / 32767.0f; }
 /// Return a random integer between 0 and range - 1.
 inline int Random(int range) { return (Rand() * (range - 1) + 16384) / 32767; }
 
+#ifdef URHO3D_SSE
+/// Multiply a row vector with a 4x4 matrix given as rows using SSE.
+inline __m128 SSEMultiplyRow(__m128 row, __m128 r0, __m128 r1, __m128 r2, __m128 r3)
+{
+    __m128 ret = _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(0, 0, 0, 0)), r0);
+    ret = _mm_add_ps(ret, _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(1, 1, 1, 1)), r1));
+    ret = _mm_add_ps(ret, _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(2, 2, 2, 2)), r2));
+    ret = _mm_add_ps(ret, _mm_mul_ps(_mm_shuffle_ps(row, row, _MM_SHUFFLE(3, 3, 3, 3)), r3));
+    return ret;
+}
+
+/// Return the component sums of four vectors as one vector using SSE.
+inline __m128 SSEHorizontalAdd(__m128 v0, __m128 v1, __m128 v2, __m128 v3)
+{
+    _MM_TRANSPOSE4_PS(v0, v1, v2, v3);
+    return _mm_add_ps(_mm_add_ps(v0, v1), _mm_add_ps(v2, v3));
+}
+
+/// Return the component sum of a vector using SSE.
+inline float SSEHorizontalAdd(__m128 v)
+{
+    v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+    v = _mm_add_ss(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)));
+    return _mm_cvtss_f32(v);
+}
+#endif
+
 }
@@ -185,21 +185,39 @@ public:
     /// Multiply a Vector3 which is assumed to represent position.
     Vector3 operator * (const Vector3& rhs) const
     {
+        #ifdef URHO3D_SSE
+        __m128 vec = _mm_set_ps(1.0f, rhs.z_, rhs.y_, rhs.x_);
+        __m128 ret = SSEHorizontalAdd(_mm_mul_ps(_mm_loadu_ps(&m00_), vec), _mm_mul_ps(_mm_loadu_ps(&m10_), vec),
+            _mm_mul_ps(_mm_loadu_ps(&m20_), vec), _mm_setzero_ps());
+        float data[4];
+        _mm_storeu_ps(data, ret);
+        return Vector3(data);
+        #else
         return Vector3(
             (m00_ * rhs.x_ + m01_ * rhs.y_ + m02_ * rhs.z_ + m03_),
             (m10_ * rhs.x_ + m11_ * rhs.y_ + m12_ * rhs.z_ + m13_),
             (m20_ * rhs.x_ + m21_ * rhs.y_ + m22_ * rhs.z_ + m23_)
         );
+        #endif
     }
     
     /// Multiply a Vector4.
     Vector3 operator * (const Vector4& rhs) const
     {
+        #ifdef URHO3D_SSE
+        __m128 vec = _mm_loadu_ps(&rhs.x_);
+        __m128 ret = SSEHorizontalAdd(_mm_mul_ps(_mm_loadu_ps(&m00_), vec), _mm_mul_ps(_mm_loadu_ps(&m10_), vec),
+            _mm_mul_ps(_mm_loadu_ps(&m20_), vec), _mm_setzero_ps());
+        float data[4];
+        _mm_storeu_ps(data, ret);
+        return Vector3(data);
+        #else
         return Vector3(
             (m00_ * rhs.x_ + m01_ * rhs.y_ + m02_ * rhs.z_ + m03_ * rhs.w_),
             (m10_ * rhs.x_ + m11_ * rhs.y_ + m12_ * rhs.z_ + m13_ * rhs.w_),
             (m20_ * rhs.x_ + m21_ * rhs.y_ + m22_ * rhs.z_ + m23_ * rhs.w_)
         );
+        #endif
     }
     
     /// Add a matrix.
@@ -262,6 +280,17 @@ public:
     /// Multiply a matrix.
     Matrix3x4 operator * (const Matrix3x4& rhs) const
     {
+        #ifdef URHO3D_SSE
+        __m128 r0 = _mm_loadu_ps(&rhs.m00_);
+        __m128 r1 = _mm_loadu_ps(&rhs.m10_);
+        __m128 r2 = _mm_loadu_ps(&rhs.m20_);
+        __m128 r3 = _mm_set_ps(1.0f, 0.0f, 0.0f, 0.0f);
+        Matrix3x4 ret;
+        _mm_storeu_ps(&ret.m00_, SSEMultiplyRow(_mm_loadu_ps(&m00_), r0, r1, r2, r3));
+        _mm_storeu_ps(&ret.m10_, SSEMultiplyRow(_mm_loadu_ps(&m10_), r0, r1, r2, r3));
+        _mm_storeu_ps(&ret.m20_, SSEMultiplyRow(_mm_loadu_ps(&m20_), r0, r1, r2, r3));
+        return ret;
+        #else
         return Matrix3x4(
             m00_ * rhs.m00_ + m01_ * rhs.m10_ + m02_ * rhs.m20_,
             m00_ * rhs.m01_ + m01_ * rhs.m11_ + m02_ * rhs.m21_,
@@ -276,11 +305,24 @@ public:
             m20_ * rhs.m02_ + m21_ * rhs.m12_ + m22_ * rhs.m22_,
             m20_ * rhs.m03_ + m21_ * rhs.m13_ + m22_ * rhs.m23_ + m23_
         );
+        #endif
     }
     
     /// Multiply a 4x4 matrix.
     Matrix4 operator * (const Matrix4& rhs) const
     {
+        #ifdef URHO3D_SSE
+        __m128 r0 = _mm_loadu_ps(&rhs.m00_);
+        __m128 r1 = _mm_loadu_ps(&rhs.m10_);
+        __m128 r2 = _mm_loadu_ps(&rhs.m20_);
+        __m128 r3 = _mm_loadu_ps(&rhs.m30_);
+        Matrix4 ret;
+        _mm_storeu_ps(&ret.m00_, SSEMultiplyRow(_mm_loadu_ps(&m00_), r0, r1, r2, r3));
+        _mm_storeu_ps(&ret.m10_, SSEMultiplyRow(_mm_loadu_ps(&m10_), r0, r1, r2, r3));
+        _mm_storeu_ps(&ret.m20_, SSEMultiplyRow(_mm_loadu_ps(&m20_), r0, r1, r2, r3));
+        _mm_storeu_ps(&ret.m30_, r3);
+        return ret;
+        #else
         return Matrix4(
             m00_ * rhs.m00_ + m01_ * rhs.m10_ + m02_ * rhs.m20_ + m03_ * rhs.m30_,
             m00_ * rhs.m01_ + m01_ * rhs.m11_ + m02_ * rhs.m21_ + m03_ * rhs.m31_,
@@ -299,6 +341,7 @@ public:
             rhs.m32_,
             rhs.m33_
         );
+        #endif
     }
     
     /// Set translation elements.
@@ -423,6 +466,18 @@ inline Matrix3x4 operator * (float lhs, const Matrix3x4& rhs) { return rhs * lhs
 /// Multiply a 3x4 matrix with a 4x4 matrix.
 inline Matrix4 operator * (const Matrix4& lhs, const Matrix3x4& rhs)
 {
+    #ifdef URHO3D_SSE
+    __m128 r0 = _mm_loadu_ps(&rhs.m00_);
+    __m128 r1 = _mm_loadu_ps(&rhs.m10_);
+    __m128 r2 = _mm_loadu_ps(&rhs.m20_);
+    __m128 r3 = _mm_set_ps(1.0f, 0.0f, 0.0f, 0.0f);
+    Matrix4 ret;
+    _mm_storeu_ps(&ret.m00_, SSEMultiplyRow(_mm_loadu_ps(&lhs.m00_), r0, r1, r2, r3));
+    _mm_storeu_ps(&ret.m10_, SSEMultiplyRow(_mm_loadu_ps(&lhs.m10_), r0, r1, r2, r3));
+    _mm_storeu_ps(&ret.m20_, SSEMultiplyRow(_mm_loadu_ps(&lhs.m20_), r0, r1, r2, r3));
+    _mm_storeu_ps(&ret.m30_, SSEMultiplyRow(_mm_loadu_ps(&lhs.m30_), r0, r1, r2, r3));
+    return ret;
+    #else
     return Matrix4(
         lhs.m00_ * rhs.m00_ + lhs.m01_ * rhs.m10_ + lhs.m02_ * rhs.m20_,
         lhs.m00_ * rhs.m01_ + lhs.m01_ * rhs.m11_ + lhs.m02_ * rhs.m21_,
@@ -441,6 +496,7 @@ inline Matrix4 operator * (const Matrix4& lhs, const Matrix3x4& rhs)
         lhs.m30_ * rhs.m02_ + lhs.m31_ * rhs.m12_ + lhs.m32_ * rhs.m22_,
         lhs.m30_ * rhs.m03_ + lhs.m31_ * rhs.m13_ + lhs.m32_ * rhs.m23_ + lhs.m33_
     );
+    #endif
 }
 
 }
@@ -171,6 +171,15 @@ public:
     /// Multiply a Vector3 which is assumed to represent position.
     Vector3 operator * (const Vector3& rhs) const
     {
+        #ifdef URHO3D_SSE
+        __m128 vec = _mm_set_ps(1.0f, rhs.z_, rhs.y_, rhs.x_);
+        __m128 ret = SSEHorizontalAdd(_mm_mul_ps(_mm_loadu_ps(&m00_), vec), _mm_mul_ps(_mm_loadu_ps(&m10_), vec),
+            _mm_mul_ps(_mm_loadu_ps(&m20_), vec), _mm_mul_ps(_mm_loadu_ps(&m30_), vec));
+        ret = _mm_div_ps(ret, _mm_shuffle_ps(ret, ret, _MM_SHUFFLE(3, 3, 3, 3)));
+        float data[4];
+        _mm_storeu_ps(data, ret);
+        return Vector3(data);
+        #else
         float invW = 1.0f / (m30_ * rhs.x_ + m31_ * rhs.y_ + m32_ * rhs.z_ + m33_);
         
         return Vector3(
@@ -178,17 +187,26 @@ public:
             (m10_ * rhs.x_ + m11_ * rhs.y_ + m12_ * rhs.z_ + m13_) * invW,
             (m20_ * rhs.x_ + m21_ * rhs.y_ + m22_ * rhs.z_ + m23_) * invW
         );
+        #endif
     }
     
     /// Multiply a Vector4.
     Vector4 operator * (const Vector4& rhs) const
     {
+        #ifdef URHO3D_SSE
+        __m128 vec = _mm_loadu_ps(&rhs.x_);
+        Vector4 ret;
+        _mm_storeu_ps(&ret.x_, SSEHorizontalAdd(_mm_mul_ps(_mm_loadu_ps(&m00_), vec), _mm_mul_ps(_mm_loadu_ps(&m10_), vec),
+            _mm_mul_ps(_mm_loadu_ps(&m20_), vec), _mm_mul_ps(_mm_loadu_ps(&m30_), vec)));
+        return ret;
+        #else
         return Vector4(
             m00_ * rhs.x_ + m01_ * rhs.y_ + m02_ * rhs.z_ + m03_ * rhs.w_,
             m10_ * rhs.x_ + m11_ * rhs.y_ + m12_ * rhs.z_ + m13_ * rhs.w_,
             m20_ * rhs.x_ + m21_ * rhs.y_ + m22_ * rhs.z_ + m23_ * rhs.w_,
             m30_ * rhs.x_ + m31_ * rhs.y_ + m32_ * rhs.z_ + m33_ * rhs.w_
         );
+        #endif
     }
     
     /// Add a matrix.
@@ -263,6 +281,18 @@ public:
     /// Multiply a matrix.
     Matrix4 operator * (const Matrix4& rhs) const
     {
+        #ifdef URHO3D_SSE
+        __m128 r0 = _mm_loadu_ps(&rhs.m00_);
+        __m128 r1 = _mm_loadu_ps(&rhs.m10_);
+        __m128 r2 = _mm_loadu_ps(&rhs.m20_);
+        __m128 r3 = _mm_loadu_ps(&rhs.m30_);
+        Matrix4 ret;
+        _mm_storeu_ps(&ret.m00_, SSEMultiplyRow(_mm_loadu_ps(&m00_), r0, r1, r2, r3));
+        _mm_storeu_ps(&ret.m10_, SSEMultiplyRow(_mm_loadu_ps(&m10_), r0, r1, r2, r3));
+        _mm_storeu_ps(&ret.m20_, SSEMultiplyRow(_mm_loadu_ps(&m20_), r0, r1, r2, r3));
+        _mm_storeu_ps(&ret.m30_, SSEMultiplyRow(_mm_loadu_ps(&m30_), r0, r1, r2, r3));
+        return ret;
+        #else
         return Matrix4(
             m00_ * rhs.m00_ + m01_ * rhs.m10_ + m02_ * rhs.m20_ + m03_ * rhs.m30_,
             m00_ * rhs.m01_ + m01_ * rhs.m11_ + m02_ * rhs.m21_ + m03_ * rhs.m31_,
@@ -281,6 +311,7 @@ public:
             m30_ * rhs.m02_ + m31_ * rhs.m12_ + m32_ * rhs.m22_ + m33_ * rhs.m32_,
             m30_ * rhs.m03_ + m31_ * rhs.m13_ + m32_ * rhs.m23_ + m33_ * rhs.m33_
         );
+        #endif
     }
     
     /// Set translation elements.
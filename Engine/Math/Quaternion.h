@@ -143,22 +143,55 @@ public:
     /// Multiply a quaternion.
     Quaternion operator * (const Quaternion& rhs) const
     {
+        #ifdef URHO3D_SSE
+        // Components are stored in w, x, y, z order. Multiply each component of this quaternion with a swizzle of rhs
+        __m128 q = _mm_loadu_ps(&w_);
+        __m128 r = _mm_loadu_ps(&rhs.w_);
+        __m128 ret = _mm_mul_ps(_mm_shuffle_ps(q, q, _MM_SHUFFLE(0, 0, 0, 0)), r);
+        ret = _mm_add_ps(ret, _mm_xor_ps(_mm_mul_ps(_mm_shuffle_ps(q, q, _MM_SHUFFLE(1, 1, 1, 1)),
+            _mm_shuffle_ps(r, r, _MM_SHUFFLE(2, 3, 0, 1))), _mm_set_ps(0.0f, -0.0f, 0.0f, -0.0f)));
+        ret = _mm_add_ps(ret, _mm_xor_ps(_mm_mul_ps(_mm_shuffle_ps(q, q, _MM_SHUFFLE(2, 2, 2, 2)),
+            _mm_shuffle_ps(r, r, _MM_SHUFFLE(1, 0, 3, 2))), _mm_set_ps(-0.0f, 0.0f, 0.0f, -0.0f)));
+        ret = _mm_add_ps(ret, _mm_xor_ps(_mm_mul_ps(_mm_shuffle_ps(q, q, _MM_SHUFFLE(3, 3, 3, 3)),
+            _mm_shuffle_ps(r, r, _MM_SHUFFLE(0, 1, 2, 3))), _mm_set_ps(0.0f, 0.0f, -0.0f, -0.0f)));
+        Quaternion quat;
+        _mm_storeu_ps(&quat.w_, ret);
+        return quat;
+        #else
         return Quaternion(
             w_ * rhs.w_ - x_ * rhs.x_ - y_ * rhs.y_ - z_ * rhs.z_,
             w_ * rhs.x_ + x_ * rhs.w_ + y_ * rhs.z_ - z_ * rhs.y_,
             w_ * rhs.y_ + y_ * rhs.w_ + z_ * rhs.x_ - x_ * rhs.z_,
             w_ * rhs.z_ + z_ * rhs.w_ + x_ * rhs.y_ - y_ * rhs.x_
         );
+        #endif
     }
     
     /// Multiply a Vector3.
     Vector3 operator * (const Vector3& rhs) const
     {
+        #ifdef URHO3D_SSE
+        __m128 q = _mm_loadu_ps(&w_);
+        __m128 qVec = _mm_shuffle_ps(q, q, _MM_SHUFFLE(0, 3, 2, 1));
+        __m128 vec = _mm_set_ps(0.0f, rhs.z_, rhs.y_, rhs.x_);
+        __m128 cross1 = _mm_sub_ps(_mm_mul_ps(_mm_shuffle_ps(qVec, qVec, _MM_SHUFFLE(3, 0, 2, 1)), _mm_shuffle_ps(vec, vec,
+            _MM_SHUFFLE(3, 1, 0, 2))), _mm_mul_ps(_mm_shuffle_ps(qVec, qVec, _MM_SHUFFLE(3, 1, 0, 2)), _mm_shuffle_ps(vec, vec,
+            _MM_SHUFFLE(3, 0, 2, 1))));
+        __m128 cross2 = _mm_sub_ps(_mm_mul_ps(_mm_shuffle_ps(qVec, qVec, _MM_SHUFFLE(3, 0, 2, 1)), _mm_shuffle_ps(cross1, cross1,
+            _MM_SHUFFLE(3, 1, 0, 2))), _mm_mul_ps(_mm_shuffle_ps(qVec, qVec, _MM_SHUFFLE(3, 1, 0, 2)), _mm_shuffle_ps(cross1, cross1,
+            _MM_SHUFFLE(3, 0, 2, 1))));
+        __m128 ret = _mm_add_ps(_mm_mul_ps(cross1, _mm_shuffle_ps(q, q, _MM_SHUFFLE(0, 0, 0, 0))), cross2);
+        ret = _mm_add_ps(vec, _mm_mul_ps(ret, _mm_set1_ps(2.0f)));
+        float data[4];
+        _mm_storeu_ps(data, ret);
+        return Vector3(data);
+        #else
         Vector3 qVec(x_,y_,z_);
         Vector3 cross1(qVec.CrossProduct(rhs));
         Vector3 cross2(qVec.CrossProduct(cross1));
         
         return rhs + 2.0f * (cross1 * w_ + cross2);
+        #endif
     }
     
     /// Define from an angle (in degrees) and axis.
@@ -252,4 +252,43 @@ Intersection Sphere::IsInsideFast(const BoundingBox& box) const
         return INSIDE;
 }
 
+void Sphere::IsInsideFast(const BoundingBox* const* boxes, unsigned count, unsigned char* results) const
+{
+    unsigned i = 0;
+    
+    #ifdef URHO3D_SSE
+    __m128 centerX = _mm_set1_ps(center_.x_);
+    __m128 centerY = _mm_set1_ps(center_.y_);
+    __m128 centerZ = _mm_set1_ps(center_.z_);
+    __m128 radiusSquared = _mm_set1_ps(radius_ * radius_);
+    __m128 zero = _mm_setzero_ps();
+    
+    for (; i + 4 <= count; i += 4)
+    {
+        // Calculate the squared distances from the sphere center to four boxes at once
+        const BoundingBox& b0 = *boxes[i];
+        const BoundingBox& b1 = *boxes[i + 1];
+        const BoundingBox& b2 = *boxes[i + 2];
+        const BoundingBox& b3 = *boxes[i + 3];
+        __m128 distX = _mm_add_ps(_mm_max_ps(_mm_sub_ps(_mm_set_ps(b3.min_.x_, b2.min_.x_, b1.min_.x_, b0.min_.x_), centerX),
+            zero), _mm_max_ps(_mm_sub_ps(centerX, _mm_set_ps(b3.max_.x_, b2.max_.x_, b1.max_.x_, b0.max_.x_)), zero));
+        __m128 distY = _mm_add_ps(_mm_max_ps(_mm_sub_ps(_mm_set_ps(b3.min_.y_, b2.min_.y_, b1.min_.y_, b0.min_.y_), centerY),
+            zero), _mm_max_ps(_mm_sub_ps(centerY, _mm_set_ps(b3.max_.y_, b2.max_.y_, b1.max_.y_, b0.max_.y_)), zero));
+        __m128 distZ = _mm_add_ps(_mm_max_ps(_mm_sub_ps(_mm_set_ps(b3.min_.z_, b2.min_.z_, b1.min_.z_, b0.min_.z_), centerZ),
+            zero), _mm_max_ps(_mm_sub_ps(centerZ, _mm_set_ps(b3.max_.z_, b2.max_.z_, b1.max_.z_, b0.max_.z_)), zero));
+        __m128 distSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(distX, distX), _mm_mul_ps(distY, distY)), _mm_mul_ps(distZ,
+            distZ));
+        
+        int mask = _mm_movemask_ps(_mm_cmplt_ps(distSquared, radiusSquared));
+        results[i] = (mask & 1) ? 1 : 0;
+        results[i + 1] = (mask & 2) ? 1 : 0;
+        results[i + 2] = (mask & 4) ? 1 : 0;
+        results[i + 3] = (mask & 8) ? 1 : 0;
+    }
+    #endif
+    
+    for (; i < count; ++i)
+        results[i] = IsInsideFast(*boxes[i]) != OUTSIDE ? 1 : 0;
+}
+
 }
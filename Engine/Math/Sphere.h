@@ -203,6 +203,8 @@ public:
     Intersection IsInside(const BoundingBox& box) const;
     /// Test if a bounding box is (partially) inside or outside.
     Intersection IsInsideFast(const BoundingBox& box) const;
+    /// Test bounding boxes for being (partially) inside or outside. Write 1 to results for each box that is inside and 0 for each box that is outside. Tests four boxes at a time if SSE is enabled.
+    void IsInsideFast(const BoundingBox* const* boxes, unsigned count, unsigned char* results) const;
     
     /// Return distance of a point to the surface, or 0 if inside.
     float Distance(const Vector3& point) const { return Max((point - center_).Length() - radius_, 0.0f); }
@@ -21,6 +21,8 @@
 //
 
 #include "Precompiled.h"
+#include "Atomic.h"
+#include "HashMap.h"
 #include "MathDefs.h"
 #include "StringHash.h"
 
@@ -34,14 +36,70 @@ namespace Urho3D
 const StringHash StringHash::ZERO;
 const ShortStringHash ShortStringHash::ZERO;
 
+#ifdef ENABLE_HASH_REGISTRY
+/// Hash registry lock.
+static SpinLock registryLock;
+
+/// Return the registry of strings by 32-bit hash value. Constructed on first use, as hashes are also calculated during static initialization.
+static HashMap<unsigned, String>& GetStringHashRegistry()
+{
+    static HashMap<unsigned, String> registry;
+    return registry;
+}
+
+/// Return the registry of strings by 16-bit hash value.
+static HashMap<unsigned, String>& GetShortStringHashRegistry()
+{
+    static HashMap<unsigned, String> registry;
+    return registry;
+}
+
+/// Store the string of a hash, or report a collision if a different string already has the same hash.
+static void RegisterHash(HashMap<unsigned, String>& registry, unsigned hash, const char* str, const char* format)
+{
+    if (!str || !*str)
+        return;
+    
+    registryLock.Acquire();
+    
+    HashMap<unsigned, String>::Iterator i = registry.Find(hash);
+    if (i == registry.End())
+        registry[hash] = str;
+    else if (i->second_.Compare(str, false))
+        fprintf(stderr, format, i->second_.CString(), str, hash);
+    
+    registryLock.Release();
+}
+
+/// Return the registered string of a hash, or empty if not registered.
+static String FindHash(HashMap<unsigned, String>& registry, unsigned hash)
+{
+    String ret;
+    
+    registryLock.Acquire();
+    HashMap<unsigned, String>::ConstIterator i = registry.Find(hash);
+    if (i != registry.End())
+        ret = i->second_;
+    registryLock.Release();
+    
+    return ret;
+}
+#endif
+
 StringHash::StringHash(const char* str) :
     value_(Calculate(str))
 {
+    #ifdef ENABLE_HASH_REGISTRY
+    RegisterHash(GetStringHashRegistry(), value_, str, "StringHash collision: \"%s\" and \"%s\" both hash to %08X\n");
+    #endif
 }
 
 StringHash::StringHash(const String& str) :
     value_(Calculate(str.CString()))
 {
+    #ifdef ENABLE_HASH_REGISTRY
+    RegisterHash(GetStringHashRegistry(), value_, str.CString(), "StringHash collision: \"%s\" and \"%s\" both hash to %08X\n");
+    #endif
 }
 
 unsigned StringHash::Calculate(const char* str)
@@ -69,14 +127,31 @@ String StringHash::ToString() const
     return String(tempBuffer);
 }
 
+String StringHash::Reverse() const
+{
+    #ifdef ENABLE_HASH_REGISTRY
+    String str = FindHash(GetStringHashRegistry(), value_);
+    if (!str.Empty())
+        return str;
+    #endif
+    
+    return ToString();
+}
+
 ShortStringHash::ShortStringHash(const char* str) :
     value_(Calculate(str))
 {
+    #ifdef ENABLE_HASH_REGISTRY
+    RegisterHash(GetShortStringHashRegistry(), value_, str, "ShortStringHash collision: \"%s\" and \"%s\" both hash to %04X\n");
+    #endif
 }
 
 ShortStringHash::ShortStringHash(const String& str) :
     value_(Calculate(str.CString()))
 {
+    #ifdef ENABLE_HASH_REGISTRY
+    RegisterHash(GetShortStringHashRegistry(), value_, str.CString(), "ShortStringHash collision: \"%s\" and \"%s\" both hash to %04X\n");
+    #endif
 }
 
 unsigned short ShortStringHash::Calculate(const char* str)
@@ -91,4 +166,15 @@ String ShortStringHash::ToString() const
     return String(tempBuffer);
 }
 
+String ShortStringHash::Reverse() const
+{
+    #ifdef ENABLE_HASH_REGISTRY
+    String str = FindHash(GetShortStringHashRegistry(), value_);
+    if (!str.Empty())
+        return str;
+    #endif
+    
+    return ToString();
+}
+
 }
@@ -32,19 +32,19 @@ class StringHash
 {
 public:
     /// Construct with zero value.
-    StringHash() :
+    URHO3D_CONSTEXPR StringHash() :
         value_(0)
     {
     }
     
     /// Copy-construct from another hash.
-    StringHash(const StringHash& rhs) :
+    URHO3D_CONSTEXPR StringHash(const StringHash& rhs) :
         value_(rhs.value_)
     {
     }
     
     /// Construct with an initial value.
-    explicit StringHash(unsigned value) :
+    explicit URHO3D_CONSTEXPR StringHash(unsigned value) :
         value_(value)
     {
     }
@@ -91,11 +91,21 @@ public:
     unsigned Value() const { return value_; }
     /// Return as string.
     String ToString() const;
+    /// Return the string the hash was calculated from if known to the hash registry, otherwise the hash value as string.
+    String Reverse() const;
     /// Return hash value for HashSet & HashMap.
     unsigned ToHash() const { return value_; }
     
     /// Calculate hash value case-insensitively from a C string.
     static unsigned Calculate(const char* str);
+    #ifdef URHO3D_HAS_CONSTEXPR
+    /// Calculate hash value case-insensitively from a C string at compile time. Gives the same result as Calculate().
+    static constexpr unsigned CalculateLiteral(const char* str, unsigned hash = 0)
+    {
+        return *str ? CalculateLiteral(str + 1, (unsigned char)(*str >= 'A' && *str <= 'Z' ? *str + ('a' - 'A') : *str) +
+            (hash << 6) + (hash << 16) - hash) : hash;
+    }
+    #endif
     
     /// Zero hash.
     static const StringHash ZERO;
@@ -110,13 +120,13 @@ class ShortStringHash
 {
 public:
     /// Construct with zero hash value.
-    ShortStringHash() :
+    URHO3D_CONSTEXPR ShortStringHash() :
         value_(0)
     {
     }
     
     /// Copy-construct from another hash value.
-    ShortStringHash(const ShortStringHash& rhs) :
+    URHO3D_CONSTEXPR ShortStringHash(const ShortStringHash& rhs) :
         value_(rhs.value_)
     {
     }
@@ -128,7 +138,7 @@ public:
     }
     
     /// Construct with an initial value.
-    explicit ShortStringHash(unsigned short value) :
+    explicit URHO3D_CONSTEXPR ShortStringHash(unsigned short value) :
         value_(value)
     {
     }
@@ -174,6 +184,8 @@ public:
     unsigned short Value() const { return value_; }
     /// Return as string.
     String ToString() const;
+    /// Return the string the hash was calculated from if known to the hash registry, otherwise the hash value as string.
+    String Reverse() const;
     /// Return hash value for HashSet & HashMap.
     unsigned ToHash() const { return value_; }
     
@@ -188,7 +200,13 @@ private:
     unsigned short value_;
 };
 
+// Calculate the hashes of identifiers at compile time if possible, unless the hash registry needs to see the strings
+#if defined(URHO3D_HAS_CONSTEXPR) && !defined(ENABLE_HASH_REGISTRY)
+#define HASH(str) (StringHash(StringHash::CalculateLiteral(#str)))
+#define SHORTHASH(str) (ShortStringHash((unsigned short)StringHash::CalculateLiteral(#str)))
+#else
 #define HASH(str) (StringHash(#str))
 #define SHORTHASH(str) (ShortStringHash(#str))
+#endif
 
 }
@@ -86,6 +86,48 @@ public:
     bool operator == (const Vector4& rhs) const { return x_ == rhs.x_ && y_ == rhs.y_ && z_ == rhs.z_ && w_ == rhs.w_; }
     /// Test for inequality with another vector without epsilon.
     bool operator != (const Vector4& rhs) const { return x_ != rhs.x_ || y_ != rhs.y_ || z_ != rhs.z_ || w_ != rhs.w_; }
+    #ifdef URHO3D_SSE
+    /// Add a vector.
+    Vector4 operator + (const Vector4& rhs) const
+    {
+        Vector4 ret;
+        _mm_storeu_ps(&ret.x_, _mm_add_ps(_mm_loadu_ps(&x_), _mm_loadu_ps(&rhs.x_)));
+        return ret;
+    }
+    
+    /// Return negation.
+    Vector4 operator - () const
+    {
+        // Flip the sign bits, which negates zeros and infinities the same way as the scalar version
+        Vector4 ret;
+        _mm_storeu_ps(&ret.x_, _mm_xor_ps(_mm_loadu_ps(&x_), _mm_set1_ps(-0.0f)));
+        return ret;
+    }
+    
+    /// Subtract a vector.
+    Vector4 operator - (const Vector4& rhs) const
+    {
+        Vector4 ret;
+        _mm_storeu_ps(&ret.x_, _mm_sub_ps(_mm_loadu_ps(&x_), _mm_loadu_ps(&rhs.x_)));
+        return ret;
+    }
+    
+    /// Multiply with a scalar.
+    Vector4 operator * (float rhs) const
+    {
+        Vector4 ret;
+        _mm_storeu_ps(&ret.x_, _mm_mul_ps(_mm_loadu_ps(&x_), _mm_set1_ps(rhs)));
+        return ret;
+    }
+    
+    /// Multiply with a vector.
+    Vector4 operator * (const Vector4& rhs) const
+    {
+        Vector4 ret;
+        _mm_storeu_ps(&ret.x_, _mm_mul_ps(_mm_loadu_ps(&x_), _mm_loadu_ps(&rhs.x_)));
+        return ret;
+    }
+    #else
     /// Add a vector.
     Vector4 operator + (const Vector4& rhs) const { return Vector4(x_ + rhs.x_, y_ + rhs.y_, z_ + rhs.z_, w_ + rhs.w_); }
     /// Return negation.
@@ -96,6 +138,7 @@ public:
     Vector4 operator * (float rhs) const { return Vector4(x_ * rhs, y_ * rhs, z_ * rhs, w_ * rhs); }
     /// Multiply with a vector.
     Vector4 operator * (const Vector4& rhs) const { return Vector4(x_ * rhs.x_, y_ * rhs.y_, z_ * rhs.z_, w_ * rhs.w_); }
+    #endif
     /// Divide by a scalar.
     Vector4 operator / (float rhs) const { return Vector4(x_ / rhs, y_ / rhs, z_ / rhs, w_ / rhs); }
     /// Divide by a vector.
@@ -162,8 +205,13 @@ public:
         return *this;
     }
     
+    #ifdef URHO3D_SSE
+    /// Calculate dot product.
+    float DotProduct(const Vector4& rhs) const { return SSEHorizontalAdd(_mm_mul_ps(_mm_loadu_ps(&x_), _mm_loadu_ps(&rhs.x_))); }
+    #else
     /// Calculate dot product.
     float DotProduct(const Vector4& rhs) const { return x_ * rhs.x_ + y_ * rhs.y_ + z_ * rhs.z_ + w_ * rhs.w_; }
+    #endif
     /// Calculate absolute dot product.
     float AbsDotProduct(const Vector4& rhs) const { return Urho3D::Abs(x_ * rhs.x_) + Urho3D::Abs(y_ * rhs.y_) + Urho3D::Abs(z_ * rhs.z_) + Urho3D::Abs(w_ * rhs.w_); }
     /// Return absolute vector.
@@ -103,7 +103,7 @@ void Connection::SendRemoteEvent(StringHash eventType, bool inOrder, const Varia
 {
     if (!GetSubsystem<Network>()->CheckRemoteEvent(eventType))
     {
-        LOGWARNING("Discarding not allowed remote event " + eventType.ToString());
+        LOGWARNING("Discarding not allowed remote event " + eventType.Reverse());
         return;
     }
     
@@ -119,7 +119,7 @@ void Connection::SendRemoteEvent(Node* node, StringHash eventType, bool inOrder,
 {
     if (!GetSubsystem<Network>()->CheckRemoteEvent(eventType))
     {
-        LOGWARNING("Discarding not allowed remote event " + eventType.ToString());
+        LOGWARNING("Discarding not allowed remote event " + eventType.Reverse());
         return;
     }
     
@@ -949,7 +949,7 @@ void Connection::ProcessRemoteEvent(int msgID, MemoryBuffer& msg)
         StringHash eventType = msg.ReadStringHash();
         if (!GetSubsystem<Network>()->CheckRemoteEvent(eventType))
         {
-            LOGWARNING("Discarding not allowed remote event " + eventType.ToString());
+            LOGWARNING("Discarding not allowed remote event " + eventType.Reverse());
             return;
         }
         
@@ -969,7 +969,7 @@ void Connection::ProcessRemoteEvent(int msgID, MemoryBuffer& msg)
         StringHash eventType = msg.ReadStringHash();
         if (!GetSubsystem<Network>()->CheckRemoteEvent(eventType))
         {
-            LOGWARNING("Discarding not allowed remote event " + eventType.ToString());
+            LOGWARNING("Discarding not allowed remote event " + eventType.Reverse());
             return;
         }
         
@@ -309,6 +309,9 @@ void CollisionShape::ApplyAttributes()
 
 void CollisionShape::DrawDebugGeometry(DebugRenderer* debug, bool depthTest)
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (debug && physicsWorld_ && shape_ && node_)
     {
         physicsWorld_->SetDebugRenderer(debug);
@@ -343,6 +346,9 @@ void CollisionShape::DrawDebugGeometry(DebugRenderer* debug, bool depthTest)
 
 void CollisionShape::Clear()
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     shapeType_ = SHAPE_NONE;
     
     UpdateShape();
@@ -352,6 +358,9 @@ void CollisionShape::Clear()
 
 void CollisionShape::SetBox(const Vector3& size, const Vector3& position, const Quaternion& rotation)
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     shapeType_ = SHAPE_BOX;
     size_ = size;
     position_ = position;
@@ -365,6 +374,9 @@ void CollisionShape::SetBox(const Vector3& size, const Vector3& position, const
 
 void CollisionShape::SetSphere(float diameter, const Vector3& position, const Quaternion& rotation)
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     shapeType_ = SHAPE_SPHERE;
     size_ = Vector3(diameter, diameter, diameter);
     position_ = position;
@@ -378,6 +390,9 @@ void CollisionShape::SetSphere(float diameter, const Vector3& position, const Qu
 
 void CollisionShape::SetCylinder(float diameter, float height, const Vector3& position, const Quaternion& rotation)
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     shapeType_ = SHAPE_CYLINDER;
     size_ = Vector3(diameter, height, diameter);
     position_ = position;
@@ -391,6 +406,9 @@ void CollisionShape::SetCylinder(float diameter, float height, const Vector3& po
 
 void CollisionShape::SetCapsule(float diameter, float height, const Vector3& position, const Quaternion& rotation)
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     shapeType_ = SHAPE_CAPSULE;
     size_ = Vector3(diameter, height, diameter);
     position_ = position;
@@ -404,6 +422,9 @@ void CollisionShape::SetCapsule(float diameter, float height, const Vector3& pos
 
 void CollisionShape::SetCone(float diameter, float height, const Vector3& position, const Quaternion& rotation)
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     shapeType_ = SHAPE_CONE;
     size_ = Vector3(diameter, height, diameter);
     position_ = position;
@@ -417,6 +438,9 @@ void CollisionShape::SetCone(float diameter, float height, const Vector3& positi
 
 void CollisionShape::SetTriangleMesh(Model* model, unsigned lodLevel, const Vector3& scale, const Vector3& position, const Quaternion& rotation)
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (!model)
     {
         LOGERROR("Null model, can not set triangle mesh");
@@ -437,6 +461,9 @@ void CollisionShape::SetTriangleMesh(Model* model, unsigned lodLevel, const Vect
 
 void CollisionShape::SetConvexHull(Model* model, unsigned lodLevel, const Vector3& scale, const Vector3& position, const Quaternion& rotation)
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (!model)
     {
         LOGERROR("Null model, can not set convex hull");
@@ -457,6 +484,9 @@ void CollisionShape::SetConvexHull(Model* model, unsigned lodLevel, const Vector
 
 void CollisionShape::SetTerrain()
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     Terrain* terrain = GetComponent<Terrain>();
     if (!terrain)
     {
@@ -473,6 +503,9 @@ void CollisionShape::SetTerrain()
 
 void CollisionShape::SetShapeType(ShapeType type)
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (type != shapeType_)
     {
         shapeType_ = type;
@@ -484,6 +517,9 @@ void CollisionShape::SetShapeType(ShapeType type)
 
 void CollisionShape::SetSize(const Vector3& size)
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (size != size_)
     {
         size_ = size;
@@ -495,6 +531,9 @@ void CollisionShape::SetSize(const Vector3& size)
 
 void CollisionShape::SetPosition(const Vector3& position)
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (position != position_)
     {
         position_ = position;
@@ -505,6 +544,9 @@ void CollisionShape::SetPosition(const Vector3& position)
 
 void CollisionShape::SetRotation(const Quaternion& rotation)
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (rotation != rotation_)
     {
         rotation_ = rotation;
@@ -515,6 +557,9 @@ void CollisionShape::SetRotation(const Quaternion& rotation)
 
 void CollisionShape::SetTransform(const Vector3& position, const Quaternion& rotation)
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (position != position_ || rotation != rotation_)
     {
         position_ = position;
@@ -526,6 +571,9 @@ void CollisionShape::SetTransform(const Vector3& position, const Quaternion& rot
 
 void CollisionShape::SetMargin(float margin)
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     margin = Max(margin, 0.0f);
     
     if (margin != margin_)
@@ -539,6 +587,9 @@ void CollisionShape::SetMargin(float margin)
 
 void CollisionShape::SetModel(Model* model)
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (model != model_)
     {
         model_ = model;
@@ -553,6 +604,9 @@ void CollisionShape::SetModel(Model* model)
 
 void CollisionShape::SetLodLevel(unsigned lodLevel)
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (lodLevel != lodLevel_)
     {
         lodLevel_ = lodLevel;
@@ -567,6 +621,9 @@ void CollisionShape::SetLodLevel(unsigned lodLevel)
 
 void CollisionShape::NotifyRigidBody()
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     btCompoundShape* compound = GetParentCompoundShape();
     if (node_ && shape_ && compound)
     {
@@ -607,6 +664,9 @@ ResourceRef CollisionShape::GetModelAttr() const
 
 void CollisionShape::ReleaseShape()
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     btCompoundShape* compound = GetParentCompoundShape();
     if (shape_ && compound)
     {
@@ -661,6 +721,10 @@ void CollisionShape::OnMarkedDirty(Node* node)
             return;
         }
         
+        // Only a scale change touches the shape, so a node that is just moved does not wait for a pipelined step
+        if (physicsWorld_)
+            physicsWorld_->CompletePipelinedStep();
+        
         switch (shapeType_)
         {
         case SHAPE_BOX:
@@ -703,6 +767,9 @@ btCompoundShape* CollisionShape::GetParentCompoundShape()
 
 void CollisionShape::UpdateShape()
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     PROFILE(UpdateCollisionShape);
     
     ReleaseShape();
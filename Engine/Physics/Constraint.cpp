@@ -155,6 +155,9 @@ void Constraint::GetDependencyNodes(PODVector<Node*>& dest)
 
 void Constraint::DrawDebugGeometry(DebugRenderer* debug, bool depthTest)
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (debug && physicsWorld_ && constraint_)
     {
         physicsWorld_->SetDebugRenderer(debug);
@@ -171,6 +174,9 @@ void Constraint::Clear()
 
 void Constraint::SetConstraintType(ConstraintType type)
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (type != constraintType_)
     {
         constraintType_ = type;
@@ -181,6 +187,9 @@ void Constraint::SetConstraintType(ConstraintType type)
 
 void Constraint::SetOtherBody(RigidBody* body)
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (otherBody_ != body)
     {
         if (otherBody_)
@@ -199,6 +208,9 @@ void Constraint::SetOtherBody(RigidBody* body)
 
 void Constraint::SetPosition(const Vector3& position)
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (position != position_)
     {
         position_ = position;
@@ -209,6 +221,9 @@ void Constraint::SetPosition(const Vector3& position)
 
 void Constraint::SetRotation(const Quaternion& rotation)
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (rotation != rotation_)
     {
         rotation_ = rotation;
@@ -219,6 +234,9 @@ void Constraint::SetRotation(const Quaternion& rotation)
 
 void Constraint::SetAxis(const Vector3& axis)
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     switch (constraintType_)
     {
     case CONSTRAINT_POINT:
@@ -241,6 +259,9 @@ void Constraint::SetAxis(const Vector3& axis)
 
 void Constraint::SetOtherPosition(const Vector3& position)
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (position != otherPosition_)
     {
         otherPosition_ = position;
@@ -251,6 +272,9 @@ void Constraint::SetOtherPosition(const Vector3& position)
 
 void Constraint::SetOtherRotation(const Quaternion& rotation)
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (rotation != otherRotation_)
     {
         otherRotation_ = rotation;
@@ -261,6 +285,9 @@ void Constraint::SetOtherRotation(const Quaternion& rotation)
 
 void Constraint::SetOtherAxis(const Vector3& axis)
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     switch (constraintType_)
     {
     case CONSTRAINT_POINT:
@@ -283,6 +310,9 @@ void Constraint::SetOtherAxis(const Vector3& axis)
 
 void Constraint::SetWorldPosition(const Vector3& position)
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (constraint_)
     {
         btTransform ownBodyInverse = constraint_->getRigidBodyA().getWorldTransform().inverse();
@@ -301,6 +331,9 @@ void Constraint::SetWorldPosition(const Vector3& position)
 
 void Constraint::SetHighLimit(const Vector2& limit)
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (limit != highLimit_)
     {
         highLimit_ = limit;
@@ -311,6 +344,9 @@ void Constraint::SetHighLimit(const Vector2& limit)
 
 void Constraint::SetLowLimit(const Vector2& limit)
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (limit != lowLimit_)
     {
         lowLimit_ = limit;
@@ -321,6 +357,9 @@ void Constraint::SetLowLimit(const Vector2& limit)
 
 void Constraint::SetDisableCollision(bool disable)
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (disable != disableCollision_)
     {
         disableCollision_ = disable;
@@ -331,6 +370,9 @@ void Constraint::SetDisableCollision(bool disable)
 
 Vector3 Constraint::GetWorldPosition() const
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (constraint_)
     {
         btTransform ownBody = constraint_->getRigidBodyA().getWorldTransform();
@@ -342,6 +384,9 @@ Vector3 Constraint::GetWorldPosition() const
 
 void Constraint::ReleaseConstraint()
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (constraint_)
     {
         if (ownBody_)
@@ -388,6 +433,9 @@ void Constraint::OnMarkedDirty(Node* node)
 
 void Constraint::CreateConstraint()
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     PROFILE(CreateConstraint);
     
     cachedWorldScale_ = node_->GetWorldScale();
@@ -460,6 +508,9 @@ void Constraint::CreateConstraint()
 
 void Constraint::ApplyFrames()
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (!constraint_)
         return;
     
@@ -514,6 +565,9 @@ void Constraint::ApplyFrames()
 
 void Constraint::ApplyLimits()
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (!constraint_)
         return;
     
@@ -24,6 +24,7 @@
 #include "CollisionShape.h"
 #include "Constraint.h"
 #include "Context.h"
+#include "CoreEvents.h"
 #include "DebugRenderer.h"
 #include "Log.h"
 #include "Mutex.h"
@@ -36,6 +37,7 @@
 #include "Scene.h"
 #include "SceneEvents.h"
 #include "Sort.h"
+#include "WorkQueue.h"
 
 #include <BulletCollision/BroadphaseCollision/btDbvtBroadphase.h>
 #include <BulletCollision/CollisionDispatch/btDefaultCollisionConfiguration.h>
@@ -65,6 +67,12 @@ void InternalTickCallback(btDynamicsWorld *world, btScalar timeStep)
     static_cast<PhysicsWorld*>(world->getWorldUserInfo())->PostStep(timeStep);
 }
 
+void StepSimulationWork(const WorkItem* item, unsigned threadIndex)
+{
+    PhysicsWorld* world = reinterpret_cast<PhysicsWorld*>(item->aux_);
+    world->StepSimulation(world->pipelinedTimeStep_);
+}
+
 /// Callback for physics world queries.
 struct PhysicsQueryCallback : public btCollisionWorld::ContactResultCallback
 {
@@ -91,6 +99,8 @@ struct PhysicsQueryCallback : public btCollisionWorld::ContactResultCallback
 
 OBJECTTYPESTATIC(PhysicsWorld);
 
+bool PhysicsWorld::pipelined = false;
+
 PhysicsWorld::PhysicsWorld(Context* context) :
     Component(context),
     collisionConfiguration_(0),
@@ -103,6 +113,9 @@ PhysicsWorld::PhysicsWorld(Context* context) :
     maxNetworkAngularVelocity_(DEFAULT_MAX_NETWORK_ANGULAR_VELOCITY),
     interpolation_(true),
     applyingTransforms_(false),
+    pipelinedTimeStep_(0.0f),
+    pipelinedStepping_(false),
+    pipelinedStepItem_(0),
     debugRenderer_(0),
     debugMode_(btIDebugDraw::DBG_DrawWireframe | btIDebugDraw::DBG_DrawConstraints)
 {
@@ -121,6 +134,15 @@ PhysicsWorld::PhysicsWorld(Context* context) :
 
 PhysicsWorld::~PhysicsWorld()
 {
+    // Wait for a pipelined step to finish, but do not apply its results anymore
+    if (pipelinedStepping_ && pipelinedStepItem_)
+    {
+        WorkQueue* queue = GetSubsystem<WorkQueue>();
+        if (queue)
+            queue->CompleteItem(pipelinedStepItem_);
+    }
+    pipelinedStepping_ = false;
+    
     if (scene_)
     {
         // Force all remaining constraints, rigid bodies and collision shapes to release themselves
@@ -150,6 +172,11 @@ PhysicsWorld::~PhysicsWorld()
     collisionConfiguration_ = 0;
 }
 
+void PhysicsWorld::SetPipelined(bool enable)
+{
+    pipelined = enable;
+}
+
 void PhysicsWorld::RegisterObject(Context* context)
 {
     context->RegisterFactory<PhysicsWorld>();
@@ -180,6 +207,8 @@ void PhysicsWorld::DrawDebugGeometry(DebugRenderer* debug, bool depthTest)
     {
         PROFILE(PhysicsDrawDebug);
         
+        CompletePipelinedStep();
+        
         debugRenderer_ = debug;
         debugDepthTest_ = depthTest;
         world_->debugDrawWorld();
@@ -196,8 +225,67 @@ void PhysicsWorld::Update(float timeStep)
 {
     PROFILE(UpdatePhysics);
     
-    float internalTimeStep = 1.0f / fps_;
+    CompletePipelinedStep();
+    
     delayedWorldTransforms_.Clear();
+    StepSimulation(timeStep);
+    ApplyDelayedWorldTransforms();
+}
+
+void PhysicsWorld::FinishPipelinedStep()
+{
+    // If the work item has already been purged from the work queue, the step has completed
+    if (pipelinedStepItem_)
+    {
+        PROFILE(CompletePipelinedPhysics);
+        
+        GetSubsystem<WorkQueue>()->CompleteItem(pipelinedStepItem_);
+        pipelinedStepItem_ = 0;
+    }
+    
+    pipelinedStepping_ = false;
+    float timeStep = pipelinedTimeStep_;
+    pipelinedTimeStep_ = 0.0f;
+    
+    // Parent rigid bodies were not looked up in the worker thread. Resolve them now
+    for (HashMap<RigidBody*, DelayedWorldTransform>::Iterator i = delayedWorldTransforms_.Begin();
+        i != delayedWorldTransforms_.End();)
+    {
+        RigidBody* body = i->second_.rigidBody_;
+        Node* node = body->GetNode();
+        if (!node)
+        {
+            i = delayedWorldTransforms_.Erase(i);
+            continue;
+        }
+        
+        Node* parent = node->GetParent();
+        if (parent && parent != GetScene())
+            i->second_.parentRigidBody_ = parent->GetComponent<RigidBody>();
+        body->MarkNetworkUpdate();
+        ++i;
+    }
+    
+    // Nodes moved during the step take precedence over its results, as they would if the step had completed first. Discard
+    // the results of their bodies before applying the rest, then apply the node transforms to the bodies
+    for (PODVector<RigidBody*>::ConstIterator i = movedRigidBodies_.Begin(); i != movedRigidBodies_.End(); ++i)
+        delayedWorldTransforms_.Erase(*i);
+    ApplyDelayedWorldTransforms();
+    for (PODVector<RigidBody*>::ConstIterator i = movedRigidBodies_.Begin(); i != movedRigidBodies_.End(); ++i)
+    {
+        Node* node = (*i)->GetNode();
+        if (node)
+            (*i)->OnMarkedDirty(node);
+    }
+    movedRigidBodies_.Clear();
+    
+    SendCollisionEvents();
+    SendStepEvent(E_PHYSICSPOSTSTEP, timeStep);
+}
+
+void PhysicsWorld::StepSimulation(float timeStep)
+{
+    float internalTimeStep = 1.0f / fps_;
     
     if (interpolation_)
     {
@@ -213,7 +301,10 @@ void PhysicsWorld::Update(float timeStep)
             timeAcc_ -= internalTimeStep;
         }
     }
-    
+}
+
+void PhysicsWorld::ApplyDelayedWorldTransforms()
+{
     // Apply delayed (parented) world transforms now
     while (!delayedWorldTransforms_.Empty())
     {
@@ -234,6 +325,7 @@ void PhysicsWorld::Update(float timeStep)
 
 void PhysicsWorld::UpdateCollisions()
 {
+    CompletePipelinedStep();
     world_->performDiscreteCollisionDetection();
 }
 
@@ -244,6 +336,7 @@ void PhysicsWorld::SetFps(int fps)
 
 void PhysicsWorld::SetGravity(Vector3 gravity)
 {
+    CompletePipelinedStep();
     world_->setGravity(ToBtVector3(gravity));
 }
 
@@ -261,6 +354,8 @@ void PhysicsWorld::Raycast(PODVector<PhysicsRaycastResult>& result, const Ray& r
 {
     PROFILE(PhysicsRaycast);
     
+    CompletePipelinedStep();
+    
     btCollisionWorld::AllHitsRayResultCallback rayCallback(ToBtVector3(ray.origin_), ToBtVector3(ray.origin_ +
         maxDistance * ray.direction_));
     rayCallback.m_collisionFilterGroup = (short)0xffff;
@@ -285,6 +380,8 @@ void PhysicsWorld::RaycastSingle(PhysicsRaycastResult& result, const Ray& ray, f
 {
     PROFILE(PhysicsRaycastSingle);
     
+    CompletePipelinedStep();
+    
     btCollisionWorld::ClosestRayResultCallback rayCallback(ToBtVector3(ray.origin_), ToBtVector3(ray.origin_ +
         maxDistance * ray.direction_));
     rayCallback.m_collisionFilterGroup = (short)0xffff;
@@ -312,6 +409,8 @@ void PhysicsWorld::SphereCast(PhysicsRaycastResult& result, const Ray& ray, floa
 {
     PROFILE(PhysicsSphereCast);
     
+    CompletePipelinedStep();
+    
     btSphereShape shape(radius);
     
     btCollisionWorld::ClosestConvexResultCallback convexCallback(ToBtVector3(ray.origin_), ToBtVector3(ray.origin_ +
@@ -342,6 +441,7 @@ void PhysicsWorld::GetRigidBodies(PODVector<RigidBody*>& result, const Sphere& s
 {
     PROFILE(PhysicsSphereQuery);
     
+    CompletePipelinedStep();
     result.Clear();
     
     btSphereShape sphereShape(sphere.radius_);
@@ -362,6 +462,7 @@ void PhysicsWorld::GetRigidBodies(PODVector<RigidBody*>& result, const BoundingB
 {
     PROFILE(PhysicsBoxQuery);
     
+    CompletePipelinedStep();
     result.Clear();
     
     btBoxShape boxShape(ToBtVector3(box.HalfSize()));
@@ -381,6 +482,7 @@ void PhysicsWorld::GetRigidBodies(PODVector<RigidBody*>& result, const RigidBody
 {
     PROFILE(GetCollidingBodies);
     
+    CompletePipelinedStep();
     result.Clear();
     
     for (HashSet<Pair<RigidBody*, RigidBody*> >::Iterator i = currentCollisions_.Begin(); i != currentCollisions_.End(); ++i)
@@ -399,11 +501,13 @@ Vector3 PhysicsWorld::GetGravity() const
 
 void PhysicsWorld::AddRigidBody(RigidBody* body)
 {
+    CompletePipelinedStep();
     rigidBodies_.Push(body);
 }
 
 void PhysicsWorld::RemoveRigidBody(RigidBody* body)
 {
+    CompletePipelinedStep();
     rigidBodies_.Remove(body);
     
     // Erase from collision pairs so that they can be used to safely find overlapping bodies
@@ -426,21 +530,25 @@ void PhysicsWorld::RemoveRigidBody(RigidBody* body)
 
 void PhysicsWorld::AddCollisionShape(CollisionShape* shape)
 {
+    CompletePipelinedStep();
     collisionShapes_.Push(shape);
 }
 
 void PhysicsWorld::RemoveCollisionShape(CollisionShape* shape)
 {
+    CompletePipelinedStep();
     collisionShapes_.Remove(shape);
 }
 
 void PhysicsWorld::AddConstraint(Constraint* constraint)
 {
+    CompletePipelinedStep();
     constraints_.Push(constraint);
 }
 
 void PhysicsWorld::RemoveConstraint(Constraint* constraint)
 {
+    CompletePipelinedStep();
     constraints_.Remove(constraint);
 }
 
@@ -449,12 +557,23 @@ void PhysicsWorld::AddDelayedWorldTransform(const DelayedWorldTransform& transfo
     delayedWorldTransforms_[transform.rigidBody_] = transform;
 }
 
+void PhysicsWorld::AddMovedRigidBody(RigidBody* body)
+{
+    movedRigidBodies_.Push(body);
+}
+
 void PhysicsWorld::DrawDebugGeometry(bool depthTest)
 {
     DebugRenderer* debug = GetComponent<DebugRenderer>();
     DrawDebugGeometry(debug, depthTest);
 }
 
+btDiscreteDynamicsWorld* PhysicsWorld::GetWorld()
+{
+    CompletePipelinedStep();
+    return world_;
+}
+
 void PhysicsWorld::SetDebugRenderer(DebugRenderer* debug)
 {
     debugRenderer_ = debug;
@@ -484,6 +603,8 @@ void PhysicsWorld::OnNodeSet(Node* node)
     {
         scene_ = GetScene();
         SubscribeToEvent(node, E_SCENESUBSYSTEMUPDATE, HANDLER(PhysicsWorld, HandleSceneSubsystemUpdate));
+        SubscribeToEvent(E_ENDFRAME, HANDLER(PhysicsWorld, HandleEndFrame));
+        SubscribeToEvent(E_WORKITEMCOMPLETED, HANDLER(PhysicsWorld, HandleWorkItemCompleted));
     }
 }
 
@@ -491,18 +612,78 @@ void PhysicsWorld::HandleSceneSubsystemUpdate(StringHash eventType, VariantMap&
 {
     using namespace SceneSubsystemUpdate;
     
-    Update(eventData[P_TIMESTEP].GetFloat());
+    float timeStep = eventData[P_TIMESTEP].GetFloat();
+    
+    // In pipelined mode start the step in a worker thread now. It runs during the rest of the scene update, the post-update
+    // and render update events and the rendering, and its results are applied at the end of the frame
+    WorkQueue* queue = GetSubsystem<WorkQueue>();
+    if (pipelined && queue && queue->GetNumThreads())
+    {
+        CompletePipelinedStep();
+        pipelinedTimeStep_ += timeStep;
+        BeginPipelinedStep();
+    }
+    else
+        Update(timeStep);
+}
+
+void PhysicsWorld::HandleEndFrame(StringHash eventType, VariantMap& eventData)
+{
+    CompletePipelinedStep();
+}
+
+void PhysicsWorld::HandleWorkItemCompleted(StringHash eventType, VariantMap& eventData)
+{
+    using namespace WorkItemCompleted;
+    
+    // The item pointer becomes invalid after the event
+    if (eventData[P_ITEM].GetPtr() == pipelinedStepItem_)
+        pipelinedStepItem_ = 0;
 }
 
-void PhysicsWorld::PreStep(float timeStep)
+void PhysicsWorld::BeginPipelinedStep()
+{
+    if (pipelinedStepping_ || pipelinedTimeStep_ <= 0.0f)
+        return;
+    
+    // Bullet callbacks can not send events from the worker thread, so send one pre-step event for the whole timestep now
+    SendStepEvent(E_PHYSICSPRESTEP, pipelinedTimeStep_);
+    if (scene_)
+        scene_->NotifyMarkedDirty();
+    
+    delayedWorldTransforms_.Clear();
+    pipelinedStepping_ = true;
+    
+    // Use the lowest priority so that the renderer's work queue completions do not wait for the step. Request the completion
+    // event to know when the item is purged
+    WorkItem item;
+    item.workFunction_ = StepSimulationWork;
+    item.aux_ = this;
+    item.priority_ = 0;
+    item.sendEvent_ = true;
+    pipelinedStepItem_ = GetSubsystem<WorkQueue>()->AddWorkItem(item);
+}
+
+void PhysicsWorld::SendStepEvent(StringHash eventType, float timeStep)
 {
-    // Send pre-step event
     using namespace PhysicsPreStep;
     
     VariantMap eventData;
     eventData[P_WORLD] = (void*)this;
     eventData[P_TIMESTEP] = timeStep;
-    SendEvent(E_PHYSICSPRESTEP, eventData);
+    SendEvent(eventType, eventData);
+}
+
+void PhysicsWorld::PreStep(float timeStep)
+{
+    // During a pipelined step events are sent by the main thread before and after the whole step instead
+    if (pipelinedStepping_)
+        return;
+    
+    SendStepEvent(E_PHYSICSPRESTEP, timeStep);
+    // Apply the transforms of bodies moved in the pre-step event to the simulation
+    if (scene_)
+        scene_->NotifyMarkedDirty();
     
     // Start profiling block for the actual simulation step
 #ifdef ENABLE_PROFILING
@@ -514,6 +695,9 @@ void PhysicsWorld::PreStep(float timeStep)
 
 void PhysicsWorld::PostStep(float timeStep)
 {
+    if (pipelinedStepping_)
+        return;
+    
 #ifdef ENABLE_PROFILING
     Profiler* profiler = GetSubsystem<Profiler>();
     if (profiler)
@@ -521,14 +705,7 @@ void PhysicsWorld::PostStep(float timeStep)
 #endif
     
     SendCollisionEvents();
-    
-    // Send post-step event
-    using namespace PhysicsPreStep;
-    
-    VariantMap eventData;
-    eventData[P_WORLD] = (void*)this;
-    eventData[P_TIMESTEP] = timeStep;
-    SendEvent(E_PHYSICSPOSTSTEP, eventData);
+    SendStepEvent(E_PHYSICSPOSTSTEP, timeStep);
 }
 
 void PhysicsWorld::SendCollisionEvents()
@@ -49,6 +49,7 @@ class Serializer;
 class XMLElement;
 
 struct CollisionGeometryData;
+struct WorkItem;
 
 /// Physics raycast hit.
 struct PhysicsRaycastResult
@@ -88,6 +89,7 @@ class PhysicsWorld : public Component, public btIDebugDraw
 {
     friend void InternalPreTickCallback(btDynamicsWorld *world, btScalar timeStep);
     friend void InternalTickCallback(btDynamicsWorld *world, btScalar timeStep);
+    friend void StepSimulationWork(const WorkItem* item, unsigned threadIndex);
     
     OBJECT(PhysicsWorld);
     
@@ -118,6 +120,8 @@ public:
     
     /// Step the simulation forward.
     void Update(float timeStep);
+    /// Wait for a pipelined simulation step to finish, then apply its transforms and send its collision and post-step events. Called automatically before the Bullet world or the physics components' Bullet objects are accessed from the main thread.
+    void CompletePipelinedStep() { if (pipelinedStepping_) FinishPipelinedStep(); }
     /// Refresh collisions only without updating dynamics.
     void UpdateCollisions();
     /// Set simulation steps per second.
@@ -163,6 +167,8 @@ public:
     void RemoveConstraint(Constraint* joint);
     /// Add a delayed world transform assignment. Called by RigidBody.
     void AddDelayedWorldTransform(const DelayedWorldTransform& transform);
+    /// Add a rigid body whose scene node was moved during a pipelined simulation step. The node transform is applied to the body when the step completes, replacing the step's result. Called by RigidBody.
+    void AddMovedRigidBody(RigidBody* body);
     /// Add debug geometry to the debug renderer.
     void DrawDebugGeometry(bool depthTest);
     /// Set debug renderer to use. Called both by PhysicsWorld itself and physics components.
@@ -170,8 +176,8 @@ public:
     /// Set debug geometry depth test mode. Called both by PhysicsWorld itself and physics components.
     void SetDebugDepthTest(bool enable);
     
-    /// Return the Bullet physics world.
-    btDiscreteDynamicsWorld* GetWorld() { return world_; }
+    /// Return the Bullet physics world. Completes a pipelined simulation step first.
+    btDiscreteDynamicsWorld* GetWorld();
     /// Clean up the geometry cache.
     void CleanupGeometryCache();
     /// Return the collision geometry cache.
@@ -180,6 +186,13 @@ public:
     void SetApplyingTransforms(bool enable) { applyingTransforms_ = enable; }
     /// Return whether node dirtying should be disregarded.
     bool IsApplyingTransforms() const { return applyingTransforms_; }
+    /// Return whether a pipelined simulation step is executing in a worker thread.
+    bool IsPipelinedStepping() const { return pipelinedStepping_; }
+    
+    /// Set whether all physics worlds step the simulation in a worker thread during the rest of the frame, from the scene subsystem update until the end of the frame. Called by Engine. Has no effect without worker threads.
+    static void SetPipelined(bool enable);
+    /// Return whether physics worlds step the simulation during the rest of the frame.
+    static bool IsPipelined() { return pipelined; }
     
 protected:
     /// Handle node being assigned.
@@ -188,6 +201,20 @@ protected:
 private:
     /// Handle the scene subsystem update event, step simulation here.
     void HandleSceneSubsystemUpdate(StringHash eventType, VariantMap& eventData);
+    /// Handle the end frame event, complete a pipelined simulation step here.
+    void HandleEndFrame(StringHash eventType, VariantMap& eventData);
+    /// Handle a work item being purged from the work queue.
+    void HandleWorkItemCompleted(StringHash eventType, VariantMap& eventData);
+    /// Start a pipelined simulation step with the accumulated timestep in a worker thread.
+    void BeginPipelinedStep();
+    /// Wait for the pipelined simulation step, then apply its results.
+    void FinishPipelinedStep();
+    /// Run the Bullet simulation.
+    void StepSimulation(float timeStep);
+    /// Apply delayed world transforms, parents first.
+    void ApplyDelayedWorldTransforms();
+    /// Send the pre-step or post-step event.
+    void SendStepEvent(StringHash eventType, float timeStep);
     /// Trigger update before each physics simulation step.
     void PreStep(float timeStep);
     /// Trigger update after ecah physics simulation step.
@@ -219,6 +246,8 @@ private:
     HashSet<Pair<RigidBody*, RigidBody*> > previousCollisions_;
     /// Delayed (parented) world transform assignments.
     HashMap<RigidBody*, DelayedWorldTransform> delayedWorldTransforms_;
+    /// Rigid bodies whose scene nodes were moved during the pipelined simulation step.
+    PODVector<RigidBody*> movedRigidBodies_;
     /// Cache for collision geometry data.
     HashMap<String, SharedPtr<CollisionGeometryData> > geometryCache_;
     /// Simulation steps per second.
@@ -231,12 +260,21 @@ private:
     bool interpolation_;
     /// Applying transforms flag.
     bool applyingTransforms_;
+    /// Timestep accumulated for the next pipelined simulation step.
+    float pipelinedTimeStep_;
+    /// Pipelined simulation step in progress flag.
+    volatile bool pipelinedStepping_;
+    /// Work item of the pipelined simulation step, or null once it has been purged from the work queue.
+    WorkItem* pipelinedStepItem_;
     /// Debug renderer.
     DebugRenderer* debugRenderer_;
     /// Debug draw flags.
     int debugMode_;
     /// Debug draw depth test mode.
     bool debugDepthTest_;
+    
+    /// Pipelined simulation flag shared by all physics worlds.
+    static bool pipelined;
 };
 
 /// Register Physics library objects.
@@ -138,6 +138,15 @@ void RigidBody::ApplyAttributes()
 
 void RigidBody::getWorldTransform(btTransform &worldTrans) const
 {
+    // During a pipelined step in a worker thread the node must not be accessed. Node transform changes have already been
+    // applied to the body in OnMarkedDirty(), so keep the body's own transform
+    if (physicsWorld_ && physicsWorld_->IsPipelinedStepping())
+    {
+        if (body_)
+            worldTrans = body_->getWorldTransform();
+        return;
+    }
+    
     // We may be in a pathological state where a RigidBody exists without a scene node when this callback is fired,
     // so check to be sure
     if (node_)
@@ -155,6 +164,19 @@ void RigidBody::setWorldTransform(const btTransform &worldTrans)
     Quaternion newWorldRotation = ToQuaternion(worldTrans.getRotation());
     RigidBody* parentRigidBody = 0;
     
+    // During a pipelined step in a worker thread store all transforms for delayed assignment in the main thread.
+    // The parent rigid body will be looked up then
+    if (physicsWorld_ && physicsWorld_->IsPipelinedStepping())
+    {
+        DelayedWorldTransform delayed;
+        delayed.rigidBody_ = this;
+        delayed.parentRigidBody_ = 0;
+        delayed.worldPosition_ = newWorldPosition;
+        delayed.worldRotation_ = newWorldRotation;
+        physicsWorld_->AddDelayedWorldTransform(delayed);
+        return;
+    }
+    
     // It is possible that the RigidBody component has been kept alive via a shared pointer,
     // while its scene node has already been destroyed
     if (node_)
@@ -183,6 +205,9 @@ void RigidBody::setWorldTransform(const btTransform &worldTrans)
 
 void RigidBody::DrawDebugGeometry(DebugRenderer* debug, bool depthTest)
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (debug && physicsWorld_ && body_)
     {
         physicsWorld_->SetDebugRenderer(debug);
@@ -210,6 +235,9 @@ void RigidBody::SetMass(float mass)
 
 void RigidBody::SetPosition(Vector3 position)
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (body_)
     {
         btTransform& worldTrans = body_->getWorldTransform();
@@ -228,6 +256,9 @@ void RigidBody::SetPosition(Vector3 position)
 
 void RigidBody::SetRotation(Quaternion rotation)
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (body_)
     {
         btTransform& worldTrans = body_->getWorldTransform();
@@ -246,6 +277,9 @@ void RigidBody::SetRotation(Quaternion rotation)
 
 void RigidBody::SetTransform(const Vector3& position, const Quaternion& rotation)
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (body_)
     {
         btTransform& worldTrans = body_->getWorldTransform();
@@ -266,6 +300,9 @@ void RigidBody::SetTransform(const Vector3& position, const Quaternion& rotation
 
 void RigidBody::SetLinearVelocity(Vector3 velocity)
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (body_)
     {
         body_->setLinearVelocity(ToBtVector3(velocity));
@@ -277,6 +314,9 @@ void RigidBody::SetLinearVelocity(Vector3 velocity)
 
 void RigidBody::SetLinearFactor(Vector3 factor)
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (body_)
     {
         body_->setLinearFactor(ToBtVector3(factor));
@@ -286,6 +326,9 @@ void RigidBody::SetLinearFactor(Vector3 factor)
 
 void RigidBody::SetLinearRestThreshold(float threshold)
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (body_)
     {
         body_->setSleepingThresholds(threshold, body_->getAngularSleepingThreshold());
@@ -295,6 +338,9 @@ void RigidBody::SetLinearRestThreshold(float threshold)
 
 void RigidBody::SetLinearDamping(float damping)
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (body_)
     {
         body_->setDamping(damping, body_->getAngularDamping());
@@ -304,6 +350,9 @@ void RigidBody::SetLinearDamping(float damping)
 
 void RigidBody::SetAngularVelocity(Vector3 velocity)
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (body_)
     {
         body_->setAngularVelocity(ToBtVector3(velocity));
@@ -315,6 +364,9 @@ void RigidBody::SetAngularVelocity(Vector3 velocity)
 
 void RigidBody::SetAngularFactor(Vector3 factor)
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (body_)
     {
         body_->setAngularFactor(ToBtVector3(factor));
@@ -324,6 +376,9 @@ void RigidBody::SetAngularFactor(Vector3 factor)
 
 void RigidBody::SetAngularRestThreshold(float threshold)
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (body_)
     {
         body_->setSleepingThresholds(body_->getLinearSleepingThreshold(), threshold);
@@ -333,6 +388,9 @@ void RigidBody::SetAngularRestThreshold(float threshold)
 
 void RigidBody::SetAngularDamping(float damping)
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (body_)
     {
         body_->setDamping(body_->getLinearDamping(), damping);
@@ -342,6 +400,9 @@ void RigidBody::SetAngularDamping(float damping)
 
 void RigidBody::SetFriction(float friction)
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (body_)
     {
         body_->setFriction(friction);
@@ -351,6 +412,9 @@ void RigidBody::SetFriction(float friction)
 
 void RigidBody::SetRestitution(float restitution)
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (body_)
     {
         body_->setRestitution(restitution);
@@ -360,6 +424,9 @@ void RigidBody::SetRestitution(float restitution)
 
 void RigidBody::SetCcdRadius(float radius)
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     radius = Max(radius, 0.0f);
     if (body_)
     {
@@ -370,6 +437,9 @@ void RigidBody::SetCcdRadius(float radius)
 
 void RigidBody::SetCcdMotionThreshold(float threshold)
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     threshold = Max(threshold, 0.0f);
     if (body_)
     {
@@ -380,6 +450,9 @@ void RigidBody::SetCcdMotionThreshold(float threshold)
 
 void RigidBody::SetUseGravity(bool enable)
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (physicsWorld_ && body_ && enable != GetUseGravity())
     {
         btDiscreteDynamicsWorld* world = physicsWorld_->GetWorld();
@@ -459,6 +532,9 @@ void RigidBody::SetCollisionEventMode(CollisionEventMode mode)
 
 void RigidBody::ApplyForce(const Vector3& force)
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (body_ && force != Vector3::ZERO)
     {
         Activate();
@@ -468,6 +544,9 @@ void RigidBody::ApplyForce(const Vector3& force)
 
 void RigidBody::ApplyForce(const Vector3& force, const Vector3& position)
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (body_ && force != Vector3::ZERO)
     {
         Activate();
@@ -477,6 +556,9 @@ void RigidBody::ApplyForce(const Vector3& force, const Vector3& position)
 
 void RigidBody::ApplyTorque(const Vector3& torque)
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (body_ && torque != Vector3::ZERO)
     {
         Activate();
@@ -486,6 +568,9 @@ void RigidBody::ApplyTorque(const Vector3& torque)
 
 void RigidBody::ApplyImpulse(const Vector3& impulse)
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (body_ && impulse != Vector3::ZERO)
     {
         Activate();
@@ -495,6 +580,9 @@ void RigidBody::ApplyImpulse(const Vector3& impulse)
 
 void RigidBody::ApplyImpulse(const Vector3& impulse, const Vector3& position)
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (body_ && impulse != Vector3::ZERO)
     {
         Activate();
@@ -504,6 +592,9 @@ void RigidBody::ApplyImpulse(const Vector3& impulse, const Vector3& position)
 
 void RigidBody::ApplyTorqueImpulse(const Vector3& torque)
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (body_ && torque != Vector3::ZERO)
     {
         Activate();
@@ -513,18 +604,27 @@ void RigidBody::ApplyTorqueImpulse(const Vector3& torque)
 
 void RigidBody::ResetForces()
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (body_)
         body_->clearForces();
 }
 
 void RigidBody::Activate()
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (body_ && mass_ > 0.0f)
         body_->activate(true);
 }
 
 Vector3 RigidBody::GetPosition() const
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (body_)
         return ToVector3(body_->getWorldTransform().getOrigin());
     else
@@ -533,6 +633,9 @@ Vector3 RigidBody::GetPosition() const
 
 Quaternion RigidBody::GetRotation() const
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (body_)
         return ToQuaternion(body_->getWorldTransform().getRotation());
     else
@@ -541,6 +644,9 @@ Quaternion RigidBody::GetRotation() const
 
 Vector3 RigidBody::GetLinearVelocity() const
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (body_)
         return ToVector3(body_->getLinearVelocity());
     else
@@ -549,6 +655,9 @@ Vector3 RigidBody::GetLinearVelocity() const
 
 Vector3 RigidBody::GetLinearFactor() const
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (body_)
         return ToVector3(body_->getLinearFactor());
     else
@@ -557,6 +666,9 @@ Vector3 RigidBody::GetLinearFactor() const
 
 float RigidBody::GetLinearRestThreshold() const
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (body_)
         return body_->getLinearSleepingThreshold();
     else
@@ -565,6 +677,9 @@ float RigidBody::GetLinearRestThreshold() const
 
 float RigidBody::GetLinearDamping() const
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (body_)
         return body_->getLinearDamping();
     else
@@ -573,6 +688,9 @@ float RigidBody::GetLinearDamping() const
 
 Vector3 RigidBody::GetAngularVelocity() const
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (body_)
         return ToVector3(body_->getAngularVelocity());
     else
@@ -581,6 +699,9 @@ Vector3 RigidBody::GetAngularVelocity() const
 
 Vector3 RigidBody::GetAngularFactor() const
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (body_)
         return ToVector3(body_->getAngularFactor());
     else
@@ -589,6 +710,9 @@ Vector3 RigidBody::GetAngularFactor() const
 
 float RigidBody::GetAngularRestThreshold() const
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (body_)
         return body_->getAngularSleepingThreshold();
     else
@@ -597,6 +721,9 @@ float RigidBody::GetAngularRestThreshold() const
 
 float RigidBody::GetAngularDamping() const
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (body_)
         return body_->getAngularDamping();
     else
@@ -605,6 +732,9 @@ float RigidBody::GetAngularDamping() const
 
 float RigidBody::GetFriction() const
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (body_)
         return body_->getFriction();
     else
@@ -613,6 +743,9 @@ float RigidBody::GetFriction() const
 
 float RigidBody::GetRestitution() const
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (body_)
         return body_->getRestitution();
     else
@@ -621,6 +754,9 @@ float RigidBody::GetRestitution() const
 
 float RigidBody::GetCcdRadius() const
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (body_)
         return body_->getCcdSweptSphereRadius();
     else
@@ -629,6 +765,9 @@ float RigidBody::GetCcdRadius() const
 
 float RigidBody::GetCcdMotionThreshold() const
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (body_)
         return body_->getCcdMotionThreshold();
     else
@@ -637,6 +776,9 @@ float RigidBody::GetCcdMotionThreshold() const
 
 bool RigidBody::GetUseGravity() const
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (body_)
         return (body_->getFlags() & BT_DISABLE_WORLD_GRAVITY) == 0;
     else
@@ -645,6 +787,9 @@ bool RigidBody::GetUseGravity() const
 
 bool RigidBody::IsActive() const
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (body_)
         return body_->isActive();
     else
@@ -688,6 +833,9 @@ void RigidBody::ApplyWorldTransform(const Vector3& newWorldPosition, const Quate
 
 void RigidBody::UpdateMass()
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (body_)
     {
         btVector3 localInertia(0.0f, 0.0f, 0.0f);
@@ -727,6 +875,9 @@ void RigidBody::RemoveConstraint(Constraint* constraint)
 
 void RigidBody::ReleaseBody()
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (body_)
     {
         // Release all constraints which refer to this body
@@ -761,6 +912,14 @@ void RigidBody::OnMarkedDirty(Node* node)
             return;
         }
         
+        // During a pipelined step the body can not be accessed. Rather than waiting for the step, apply the transform when
+        // it completes
+        if (physicsWorld_ && physicsWorld_->IsPipelinedStepping())
+        {
+            physicsWorld_->AddMovedRigidBody(this);
+            return;
+        }
+        
         // Check if transform has changed from the last one set in ApplyWorldTransform()
         Vector3 newPosition = node_->GetWorldPosition();
         Quaternion newRotation = node_->GetWorldRotation();
@@ -802,6 +961,9 @@ void RigidBody::OnNodeSet(Node* node)
 
 void RigidBody::AddBodyToWorld()
 {
+    if (physicsWorld_)
+        physicsWorld_->CompletePipelinedStep();
+    
     if (!physicsWorld_)
         return;
     
@@ -50,6 +50,8 @@ class RigidBody : public Component, public btMotionState
 {
     OBJECT(RigidBody);
     
+    friend class PhysicsWorld;
+    
 public:
     /// Construct.
     RigidBody(Context* context);
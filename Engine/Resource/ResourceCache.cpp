@@ -22,9 +22,9 @@
 
 #include "Precompiled.h"
 #include "Context.h"
-#include "CoreEvents.h"
 #include "FileSystem.h"
 #include "FileWatcher.h"
+#include "IOEvents.h"
 #include "Image.h"
 #include "Log.h"
 #include "PackageFile.h"
@@ -101,6 +101,7 @@ bool ResourceCache::AddResourceDir(const String& pathName)
     {
         SharedPtr<FileWatcher> watcher(new FileWatcher(context_));
         watcher->StartWatching(fixedPath, true);
+        SubscribeToEvent(watcher, E_FILECHANGED, HANDLER(ResourceCache, HandleFileChanged));
         fileWatchers_.Push(watcher);
     }
     
@@ -224,10 +225,10 @@ void ResourceCache::ReleaseResources(ShortStringHash type, bool force)
     HashMap<ShortStringHash, ResourceGroup>::Iterator i = resourceGroups_.Find(type);
     if (i != resourceGroups_.End())
     {
-        for (HashMap<StringHash, SharedPtr<Resource> >::Iterator j = i->second_.resources_.Begin();
+        for (FlatHashMap<StringHash, SharedPtr<Resource> >::Iterator j = i->second_.resources_.Begin();
             j != i->second_.resources_.End();)
         {
-            HashMap<StringHash, SharedPtr<Resource> >::Iterator current = j++;
+            FlatHashMap<StringHash, SharedPtr<Resource> >::Iterator current = j++;
             // If other references exist, do not release, unless forced
             if (current->second_.Refs() == 1 || force)
             {
@@ -248,10 +249,10 @@ void ResourceCache::ReleaseResources(ShortStringHash type, const String& partial
     HashMap<ShortStringHash, ResourceGroup>::Iterator i = resourceGroups_.Find(type);
     if (i != resourceGroups_.End())
     {
-        for (HashMap<StringHash, SharedPtr<Resource> >::Iterator j = i->second_.resources_.Begin();
+        for (FlatHashMap<StringHash, SharedPtr<Resource> >::Iterator j = i->second_.resources_.Begin();
             j != i->second_.resources_.End();)
         {
-            HashMap<StringHash, SharedPtr<Resource> >::Iterator current = j++;
+            FlatHashMap<StringHash, SharedPtr<Resource> >::Iterator current = j++;
             if (current->second_->GetName().Contains(partialName))
             {
                 // If other references exist, do not release, unless forced
@@ -275,10 +276,10 @@ void ResourceCache::ReleaseAllResources(bool force)
     {
         bool released = false;
         
-        for (HashMap<StringHash, SharedPtr<Resource> >::Iterator j = i->second_.resources_.Begin();
+        for (FlatHashMap<StringHash, SharedPtr<Resource> >::Iterator j = i->second_.resources_.Begin();
             j != i->second_.resources_.End();)
         {
-            HashMap<StringHash, SharedPtr<Resource> >::Iterator current = j++;
+            FlatHashMap<StringHash, SharedPtr<Resource> >::Iterator current = j++;
             // If other references exist, do not release, unless forced
             if ((current->second_.Refs() == 1 && current->second_.WeakRefs() == 0) || force)
             {
@@ -332,14 +333,12 @@ void ResourceCache::SetAutoReloadResources(bool enable)
             {
                 SharedPtr<FileWatcher> watcher(new FileWatcher(context_));
                 watcher->StartWatching(resourceDirs_[i], true);
+                SubscribeToEvent(watcher, E_FILECHANGED, HANDLER(ResourceCache, HandleFileChanged));
                 fileWatchers_.Push(watcher);
             }
-
-            SubscribeToEvent(E_BEGINFRAME, HANDLER(ResourceCache, HandleBeginFrame));
         }
         else
         {
-            UnsubscribeFromEvent(E_BEGINFRAME);
             fileWatchers_.Clear();
         }
         
@@ -443,7 +442,7 @@ void ResourceCache::GetResources(PODVector<Resource*>& result, ShortStringHash t
     HashMap<ShortStringHash, ResourceGroup>::ConstIterator i = resourceGroups_.Find(type);
     if (i != resourceGroups_.End())
     {
-        for (HashMap<StringHash, SharedPtr<Resource> >::ConstIterator j = i->second_.resources_.Begin();
+        for (FlatHashMap<StringHash, SharedPtr<Resource> >::ConstIterator j = i->second_.resources_.Begin();
             j != i->second_.resources_.End(); ++j)
             result.Push(j->second_);
     }
@@ -603,7 +602,7 @@ const SharedPtr<Resource>& ResourceCache::FindResource(ShortStringHash type, Str
     HashMap<ShortStringHash, ResourceGroup>::Iterator i = resourceGroups_.Find(type);
     if (i == resourceGroups_.End())
         return noResource;
-    HashMap<StringHash, SharedPtr<Resource> >::Iterator j = i->second_.resources_.Find(nameHash);
+    FlatHashMap<StringHash, SharedPtr<Resource> >::Iterator j = i->second_.resources_.Find(nameHash);
     if (j == i->second_.resources_.End())
         return noResource;
     
@@ -623,7 +622,7 @@ void ResourceCache::ReleasePackageResources(PackageFile* package, bool force)
         for (HashMap<ShortStringHash, ResourceGroup>::Iterator j = resourceGroups_.Begin();
             j != resourceGroups_.End(); ++j)
         {
-            HashMap<StringHash, SharedPtr<Resource> >::Iterator k = j->second_.resources_.Find(nameHash);
+            FlatHashMap<StringHash, SharedPtr<Resource> >::Iterator k = j->second_.resources_.Find(nameHash);
             if (k != j->second_.resources_.End())
             {
                 // If other references exist, do not release, unless forced
@@ -651,9 +650,9 @@ void ResourceCache::UpdateResourceGroup(ShortStringHash type)
     {
         unsigned totalSize = 0;
         unsigned oldestTimer = 0;
-        HashMap<StringHash, SharedPtr<Resource> >::Iterator oldestResource = i->second_.resources_.End();
+        FlatHashMap<StringHash, SharedPtr<Resource> >::Iterator oldestResource = i->second_.resources_.End();
         
-        for (HashMap<StringHash, SharedPtr<Resource> >::Iterator j = i->second_.resources_.Begin();
+        for (FlatHashMap<StringHash, SharedPtr<Resource> >::Iterator j = i->second_.resources_.Begin();
             j != i->second_.resources_.End(); ++j)
         {
             totalSize += j->second_->GetMemoryUse();
@@ -681,23 +680,20 @@ void ResourceCache::UpdateResourceGroup(ShortStringHash type)
     }
 }
 
-void ResourceCache::HandleBeginFrame(StringHash eventType, VariantMap& eventData)
+void ResourceCache::HandleFileChanged(StringHash eventType, VariantMap& eventData)
 {
-    for (unsigned i = 0; i < fileWatchers_.Size(); ++i)
+    using namespace FileChanged;
+    
+    const String& fileName = eventData[P_FILENAME].GetString();
+    
+    // If the filename is a resource we keep track of, reload it
+    for (HashMap<ShortStringHash, ResourceGroup>::Iterator j = resourceGroups_.Begin(); j != resourceGroups_.End(); ++j)
     {
-        String fileName;
-        while (fileWatchers_[i]->GetNextChange(fileName))
+        FlatHashMap<StringHash, SharedPtr<Resource> >::Iterator k = j->second_.resources_.Find(StringHash(fileName));
+        if (k != j->second_.resources_.End())
         {
-            // If the filename is a resource we keep track of, reload it
-            for (HashMap<ShortStringHash, ResourceGroup>::Iterator j = resourceGroups_.Begin(); j != resourceGroups_.End(); ++j)
-            {
-                HashMap<StringHash, SharedPtr<Resource> >::Iterator k = j->second_.resources_.Find(StringHash(fileName));
-                if (k != j->second_.resources_.End())
-                {
-                    LOGDEBUG("Reloading changed resource " + fileName);
-                    ReloadResource(k->second_);
-                }
-            }
+            LOGDEBUG("Reloading changed resource " + fileName);
+            ReloadResource(k->second_);
         }
     }
 }
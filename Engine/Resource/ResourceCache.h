@@ -23,6 +23,7 @@
 #pragma once
 
 #include "File.h"
+#include "FlatHashMap.h"
 #include "Resource.h"
 
 namespace Urho3D
@@ -46,7 +47,7 @@ struct ResourceGroup
     /// Current memory use.
     unsigned memoryUse_;
     /// Resources.
-    HashMap<StringHash, SharedPtr<Resource> > resources_;
+    FlatHashMap<StringHash, SharedPtr<Resource> > resources_;
 };
 
 /// %Resource cache subsystem. Loads resources on demand and stores them for later access.
@@ -140,8 +141,8 @@ private:
     void ReleasePackageResources(PackageFile* package, bool force = false);
     /// Update a resource group. Recalculate memory use and release resources if over memory budget.
     void UpdateResourceGroup(ShortStringHash type);
-    /// Handle begin frame event. Automatic resource reloads are processed here.
-    void HandleBeginFrame(StringHash eventType, VariantMap& eventData);
+    /// Handle a file watcher's file changed event. Automatic resource reloads are processed here.
+    void HandleFileChanged(StringHash eventType, VariantMap& eventData);
     
     /// Resources by type.
     HashMap<ShortStringHash, ResourceGroup> resourceGroups_;
@@ -45,6 +45,15 @@ Component::~Component()
 {
 }
 
+void Component::ResetComponent()
+{
+    node_ = 0;
+    id_ = 0;
+    networkUpdate_ = false;
+    delete networkState_;
+    networkState_ = 0;
+}
+
 void Component::OnSetAttribute(const AttributeInfo& attr, const Variant& src)
 {
     Serializable::OnSetAttribute(attr, src);
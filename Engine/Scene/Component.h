@@ -94,6 +94,8 @@ protected:
     void SetID(unsigned id);
     /// Set scene node. Called by Node when creating the component.
     void SetNode(Node* node);
+    /// Reset the component base state. Called by subclasses that support reuse by a pooling factory.
+    void ResetComponent();
     
     /// Scene node.
     Node* node_;
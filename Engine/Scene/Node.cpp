@@ -25,6 +25,7 @@
 #include "Context.h"
 #include "Log.h"
 #include "MemoryBuffer.h"
+#include "PrefabTemplate.h"
 #include "Profiler.h"
 #include "ReplicationState.h"
 #include "Scene.h"
@@ -45,6 +46,8 @@ Node::Node(Context* context) :
     Serializable(context),
     worldTransform_(Matrix3x4::IDENTITY),
     dirty_(false),
+    transformQueued_(false),
+    notifyPending_(false),
     networkUpdate_(false),
     rotateCount_(0),
     parent_(0),
@@ -67,6 +70,42 @@ Node::~Node()
         scene_->NodeRemoved(this);
 }
 
+bool Node::ResetForReuse()
+{
+    // Subclasses such as Scene may have state of their own
+    if (GetType() != GetTypeStatic())
+        return false;
+    
+    // Release children and components and leave the scene as in the destructor. The containers keep their capacity
+    RemoveAllChildren();
+    RemoveAllComponents();
+    if (scene_)
+        scene_->NodeRemoved(this);
+    
+    worldTransform_ = Matrix3x4::IDENTITY;
+    dirty_ = false;
+    transformQueued_ = false;
+    notifyPending_ = false;
+    networkUpdate_ = false;
+    rotateCount_ = 0;
+    parent_ = 0;
+    id_ = 0;
+    position_ = Vector3::ZERO;
+    rotation_ = Quaternion::IDENTITY;
+    scale_ = Vector3::ONE;
+    listeners_.Clear();
+    dependencyNodes_.Clear();
+    owner_ = 0;
+    name_.Clear();
+    nameHash_ = StringHash();
+    attrBuffer_.Clear();
+    vars_.Clear();
+    delete networkState_;
+    networkState_ = 0;
+    
+    return true;
+}
+
 void Node::RegisterObject(Context* context)
 {
     context->RegisterFactory<Node>();
@@ -445,23 +484,40 @@ void Node::MarkDirty()
 
     dirty_ = true;
     
-    // Notify listener components first, then mark child nodes
-    for (Vector<WeakPtr<Component> >::Iterator i = listeners_.Begin(); i != listeners_.End();)
+    // If the parent is dirty, it or one of its parents is already queued for the batched world transform update, which covers
+    // this node as well
+    if (scene_ && !transformQueued_ && (!parent_ || !parent_->dirty_))
+        scene_->QueueTransformUpdate(this);
+    
+    // If the scene defers dirty processing, only mark the child nodes now. The listeners are notified later in one pass.
+    // If the parent has a notification pending, it or one of its parents is already queued, which covers this node as well
+    if (scene_ && scene_->GetDeferredMarkedDirty() && !scene_->IsThreadedUpdate())
     {
-        if (*i)
-        {
-            (*i)->OnMarkedDirty(this);
-            ++i;
-        }
-        // If listener has expired, erase from list
-        else
-            i = listeners_.Erase(i);
+        if (!notifyPending_ && (!parent_ || !parent_->notifyPending_))
+            scene_->QueueMarkedDirty(this);
+        MarkDirtyDeferred();
+        return;
     }
     
+    // Notify listener components first, then mark child nodes
+    NotifyListeners();
+    
     for (Vector<SharedPtr<Node> >::Iterator i = children_.Begin(); i != children_.End(); ++i)
         (*i)->MarkDirty();
 }
 
+void Node::NotifyMarkedDirty()
+{
+    notifyPending_ = false;
+    NotifyListeners();
+    
+    for (Vector<SharedPtr<Node> >::Iterator i = children_.Begin(); i != children_.End(); ++i)
+    {
+        if ((*i)->notifyPending_)
+            (*i)->NotifyMarkedDirty();
+    }
+}
+
 Node* Node::CreateChild(const String& name, CreateMode mode)
 {
     Node* newNode = CreateChild(0, mode);
@@ -523,7 +579,7 @@ Component* Node::CreateComponent(ShortStringHash type, CreateMode mode, unsigned
     SharedPtr<Component> newComponent = DynamicCast<Component>(context_->CreateObject(type));
     if (!newComponent)
     {
-        LOGERROR("Could not create unknown component type " + type.ToString());
+        LOGERROR("Could not create unknown component type " + type.Reverse());
         return 0;
     }
     
@@ -593,9 +649,10 @@ Node* Node::Clone(CreateMode mode)
     
     PROFILE(CloneNode);
     
-    SceneResolver resolver;
-    Node* clone = CloneRecursive(parent_, resolver, mode);
-    resolver.Resolve();
+    // Copy the attributes through a prefab template, which also remaps the node and component ID attributes
+    SharedPtr<PrefabTemplate> prefab(new PrefabTemplate(context_));
+    prefab->Define(this);
+    Node* clone = prefab->Instantiate(parent_, mode);
     clone->ApplyAttributes();
     return clone;
 }
@@ -865,7 +922,7 @@ void Node::SetNetParentAttr(const PODVector<unsigned char>& value)
         StringHash nameHash = buf.ReadStringHash();
         Node* parentNode = baseNode->GetChild(nameHash, true);
         if (!parentNode)
-            LOGWARNING("Failed to find parent node with name hash " + nameHash.ToString());
+            LOGWARNING("Failed to find parent node with name hash " + nameHash.Reverse());
         else
             parentNode->AddChild(this);
     }
@@ -1137,7 +1194,10 @@ void Node::MarkReplicationDirty()
 
 Node* Node::CreateChild(unsigned id, CreateMode mode)
 {
-    SharedPtr<Node> newNode(new Node(context_));
+    // Create through the factory if registered, so that object pooling applies
+    SharedPtr<Node> newNode = StaticCast<Node>(context_->CreateObject(Node::GetTypeStatic()));
+    if (!newNode)
+        newNode = new Node(context_);
     
     // If zero ID specified, or the ID is already taken, let the scene assign
     if (scene_)
@@ -1191,10 +1251,60 @@ void Node::UpdateWorldTransform() const
     dirty_ = false;
 }
 
+void Node::UpdateWorldTransforms()
+{
+    if (dirty_)
+    {
+        if (parent_)
+            worldTransform_ = parent_->worldTransform_ * GetTransform();
+        else
+            worldTransform_ = GetTransform();
+        dirty_ = false;
+    }
+    
+    // Child nodes may be dirty even if this node is not, in case it was updated on demand in between
+    transformQueued_ = false;
+    for (Vector<SharedPtr<Node> >::Iterator i = children_.Begin(); i != children_.End(); ++i)
+        (*i)->UpdateWorldTransforms();
+}
+
+void Node::MarkDirtyDeferred()
+{
+    notifyPending_ = true;
+    
+    for (Vector<SharedPtr<Node> >::Iterator i = children_.Begin(); i != children_.End(); ++i)
+    {
+        Node* child = *i;
+        if (!child->dirty_)
+        {
+            child->dirty_ = true;
+            child->MarkDirtyDeferred();
+        }
+    }
+}
+
+void Node::NotifyListeners()
+{
+    for (Vector<WeakPtr<Component> >::Iterator i = listeners_.Begin(); i != listeners_.End();)
+    {
+        if (*i)
+        {
+            (*i)->OnMarkedDirty(this);
+            ++i;
+        }
+        // If listener has expired, erase from list
+        else
+            i = listeners_.Erase(i);
+    }
+}
+
 void Node::RemoveChild(Vector<SharedPtr<Node> >::Iterator i)
 {
     (*i)->parent_ = 0;
     (*i)->MarkDirty();
+    // A pending deferred notification is no longer reachable through the old parent, so queue the node directly
+    if ((*i)->notifyPending_ && (*i)->scene_)
+        (*i)->scene_->QueueMarkedDirty(*i);
     (*i)->MarkNetworkUpdate();
     children_.Erase(i);
 }
@@ -1222,45 +1332,6 @@ void Node::GetChildrenWithComponentRecursive(PODVector<Node*>& dest, ShortString
     }
 }
 
-Node* Node::CloneRecursive(Node* parent, SceneResolver& resolver, CreateMode mode)
-{
-    // Create clone node
-    Node* cloneNode = parent->CreateChild(0, (mode == REPLICATED && id_ < FIRST_LOCAL_ID) ? REPLICATED : LOCAL);
-    resolver.AddNode(id_, cloneNode);
-    
-    // Copy attributes
-    unsigned numAttributes = GetNumAttributes();
-    for (unsigned j = 0; j < numAttributes; ++j)
-        cloneNode->SetAttribute(j, GetAttribute(j));
-    
-    // Clone components
-    for (Vector<SharedPtr<Component> >::ConstIterator i = components_.Begin(); i != components_.End(); ++i)
-    {
-        Component* component = *i;
-        Component* cloneComponent = cloneNode->CreateComponent(component->GetType(), (mode == REPLICATED && component->GetID() <
-            FIRST_LOCAL_ID) ? REPLICATED : LOCAL);
-        if (!cloneComponent)
-        {
-            LOGERROR("Could not clone component " + component->GetTypeName());
-            continue;
-        }
-        resolver.AddComponent(component->GetID(), cloneComponent);
-        
-        numAttributes = component->GetNumAttributes();
-        for (unsigned j = 0; j < numAttributes; ++j)
-            cloneComponent->SetAttribute(j, component->GetAttribute(j));
-    }
-    
-    // Clone child nodes recursively
-    for (Vector<SharedPtr<Node> >::ConstIterator i = children_.Begin(); i != children_.End(); ++i)
-    {
-        Node* node = *i;
-        node->CloneRecursive(cloneNode, resolver, mode);
-    }
-    
-    return cloneNode;
-}
-
 void Node::RemoveComponent(Vector<SharedPtr<Component> >::Iterator i)
 {
     WeakPtr<Component> componentWeak(*i);
@@ -149,7 +149,7 @@ public:
     void RemoveComponent(ShortStringHash type);
     /// Remove all components from this node.
     void RemoveAllComponents();
-    /// Clone scene node, components and child nodes. Return the clone.
+    /// Clone scene node, components and child nodes. Only the attributes that are saved to file are copied. Return the clone.
     Node* Clone(CreateMode mode = REPLICATED);
     /// Remove from the parent node. If no other shared pointer references exist, causes immediate deletion.
     void Remove();
@@ -283,6 +283,16 @@ public:
     void SetScene(Scene* scene);
     /// Reset scene. Called by Scene.
     void ResetScene();
+    /// Set queued for batched world transform update flag. Called by Scene.
+    void SetTransformQueued(bool enable) { transformQueued_ = enable; }
+    /// Return whether is queued for batched world transform update.
+    bool IsTransformQueued() const { return transformQueued_; }
+    /// Recalculate the world transforms of this node and its child nodes that need update. The parent's world transform must be up to date. Called by Scene during the batched world transform update.
+    void UpdateWorldTransforms();
+    /// Return whether listener notification of a deferred dirty marking is pending.
+    bool IsNotifyPending() const { return notifyPending_; }
+    /// Notify the listeners of this node and its child nodes that have a deferred dirty marking pending. Called by Scene.
+    void NotifyMarkedDirty();
     /// Set network position attribute.
     void SetNetPositionAttr(const Vector3& value);
     /// Set network rotation attribute.
@@ -315,20 +325,25 @@ public:
     void AddComponent(Component* component, unsigned id, CreateMode mode);
     
 protected:
+    /// Reset to the state of a newly constructed node for reuse by a pooling factory. Return false for subclasses.
+    virtual bool ResetForReuse();
+    
     /// User variables.
     VariantMap vars_;
 
 private:
     /// Recalculate the world transform.
     void UpdateWorldTransform() const;
+    /// Mark child nodes dirty and defer the listener notifications of this node and the child nodes.
+    void MarkDirtyDeferred();
+    /// Notify listener components that the node has been marked dirty.
+    void NotifyListeners();
     /// Remove child node by iterator.
     void RemoveChild(Vector<SharedPtr<Node> >::Iterator i);
     /// Return child nodes recursively.
     void GetChildrenRecursive(PODVector<Node*>& dest) const;
     /// Return child nodes with a specific component recursively.
     void GetChildrenWithComponentRecursive(PODVector<Node*>& dest, ShortStringHash type) const;
-    /// Clone node recursively.
-    Node* CloneRecursive(Node* parent, SceneResolver& resolver, CreateMode mode);
     /// Remove a component from this node with the specified iterator.
     void RemoveComponent(Vector<SharedPtr<Component> >::Iterator i);
    
@@ -336,6 +351,10 @@ private:
     mutable Matrix3x4 worldTransform_;
     /// World transform needs update flag.
     mutable bool dirty_;
+    /// Queued for batched world transform update flag.
+    bool transformQueued_;
+    /// Deferred dirty listener notification pending flag.
+    bool notifyPending_;
     /// Network update queued flag.
     bool networkUpdate_;
     /// Consecutive rotation count for rotation renormalization.
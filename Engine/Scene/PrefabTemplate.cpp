@@ -0,0 +1,478 @@
+//
+// Copyright (c) 2008-2013 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "Precompiled.h"
+#include "Component.h"
+#include "Context.h"
+#include "FileSystem.h"
+#include "Log.h"
+#include "PrefabTemplate.h"
+#include "Profiler.h"
+#include "Scene.h"
+#include "VectorBuffer.h"
+#include "XMLFile.h"
+
+#include "DebugNew.h"
+
+namespace Urho3D
+{
+
+/// Read the file attribute values of a serializable into a value vector.
+static void GetFileAttributes(Serializable* serializable, Vector<Variant>& values)
+{
+    values.Clear();
+    const Vector<AttributeInfo>* attributes = serializable->GetAttributes();
+    if (!attributes)
+        return;
+    
+    values.Resize(attributes->Size());
+    for (unsigned i = 0; i < attributes->Size(); ++i)
+    {
+        const AttributeInfo& attr = attributes->At(i);
+        if (attr.mode_ & AM_FILE)
+            serializable->OnGetAttribute(attr, values[i]);
+    }
+}
+
+OBJECTTYPESTATIC(PrefabTemplate);
+
+PrefabTemplate::PrefabTemplate(Context* context) :
+    Resource(context),
+    threadedLoad_(false)
+{
+}
+
+PrefabTemplate::~PrefabTemplate()
+{
+}
+
+void PrefabTemplate::RegisterObject(Context* context)
+{
+    context->RegisterFactory<PrefabTemplate>();
+}
+
+bool PrefabTemplate::Load(Deserializer& source)
+{
+    PROFILE(LoadPrefabTemplate);
+    
+    if (GetExtension(source.GetName()) == ".xml")
+    {
+        SharedPtr<XMLFile> xml(new XMLFile(context_));
+        if (!xml->Load(source))
+            return false;
+        
+        return LoadXML(xml->GetRoot());
+    }
+    else
+        return LoadBinary(source);
+}
+
+bool PrefabTemplate::LoadBinary(Deserializer& source)
+{
+    Clear();
+    
+    unsigned nodeID = source.ReadUInt();
+    if (!LoadNode(source, nodeID, M_MAX_UNSIGNED))
+    {
+        Clear();
+        return false;
+    }
+    
+    FinishLoad();
+    return true;
+}
+
+bool PrefabTemplate::LoadXML(const XMLElement& source)
+{
+    Clear();
+    
+    if (!LoadNodeXML(source, M_MAX_UNSIGNED))
+    {
+        Clear();
+        return false;
+    }
+    
+    FinishLoad();
+    return true;
+}
+
+bool PrefabTemplate::LoadSceneNode(Deserializer& source, unsigned id)
+{
+    Clear();
+    
+    threadedLoad_ = true;
+    bool success = LoadNode(source, id, M_MAX_UNSIGNED);
+    threadedLoad_ = false;
+    
+    if (!success)
+    {
+        Clear();
+        return false;
+    }
+    
+    // The original IDs are kept, so there is nothing to remap
+    FinishLoad(false);
+    return true;
+}
+
+bool PrefabTemplate::Define(Node* node)
+{
+    Clear();
+    
+    // The scene itself can not be instantiated
+    if (!node || node == node->GetScene())
+    {
+        LOGERROR("Can not define prefab template from a null node or a scene");
+        return false;
+    }
+    
+    DefineNode(node, M_MAX_UNSIGNED);
+    FinishLoad();
+    return true;
+}
+
+void PrefabTemplate::Clear()
+{
+    nodes_.Clear();
+    components_.Clear();
+    references_.Clear();
+    SetMemoryUse(0);
+}
+
+Node* PrefabTemplate::Instantiate(Node* parent, CreateMode mode) const
+{
+    if (!parent || nodes_.Empty())
+        return 0;
+    
+    PODVector<Node*> newNodes(nodes_.Size());
+    PODVector<Component*> newComponents(components_.Size());
+    
+    // Nodes are stored depth-first, so the parent of each node has already been created
+    for (unsigned i = 0; i < nodes_.Size(); ++i)
+    {
+        const PrefabNode& node = nodes_[i];
+        Node* parentNode = i ? newNodes[node.parent_] : parent;
+        Node* newNode = parentNode->CreateChild(0, (mode == REPLICATED && node.id_ < FIRST_LOCAL_ID) ? REPLICATED : LOCAL);
+        newNode->LoadValues(node.values_);
+        newNodes[i] = newNode;
+        
+        for (unsigned j = node.firstComponent_; j < node.firstComponent_ + node.numComponents_; ++j)
+        {
+            const PrefabComponent& component = components_[j];
+            Component* newComponent = newNode->CreateComponent(component.type_, (mode == REPLICATED && component.id_ <
+                FIRST_LOCAL_ID) ? REPLICATED : LOCAL);
+            if (newComponent)
+                newComponent->LoadValues(component.values_);
+            newComponents[j] = newComponent;
+        }
+    }
+    
+    // Assign the new IDs to the node and component ID attributes now that all nodes and components exist
+    for (unsigned i = 0; i < references_.Size(); ++i)
+    {
+        const PrefabReference& reference = references_[i];
+        Component* component = newComponents[reference.component_];
+        if (!component)
+            continue;
+        
+        unsigned newID = 0;
+        if (reference.node_)
+            newID = newNodes[reference.target_]->GetID();
+        else if (newComponents[reference.target_])
+            newID = newComponents[reference.target_]->GetID();
+        
+        if (newID)
+            component->SetAttribute(reference.attribute_, Variant(newID));
+    }
+    
+    return newNodes[0];
+}
+
+Node* PrefabTemplate::Instantiate(Node* parent, SceneResolver& resolver) const
+{
+    if (!parent || nodes_.Empty())
+        return 0;
+    
+    PODVector<Node*> newNodes(nodes_.Size());
+    
+    for (unsigned i = 0; i < nodes_.Size(); ++i)
+    {
+        const PrefabNode& node = nodes_[i];
+        Node* parentNode = i ? newNodes[node.parent_] : parent;
+        Node* newNode = parentNode->CreateChild(node.id_, node.id_ < FIRST_LOCAL_ID ? REPLICATED : LOCAL);
+        resolver.AddNode(node.id_, newNode);
+        newNode->LoadValues(node.values_);
+        newNodes[i] = newNode;
+        
+        for (unsigned j = node.firstComponent_; j < node.firstComponent_ + node.numComponents_; ++j)
+        {
+            const PrefabComponent& component = components_[j];
+            Component* newComponent = newNode->CreateComponent(component.type_, component.id_ < FIRST_LOCAL_ID ? REPLICATED :
+                LOCAL, component.id_);
+            if (newComponent)
+            {
+                resolver.AddComponent(component.id_, newComponent);
+                newComponent->LoadValues(component.values_);
+            }
+        }
+    }
+    
+    return newNodes[0];
+}
+
+bool PrefabTemplate::LoadNode(Deserializer& source, unsigned id, unsigned parent)
+{
+    unsigned index = nodes_.Size();
+    nodes_.Resize(index + 1);
+    nodes_[index].id_ = id;
+    nodes_[index].parent_ = parent;
+    nodes_[index].firstComponent_ = components_.Size();
+    nodes_[index].numComponents_ = 0;
+    if (!DecodeBinary(Node::GetTypeStatic(), source, nodes_[index].values_))
+        return false;
+    
+    unsigned numComponents = source.ReadVLE();
+    for (unsigned i = 0; i < numComponents; ++i)
+    {
+        VectorBuffer compBuffer(source, source.ReadVLE());
+        ShortStringHash compType = compBuffer.ReadShortStringHash();
+        unsigned compID = compBuffer.ReadUInt();
+        if (!context_->GetObjectFactories().Contains(compType))
+        {
+            // When loading in a worker thread, keep the component so that the error is logged on instantiation instead
+            if (!threadedLoad_)
+            {
+                LOGERROR("Could not create unknown component type " + compType.Reverse());
+                continue;
+            }
+        }
+        
+        components_.Resize(components_.Size() + 1);
+        PrefabComponent& component = components_.Back();
+        component.type_ = compType;
+        component.id_ = compID;
+        if (!DecodeBinary(compType, compBuffer, component.values_))
+            return false;
+        ++nodes_[index].numComponents_;
+    }
+    
+    unsigned numChildren = source.ReadVLE();
+    for (unsigned i = 0; i < numChildren; ++i)
+    {
+        unsigned childID = source.ReadUInt();
+        if (!LoadNode(source, childID, index))
+            return false;
+    }
+    
+    return true;
+}
+
+bool PrefabTemplate::LoadNodeXML(const XMLElement& source, unsigned parent)
+{
+    unsigned index = nodes_.Size();
+    nodes_.Resize(index + 1);
+    nodes_[index].id_ = source.GetInt("id");
+    nodes_[index].parent_ = parent;
+    nodes_[index].firstComponent_ = components_.Size();
+    nodes_[index].numComponents_ = 0;
+    if (!DecodeXML(Node::GetTypeStatic(), source, nodes_[index].values_))
+        return false;
+    
+    XMLElement compElem = source.GetChild("component");
+    while (compElem)
+    {
+        ShortStringHash compType(compElem.GetAttribute("type"));
+        if (context_->GetObjectFactories().Contains(compType))
+        {
+            components_.Resize(components_.Size() + 1);
+            PrefabComponent& component = components_.Back();
+            component.type_ = compType;
+            component.id_ = compElem.GetInt("id");
+            if (!DecodeXML(compType, compElem, component.values_))
+                return false;
+            ++nodes_[index].numComponents_;
+        }
+        else
+            LOGERROR("Could not create unknown component type " + String(compElem.GetAttribute("type")));
+        
+        compElem = compElem.GetNext("component");
+    }
+    
+    XMLElement childElem = source.GetChild("node");
+    while (childElem)
+    {
+        if (!LoadNodeXML(childElem, index))
+            return false;
+        
+        childElem = childElem.GetNext("node");
+    }
+    
+    return true;
+}
+
+void PrefabTemplate::DefineNode(Node* node, unsigned parent)
+{
+    unsigned index = nodes_.Size();
+    nodes_.Resize(index + 1);
+    nodes_[index].id_ = node->GetID();
+    nodes_[index].parent_ = parent;
+    nodes_[index].firstComponent_ = components_.Size();
+    nodes_[index].numComponents_ = 0;
+    GetFileAttributes(node, nodes_[index].values_);
+    
+    const Vector<SharedPtr<Component> >& components = node->GetComponents();
+    for (unsigned i = 0; i < components.Size(); ++i)
+    {
+        Component* component = components[i];
+        components_.Resize(components_.Size() + 1);
+        PrefabComponent& newComponent = components_.Back();
+        newComponent.type_ = component->GetType();
+        newComponent.id_ = component->GetID();
+        GetFileAttributes(component, newComponent.values_);
+        ++nodes_[index].numComponents_;
+    }
+    
+    const Vector<SharedPtr<Node> >& children = node->GetChildren();
+    for (unsigned i = 0; i < children.Size(); ++i)
+        DefineNode(children[i], index);
+}
+
+bool PrefabTemplate::DecodeBinary(ShortStringHash type, Deserializer& source, Vector<Variant>& values)
+{
+    values.Clear();
+    const Vector<AttributeInfo>* attributes = context_->GetAttributes(type);
+    if (!attributes)
+        return true;
+    
+    values.Resize(attributes->Size());
+    for (unsigned i = 0; i < attributes->Size(); ++i)
+    {
+        const AttributeInfo& attr = attributes->At(i);
+        if (!(attr.mode_ & AM_FILE))
+            continue;
+        
+        if (!Serializable::DecodeAttribute(attr, source, values[i]))
+        {
+            if (!threadedLoad_)
+                LOGERROR("Could not load prefab template " + GetName() + ", stream not open or at end");
+            return false;
+        }
+    }
+    
+    return true;
+}
+
+bool PrefabTemplate::DecodeXML(ShortStringHash type, const XMLElement& source, Vector<Variant>& values)
+{
+    values.Clear();
+    if (source.IsNull())
+    {
+        LOGERROR("Could not load prefab template " + GetName() + ", null source element");
+        return false;
+    }
+    
+    const Vector<AttributeInfo>* attributes = context_->GetAttributes(type);
+    if (!attributes)
+        return true;
+    
+    values.Resize(attributes->Size());
+    XMLElement attrElem = source.GetChild("attribute");
+    unsigned startIndex = 0;
+    
+    while (attrElem)
+    {
+        Variant value;
+        unsigned index = Serializable::DecodeAttributeXML(context_, *attributes, attrElem, startIndex, value);
+        if (index != M_MAX_UNSIGNED)
+            values[index] = value;
+        
+        attrElem = attrElem.GetNext("attribute");
+    }
+    
+    return true;
+}
+
+void PrefabTemplate::FinishLoad(bool resolveIDs)
+{
+    HashMap<unsigned, unsigned> nodeIndices;
+    HashMap<unsigned, unsigned> componentIndices;
+    unsigned memoryUse = sizeof(PrefabTemplate);
+    
+    for (unsigned i = 0; i < nodes_.Size(); ++i)
+    {
+        if (resolveIDs && nodes_[i].id_)
+            nodeIndices[nodes_[i].id_] = i;
+        memoryUse += sizeof(PrefabNode) + nodes_[i].values_.Size() * sizeof(Variant);
+    }
+    for (unsigned i = 0; i < components_.Size(); ++i)
+    {
+        if (resolveIDs && components_[i].id_)
+            componentIndices[components_[i].id_] = i;
+        memoryUse += sizeof(PrefabComponent) + components_[i].values_.Size() * sizeof(Variant);
+    }
+    
+    // Nodes do not have component or node ID attributes, so only have to go through components
+    references_.Clear();
+    for (unsigned i = 0; resolveIDs && i < components_.Size(); ++i)
+    {
+        PrefabComponent& component = components_[i];
+        const Vector<AttributeInfo>* attributes = context_->GetAttributes(component.type_);
+        if (!attributes)
+            continue;
+        
+        for (unsigned j = 0; j < component.values_.Size(); ++j)
+        {
+            const AttributeInfo& attr = attributes->At(j);
+            if (!(attr.mode_ & (AM_NODEID | AM_COMPONENTID)))
+                continue;
+            
+            unsigned oldID = component.values_[j].GetInt();
+            if (!oldID)
+                continue;
+            
+            bool isNode = (attr.mode_ & AM_NODEID) != 0;
+            const HashMap<unsigned, unsigned>& indices = isNode ? nodeIndices : componentIndices;
+            HashMap<unsigned, unsigned>::ConstIterator k = indices.Find(oldID);
+            if (k == indices.End())
+            {
+                LOGWARNING("Could not resolve " + String(isNode ? "node" : "component") + " ID " + String(oldID));
+                continue;
+            }
+            
+            PrefabReference reference;
+            reference.component_ = i;
+            reference.attribute_ = j;
+            reference.target_ = k->second_;
+            reference.node_ = isNode;
+            references_.Push(reference);
+            
+            // The new ID is assigned once all nodes and components have been instantiated
+            component.values_[j] = Variant::EMPTY;
+        }
+    }
+    
+    memoryUse += references_.Size() * sizeof(PrefabReference);
+    SetMemoryUse(memoryUse);
+}
+
+}
@@ -0,0 +1,135 @@
+//
+// Copyright (c) 2008-2013 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "Node.h"
+#include "Resource.h"
+
+namespace Urho3D
+{
+
+class SceneResolver;
+class XMLElement;
+
+/// Decoded node in a prefab template.
+struct PrefabNode
+{
+    /// Original node ID.
+    unsigned id_;
+    /// Index of the parent node in the template, or M_MAX_UNSIGNED for the root node.
+    unsigned parent_;
+    /// Index of the first component in the template.
+    unsigned firstComponent_;
+    /// Number of components.
+    unsigned numComponents_;
+    /// Attribute values, indexed as the attribute descriptions. Attributes that are not loaded from file are empty.
+    Vector<Variant> values_;
+};
+
+/// Decoded component in a prefab template.
+struct PrefabComponent
+{
+    /// Component type.
+    ShortStringHash type_;
+    /// Original component ID.
+    unsigned id_;
+    /// Attribute values, indexed as the attribute descriptions. Attributes that are not loaded from file are empty.
+    Vector<Variant> values_;
+};
+
+/// Node or component ID attribute that refers to a node or component inside the same prefab template.
+struct PrefabReference
+{
+    /// Index of the component that holds the attribute.
+    unsigned component_;
+    /// Attribute index.
+    unsigned attribute_;
+    /// Index of the referred node or component.
+    unsigned target_;
+    /// Refers to a node flag. Otherwise refers to a component.
+    bool node_;
+};
+
+/// %Scene content resource that is decoded once and then instantiated by direct attribute copy, without re-parsing the data or resolving IDs through a SceneResolver.
+class PrefabTemplate : public Resource
+{
+    OBJECT(PrefabTemplate);
+    
+public:
+    /// Construct.
+    PrefabTemplate(Context* context);
+    /// Destruct.
+    virtual ~PrefabTemplate();
+    /// Register object factory.
+    static void RegisterObject(Context* context);
+    
+    /// Load resource. Data from a file with the .xml extension is loaded as XML, otherwise as binary node data. Return true if successful.
+    virtual bool Load(Deserializer& source);
+    /// Load from binary node data, as written by Node::Save(). Return true if successful.
+    bool LoadBinary(Deserializer& source);
+    /// Load from an XML node element. Return true if successful.
+    bool LoadXML(const XMLElement& source);
+    /// Load a node of a scene file from binary data, after its ID has been read, keeping the original IDs for a SceneResolver. Does not log and can be called from a worker thread. Return true if successful.
+    bool LoadSceneNode(Deserializer& source, unsigned id);
+    /// Define from an existing node, its components and child nodes. Return true if successful.
+    bool Define(Node* node);
+    /// Remove all content.
+    void Clear();
+    /// Instantiate the content as a child of a parent node. Attributes are not applied, see Node::ApplyAttributes(). Return the root node, or null if the template is empty.
+    Node* Instantiate(Node* parent, CreateMode mode = REPLICATED) const;
+    /// Instantiate the content as a child of a parent node with the original node and component IDs, and add the created objects to a SceneResolver. Return the root node, or null if the template is empty.
+    Node* Instantiate(Node* parent, SceneResolver& resolver) const;
+    
+    /// Return number of nodes, including the root node.
+    unsigned GetNumNodes() const { return nodes_.Size(); }
+    /// Return number of components.
+    unsigned GetNumComponents() const { return components_.Size(); }
+    /// Return number of node and component ID attributes remapped on instantiation.
+    unsigned GetNumReferences() const { return references_.Size(); }
+    
+private:
+    /// Load a node from binary data recursively.
+    bool LoadNode(Deserializer& source, unsigned id, unsigned parent);
+    /// Load a node from XML data recursively.
+    bool LoadNodeXML(const XMLElement& source, unsigned parent);
+    /// Define a node from an existing node recursively.
+    void DefineNode(Node* node, unsigned parent);
+    /// Decode attribute values of an object type from binary data. Return true if successful.
+    bool DecodeBinary(ShortStringHash type, Deserializer& source, Vector<Variant>& values);
+    /// Decode attribute values of an object type from XML data. Return true if successful.
+    bool DecodeXML(ShortStringHash type, const XMLElement& source, Vector<Variant>& values);
+    /// Optionally find node and component ID attributes that refer inside the template, and update memory use.
+    void FinishLoad(bool resolveIDs = true);
+    
+    /// Nodes in depth-first order.
+    Vector<PrefabNode> nodes_;
+    /// Components. The components of each node are contiguous.
+    Vector<PrefabComponent> components_;
+    /// ID attributes to remap.
+    PODVector<PrefabReference> references_;
+    /// Loading in a worker thread flag. Suppresses logging.
+    bool threadedLoad_;
+};
+
+}
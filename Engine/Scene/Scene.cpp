@@ -26,7 +26,9 @@
 #include "CoreEvents.h"
 #include "File.h"
 #include "Log.h"
+#include "MemoryBuffer.h"
 #include "PackageFile.h"
+#include "PrefabTemplate.h"
 #include "Profiler.h"
 #include "ReplicationState.h"
 #include "Scene.h"
@@ -42,13 +44,128 @@ namespace Urho3D
 
 static const int ASYNC_LOAD_MIN_FPS = 30;
 static const int ASYNC_LOAD_MAX_MSEC = (int)(1000.0f / ASYNC_LOAD_MIN_FPS);
+static const unsigned ASYNC_LOAD_BATCH_NODES = 32;
 static const float DEFAULT_SMOOTHING_CONSTANT = 50.0f;
 static const float DEFAULT_SNAP_THRESHOLD = 5.0f;
 
+void UpdateTransformsWork(Node** start, Node** end, unsigned threadIndex, void* userData)
+{
+    while (start != end)
+    {
+        Node* node = *start;
+        // If the node was updated as a part of a parent node that was queued as well, it is no longer queued
+        if (node->IsTransformQueued())
+            node->UpdateWorldTransforms();
+        ++start;
+    }
+}
+
+void DecodeNodesWork(const WorkItem* item, unsigned threadIndex)
+{
+    AsyncProgress* progress = reinterpret_cast<AsyncProgress*>(item->aux_);
+    AsyncLoadBatch* batch = reinterpret_cast<AsyncLoadBatch*>(item->start_);
+    
+    // If loading was stopped, only mark the batch finished
+    if (!progress->cancel_)
+    {
+        MemoryBuffer source(&progress->buffer_[batch->offset_], batch->size_);
+        for (unsigned i = 0; i < batch->nodes_.Size(); ++i)
+        {
+            unsigned nodeID = source.ReadUInt();
+            if (!batch->nodes_[i]->LoadSceneNode(source, nodeID))
+                break;
+        }
+    }
+    
+    batch->decoded_ = true;
+}
+
+/// Skip the binary data of a node and its child nodes, after the node ID. Return false if the data is corrupt.
+static bool SkipNodeData(Deserializer& source, const Vector<AttributeInfo>* attributes)
+{
+    if (attributes)
+    {
+        for (unsigned i = 0; i < attributes->Size(); ++i)
+        {
+            const AttributeInfo& attr = attributes->At(i);
+            if (!(attr.mode_ & AM_FILE))
+                continue;
+            if (source.IsEof())
+                return false;
+            source.ReadVariant(attr.type_);
+        }
+    }
+    
+    // Components are stored with their size, so they do not need to be decoded
+    unsigned numComponents = source.ReadVLE();
+    for (unsigned i = 0; i < numComponents; ++i)
+    {
+        unsigned dataSize = source.ReadVLE();
+        if (source.IsEof() || source.GetPosition() + dataSize > source.GetSize())
+            return false;
+        source.Seek(source.GetPosition() + dataSize);
+    }
+    
+    unsigned numChildren = source.ReadVLE();
+    for (unsigned i = 0; i < numChildren; ++i)
+    {
+        if (source.IsEof())
+            return false;
+        source.ReadUInt();
+        if (!SkipNodeData(source, attributes))
+            return false;
+    }
+    
+    return true;
+}
+
+void ScanNodesWork(const WorkItem* item, unsigned threadIndex)
+{
+    AsyncProgress* progress = reinterpret_cast<AsyncProgress*>(item->aux_);
+    const Vector<AttributeInfo>* attributes = reinterpret_cast<const Vector<AttributeInfo>*>(item->start_);
+    MemoryBuffer source(progress->buffer_);
+    unsigned numNodes = 0;
+    bool corrupt = false;
+    
+    while (!corrupt && numNodes < progress->totalNodes_ && !progress->cancel_)
+    {
+        AsyncLoadBatch& batch = progress->batches_[progress->scannedBatches_];
+        batch.offset_ = source.GetPosition();
+        
+        // Find the end of the batch's node data. If the data is corrupt, stop at the last complete node
+        while (batch.numNodes_ < ASYNC_LOAD_BATCH_NODES && numNodes < progress->totalNodes_)
+        {
+            if (source.IsEof())
+            {
+                corrupt = true;
+                break;
+            }
+            source.ReadUInt();
+            if (!SkipNodeData(source, attributes))
+            {
+                corrupt = true;
+                break;
+            }
+            
+            batch.size_ = source.GetPosition() - batch.offset_;
+            ++batch.numNodes_;
+            ++numNodes;
+        }
+        
+        // Hand the batch over to the main thread for queuing
+        if (batch.numNodes_)
+            ++progress->scannedBatches_;
+    }
+    
+    progress->scannedNodes_ = numNodes;
+    progress->scanFinished_ = true;
+}
+
 OBJECTTYPESTATIC(Scene);
 
 Scene::Scene(Context* context) :
     Node(context),
+    transformUpdateLoop_(UpdateTransformsWork),
     replicatedNodeID_(FIRST_REPLICATED_ID),
     replicatedComponentID_(FIRST_REPLICATED_ID),
     localNodeID_(FIRST_LOCAL_ID),
@@ -60,7 +177,10 @@ Scene::Scene(Context* context) :
     snapThreshold_(DEFAULT_SNAP_THRESHOLD),
     active_(true),
     asyncLoading_(false),
-    threadedUpdate_(false)
+    threadedUpdate_(false),
+    batchedTransforms_(false),
+    deferredMarkedDirty_(false),
+    threadedLoading_(false)
 {
     // Assign an ID to self so that nodes can refer to this node as a parent
     SetID(GetFreeNodeID(REPLICATED));
@@ -71,13 +191,14 @@ Scene::Scene(Context* context) :
 
 Scene::~Scene()
 {
+    StopAsyncLoading();
     RemoveAllChildren();
     RemoveAllComponents();
     
     // Remove scene reference and owner from all nodes that still exist
-    for (HashMap<unsigned, Node*>::Iterator i = replicatedNodes_.Begin(); i != replicatedNodes_.End(); ++i)
+    for (FlatHashMap<unsigned, Node*>::Iterator i = replicatedNodes_.Begin(); i != replicatedNodes_.End(); ++i)
         i->second_->ResetScene();
-    for (HashMap<unsigned, Node*>::Iterator i = localNodes_.Begin(); i != localNodes_.End(); ++i)
+    for (FlatHashMap<unsigned, Node*>::Iterator i = localNodes_.Begin(); i != localNodes_.End(); ++i)
         i->second_->ResetScene();
 }
 
@@ -167,7 +288,7 @@ void Scene::AddReplicationState(NodeReplicationState* state)
     Node::AddReplicationState(state);
     
     // This is the first update for a new connection. Mark all replicated nodes dirty
-    for (HashMap<unsigned, Node*>::ConstIterator i = replicatedNodes_.Begin(); i != replicatedNodes_.End(); ++i)
+    for (FlatHashMap<unsigned, Node*>::ConstIterator i = replicatedNodes_.Begin(); i != replicatedNodes_.End(); ++i)
         state->sceneState_->dirtyNodes_.Insert(i->first_);
 }
 
@@ -243,6 +364,36 @@ bool Scene::LoadAsync(File* file)
     asyncProgress_.loadedNodes_ = 0;
     asyncProgress_.totalNodes_ = file->ReadVLE();
     
+    // In threaded mode read the rest of the file to memory, and find the boundaries of the root level nodes in a worker
+    // thread. The async update queues the found batches of nodes for decoding in the other worker threads
+    WorkQueue* queue = GetSubsystem<WorkQueue>();
+    if (threadedLoading_ && queue && queue->GetNumThreads() && asyncProgress_.totalNodes_)
+    {
+        unsigned dataSize = file->GetSize() - file->GetPosition();
+        asyncProgress_.buffer_.Resize(dataSize);
+        if (!dataSize || file->Read(&asyncProgress_.buffer_[0], dataSize) != dataSize)
+        {
+            LOGERROR("Could not read scene node data from " + file->GetName());
+            StopAsyncLoading();
+            return false;
+        }
+        
+        asyncProgress_.batches_.Resize((asyncProgress_.totalNodes_ + ASYNC_LOAD_BATCH_NODES - 1) / ASYNC_LOAD_BATCH_NODES);
+        asyncProgress_.scannedBatches_ = 0;
+        asyncProgress_.scannedNodes_ = 0;
+        asyncProgress_.scanFinished_ = false;
+        asyncProgress_.queuedBatches_ = 0;
+        asyncProgress_.cancel_ = false;
+        
+        WorkItem item;
+        item.workFunction_ = ScanNodesWork;
+        item.start_ = const_cast<Vector<AttributeInfo>*>(context_->GetAttributes(Node::GetTypeStatic()));
+        item.aux_ = &asyncProgress_;
+        // Use the lowest priority so that the renderer's work queue completions do not wait for the loading
+        item.priority_ = 0;
+        asyncProgress_.scanItem_ = queue->AddWorkItem(item);
+    }
+    
     return true;
 }
 
@@ -294,6 +445,28 @@ bool Scene::LoadAsyncXML(File* file)
 
 void Scene::StopAsyncLoading()
 {
+    // Make sure the worker threads are not scanning or decoding anymore before releasing the data. Unfinished work items
+    // can not have been purged, so wait for them directly
+    if (!asyncProgress_.batches_.Empty())
+    {
+        WorkQueue* queue = GetSubsystem<WorkQueue>();
+        if (queue)
+        {
+            asyncProgress_.cancel_ = true;
+            if (!asyncProgress_.scanFinished_)
+                queue->CompleteItem(asyncProgress_.scanItem_);
+            for (unsigned i = 0; i < asyncProgress_.queuedBatches_; ++i)
+            {
+                AsyncLoadBatch& batch = asyncProgress_.batches_[i];
+                if (!batch.decoded_)
+                    queue->CompleteItem(batch.item_);
+            }
+        }
+        
+        asyncProgress_.batches_.Clear();
+        asyncProgress_.buffer_.Clear();
+    }
+    
     asyncLoading_ = false;
     asyncProgress_.file_.Reset();
     asyncProgress_.xmlFile_.Reset();
@@ -356,6 +529,23 @@ Node* Scene::InstantiateXML(Deserializer& source, const Vector3& position, const
     return InstantiateXML(xml->GetRoot(), position, rotation, mode);
 }
 
+Node* Scene::Instantiate(PrefabTemplate* prefab, const Vector3& position, const Quaternion& rotation, CreateMode mode)
+{
+    if (!prefab)
+        return 0;
+    
+    PROFILE(InstantiatePrefab);
+    
+    Node* node = prefab->Instantiate(this, mode);
+    if (node)
+    {
+        node->ApplyAttributes();
+        node->SetTransform(position, rotation);
+    }
+    
+    return node;
+}
+
 void Scene::Clear()
 {
     StopAsyncLoading();
@@ -367,6 +557,10 @@ void Scene::Clear()
     replicatedComponentID_ = FIRST_REPLICATED_ID;
     localNodeID_ = FIRST_LOCAL_ID;
     localComponentID_ = FIRST_LOCAL_ID;
+    freeReplicatedNodeIDs_.Clear();
+    freeLocalNodeIDs_.Clear();
+    freeReplicatedComponentIDs_.Clear();
+    freeLocalComponentIDs_.Clear();
 }
 
 void Scene::SetActive(bool enable)
@@ -392,6 +586,41 @@ void Scene::SetSnapThreshold(float threshold)
     Node::MarkNetworkUpdate();
 }
 
+void Scene::SetBatchedTransforms(bool enable)
+{
+    if (enable == batchedTransforms_)
+        return;
+    
+    batchedTransforms_ = enable;
+    
+    if (!enable)
+    {
+        for (Vector<WeakPtr<Node> >::Iterator i = transformUpdateNodes_.Begin(); i != transformUpdateNodes_.End(); ++i)
+        {
+            if (*i)
+                (*i)->SetTransformQueued(false);
+        }
+        transformUpdateNodes_.Clear();
+    }
+}
+
+void Scene::SetDeferredMarkedDirty(bool enable)
+{
+    if (enable == deferredMarkedDirty_)
+        return;
+    
+    // Deliver any pending notifications before switching back to immediate mode
+    if (!enable)
+        NotifyMarkedDirty();
+    
+    deferredMarkedDirty_ = enable;
+}
+
+void Scene::SetThreadedLoading(bool enable)
+{
+    threadedLoading_ = enable;
+}
+
 void Scene::SetElapsedTime(float time)
 {
     elapsedTime_ = time;
@@ -430,7 +659,7 @@ Node* Scene::GetNode(unsigned id) const
 {
     if (id < FIRST_LOCAL_ID)
     {
-        HashMap<unsigned, Node*>::ConstIterator i = replicatedNodes_.Find(id);
+        FlatHashMap<unsigned, Node*>::ConstIterator i = replicatedNodes_.Find(id);
         if (i != replicatedNodes_.End())
             return i->second_;
         else
@@ -438,7 +667,7 @@ Node* Scene::GetNode(unsigned id) const
     }
     else
     {
-        HashMap<unsigned, Node*>::ConstIterator i = localNodes_.Find(id);
+        FlatHashMap<unsigned, Node*>::ConstIterator i = localNodes_.Find(id);
         if (i != localNodes_.End())
             return i->second_;
         else
@@ -450,7 +679,7 @@ Component* Scene::GetComponent(unsigned id) const
 {
     if (id < FIRST_LOCAL_ID)
     {
-        HashMap<unsigned, Component*>::ConstIterator i = replicatedComponents_.Find(id);
+        FlatHashMap<unsigned, Component*>::ConstIterator i = replicatedComponents_.Find(id);
         if (i != replicatedComponents_.End())
             return i->second_;
         else
@@ -458,7 +687,7 @@ Component* Scene::GetComponent(unsigned id) const
     }
     else
     {
-        HashMap<unsigned, Component*>::ConstIterator i = localComponents_.Find(id);
+        FlatHashMap<unsigned, Component*>::ConstIterator i = localComponents_.Find(id);
         if (i != localComponents_.End())
             return i->second_;
         else
@@ -500,6 +729,7 @@ void Scene::Update(float timeStep)
     
     // Update variable timestep logic
     SendEvent(E_SCENEUPDATE, eventData);
+    NotifyMarkedDirty();
     
     // Update scene subsystems. If a physics world is present, it will be updated, triggering fixed timestep logic updates
     SendEvent(E_SCENESUBSYSTEMUPDATE, eventData);
@@ -522,12 +752,87 @@ void Scene::Update(float timeStep)
     // Post-update variable timestep logic
     SendEvent(E_SCENEPOSTUPDATE, eventData);
     
+    // Notify the listener components and recalculate the world transforms of the nodes that were moved during the update
+    NotifyMarkedDirty();
+    UpdateTransforms();
+    
     // Note: using a float for elapsed time accumulation is inherently inaccurate. The purpose of this value is
     // primarily to update material animation effects, as it is available to shaders. It can be reset by calling
     // SetElapsedTime()
     elapsedTime_ += timeStep;
 }
 
+void Scene::UpdateTransforms()
+{
+    if (transformUpdateNodes_.Empty())
+        return;
+    
+    PROFILE(UpdateTransforms);
+    
+    // Sort the queued nodes by hierarchy depth. A node can not be the parent of another node at the same depth, so each
+    // depth level can be updated in parallel once the levels above it are done
+    for (Vector<WeakPtr<Node> >::Iterator i = transformUpdateNodes_.Begin(); i != transformUpdateNodes_.End(); ++i)
+    {
+        Node* node = *i;
+        if (!node)
+            continue;
+        if (node->GetScene() != this)
+        {
+            node->SetTransformQueued(false);
+            continue;
+        }
+        
+        unsigned depth = 0;
+        for (Node* parent = node->GetParent(); parent; parent = parent->GetParent())
+            ++depth;
+        if (depth >= transformUpdateLevels_.Size())
+            transformUpdateLevels_.Resize(depth + 1);
+        transformUpdateLevels_[depth].Push(node);
+    }
+    transformUpdateNodes_.Clear();
+    
+    WorkQueue* queue = GetSubsystem<WorkQueue>();
+    
+    for (unsigned i = 0; i < transformUpdateLevels_.Size(); ++i)
+    {
+        PODVector<Node*>& level = transformUpdateLevels_[i];
+        if (level.Empty())
+            continue;
+        
+        // The parents are normally up to date already, unless they were dirtied without being queued. Update them here so
+        // that the worker threads do not need to
+        for (PODVector<Node*>::Iterator j = level.Begin(); j != level.End(); ++j)
+        {
+            Node* parent = (*j)->GetParent();
+            if (parent)
+                parent->GetWorldTransform();
+        }
+        
+        transformUpdateLoop_.Run(queue, level.Begin(), level.End(), 0);
+        level.Clear();
+    }
+}
+
+void Scene::NotifyMarkedDirty()
+{
+    if (markedDirtyNodes_.Empty())
+        return;
+    
+    PROFILE(NotifyMarkedDirty);
+    
+    // Listeners may mark further nodes dirty, which are appended to the queue and notified in the same pass. A node may
+    // be queued several times, or be notified through a queued parent node first; the pending flag is cleared once
+    // notified
+    for (unsigned i = 0; i < markedDirtyNodes_.Size(); ++i)
+    {
+        Node* node = markedDirtyNodes_[i];
+        if (node && node->IsNotifyPending())
+            node->NotifyMarkedDirty();
+    }
+    
+    markedDirtyNodes_.Clear();
+}
+
 void Scene::BeginThreadedUpdate()
 {
     // Check the work queue subsystem whether it actually has created worker threads. If not, do not enter threaded mode.
@@ -560,8 +865,17 @@ void Scene::DelayedMarkedDirty(Component* component)
 
 unsigned Scene::GetFreeNodeID(CreateMode mode)
 {
+    // Reuse the IDs of removed nodes first to avoid probing for a free ID. An ID may have been taken again meanwhile, for
+    // example by loading or by the probing below, so check each
     if (mode == REPLICATED)
     {
+        while (!freeReplicatedNodeIDs_.Empty())
+        {
+            unsigned id = freeReplicatedNodeIDs_.Pop();
+            if (!replicatedNodes_.Contains(id))
+                return id;
+        }
+        
         for (;;)
         {
             if (!replicatedNodes_.Contains(replicatedNodeID_))
@@ -575,6 +889,13 @@ unsigned Scene::GetFreeNodeID(CreateMode mode)
     }
     else
     {
+        while (!freeLocalNodeIDs_.Empty())
+        {
+            unsigned id = freeLocalNodeIDs_.Pop();
+            if (!localNodes_.Contains(id))
+                return id;
+        }
+        
         for (;;)
         {
             if (!localNodes_.Contains(localNodeID_))
@@ -592,6 +913,13 @@ unsigned Scene::GetFreeComponentID(CreateMode mode)
 {
     if (mode == REPLICATED)
     {
+        while (!freeReplicatedComponentIDs_.Empty())
+        {
+            unsigned id = freeReplicatedComponentIDs_.Pop();
+            if (!replicatedComponents_.Contains(id))
+                return id;
+        }
+        
         for (;;)
         {
             if (!replicatedComponents_.Contains(replicatedComponentID_))
@@ -605,6 +933,13 @@ unsigned Scene::GetFreeComponentID(CreateMode mode)
     }
     else
     {
+        while (!freeLocalComponentIDs_.Empty())
+        {
+            unsigned id = freeLocalComponentIDs_.Pop();
+            if (!localComponents_.Contains(id))
+                return id;
+        }
+        
         for (;;)
         {
             if (!localComponents_.Contains(localComponentID_))
@@ -629,7 +964,7 @@ void Scene::NodeAdded(Node* node)
     unsigned id = node->GetID();
     if (id < FIRST_LOCAL_ID)
     {
-        HashMap<unsigned, Node*>::Iterator i = replicatedNodes_.Find(id);
+        FlatHashMap<unsigned, Node*>::Iterator i = replicatedNodes_.Find(id);
         if (i != replicatedNodes_.End() && i->second_ != node)
         {
             LOGWARNING("Overwriting node with ID " + String(id));
@@ -643,7 +978,7 @@ void Scene::NodeAdded(Node* node)
     }
     else
     {
-        HashMap<unsigned, Node*>::Iterator i = localNodes_.Find(id);
+        FlatHashMap<unsigned, Node*>::Iterator i = localNodes_.Find(id);
         if (i != localNodes_.End() && i->second_ != node)
         {
             LOGWARNING("Overwriting node with ID " + String(id));
@@ -664,9 +999,14 @@ void Scene::NodeRemoved(Node* node)
     {
         replicatedNodes_.Erase(id);
         MarkReplicationDirty(node);
+        if (id)
+            freeReplicatedNodeIDs_.Push(id);
     }
     else
+    {
         localNodes_.Erase(id);
+        freeLocalNodeIDs_.Push(id);
+    }
     
     node->SetID(0);
     node->SetScene(0);
@@ -680,7 +1020,7 @@ void Scene::ComponentAdded(Component* component)
     unsigned id = component->GetID();
     if (id < FIRST_LOCAL_ID)
     {
-        HashMap<unsigned, Component*>::Iterator i = replicatedComponents_.Find(id);
+        FlatHashMap<unsigned, Component*>::Iterator i = replicatedComponents_.Find(id);
         if (i != replicatedComponents_.End() && i->second_ != component)
         {
             LOGWARNING("Overwriting component with ID " + String(id));
@@ -691,7 +1031,7 @@ void Scene::ComponentAdded(Component* component)
     }
     else
     {
-        HashMap<unsigned, Component*>::Iterator i = localComponents_.Find(id);
+        FlatHashMap<unsigned, Component*>::Iterator i = localComponents_.Find(id);
         if (i != localComponents_.End() && i->second_ != component)
         {
             LOGWARNING("Overwriting component with ID " + String(id));
@@ -709,9 +1049,16 @@ void Scene::ComponentRemoved(Component* component)
     
     unsigned id = component->GetID();
     if (id < FIRST_LOCAL_ID)
+    {
         replicatedComponents_.Erase(id);
+        if (id)
+            freeReplicatedComponentIDs_.Push(id);
+    }
     else
+    {
         localComponents_.Erase(id);
+        freeLocalComponentIDs_.Push(id);
+    }
     
     component->SetID(0);
 }
@@ -764,10 +1111,10 @@ void Scene::CleanupConnection(Connection* connection)
 {
     Node::CleanupConnection(connection);
     
-    for (HashMap<unsigned, Node*>::Iterator i = replicatedNodes_.Begin(); i != replicatedNodes_.End(); ++i)
+    for (FlatHashMap<unsigned, Node*>::Iterator i = replicatedNodes_.Begin(); i != replicatedNodes_.End(); ++i)
         i->second_->CleanupConnection(connection);
     
-    for (HashMap<unsigned, Component*>::Iterator i = replicatedComponents_.Begin(); i != replicatedComponents_.End(); ++i)
+    for (FlatHashMap<unsigned, Component*>::Iterator i = replicatedComponents_.Begin(); i != replicatedComponents_.End(); ++i)
         i->second_->CleanupConnection(connection);
 }
 
@@ -798,6 +1145,21 @@ void Scene::MarkReplicationDirty(Node* node)
     }
 }
 
+void Scene::QueueTransformUpdate(Node* node)
+{
+    // Nodes that are moved in the worker threads during a threaded update are left to be updated on demand
+    if (!batchedTransforms_ || threadedUpdate_)
+        return;
+    
+    node->SetTransformQueued(true);
+    transformUpdateNodes_.Push(WeakPtr<Node>(node));
+}
+
+void Scene::QueueMarkedDirty(Node* node)
+{
+    markedDirtyNodes_.Push(WeakPtr<Node>(node));
+}
+
 void Scene::HandleUpdate(StringHash eventType, VariantMap& eventData)
 {
     using namespace Update;
@@ -812,6 +1174,10 @@ void Scene::UpdateAsyncLoading()
     
     Timer asyncLoadTimer;
     
+    // In threaded mode queue the node batches found so far for decoding
+    if (!asyncProgress_.batches_.Empty())
+        QueueAsyncLoadBatches();
+    
     for (;;)
     {
         if (asyncProgress_.loadedNodes_ >= asyncProgress_.totalNodes_)
@@ -820,8 +1186,14 @@ void Scene::UpdateAsyncLoading()
             return;
         }
         
-        // Read one child node with its full sub-hierarchy either from binary or XML
-        if (!asyncProgress_.xmlFile_)
+        // Read one child node with its full sub-hierarchy either from binary or XML, or create it from the data decoded in
+        // a worker thread. If not decoded yet, continue on the next frame
+        if (!asyncProgress_.batches_.Empty())
+        {
+            if (!CreateDecodedNode())
+                break;
+        }
+        else if (!asyncProgress_.xmlFile_)
         {
             unsigned nodeID = asyncProgress_.file_->ReadUInt();
             Node* newNode = CreateChild(nodeID, nodeID < FIRST_LOCAL_ID ? REPLICATED : LOCAL);
@@ -868,6 +1240,51 @@ void Scene::FinishAsyncLoading()
     SendEvent(E_ASYNCLOADFINISHED, eventData);
 }
 
+void Scene::QueueAsyncLoadBatches()
+{
+    // If the scanning found corrupt data, load only the nodes before it
+    if (asyncProgress_.scanFinished_ && asyncProgress_.scannedNodes_ < asyncProgress_.totalNodes_)
+    {
+        LOGERROR("Corrupt scene node data in " + asyncProgress_.file_->GetName());
+        asyncProgress_.totalNodes_ = asyncProgress_.scannedNodes_;
+    }
+    
+    WorkQueue* queue = GetSubsystem<WorkQueue>();
+    while (asyncProgress_.queuedBatches_ < asyncProgress_.scannedBatches_)
+    {
+        AsyncLoadBatch& batch = asyncProgress_.batches_[asyncProgress_.queuedBatches_];
+        batch.nodes_.Resize(batch.numNodes_);
+        for (unsigned i = 0; i < batch.numNodes_; ++i)
+            batch.nodes_[i] = new PrefabTemplate(context_);
+        
+        WorkItem item;
+        item.workFunction_ = DecodeNodesWork;
+        item.start_ = &batch;
+        item.aux_ = &asyncProgress_;
+        item.priority_ = 0;
+        batch.item_ = queue->AddWorkItem(item);
+        ++asyncProgress_.queuedBatches_;
+    }
+}
+
+bool Scene::CreateDecodedNode()
+{
+    unsigned batchIndex = asyncProgress_.loadedNodes_ / ASYNC_LOAD_BATCH_NODES;
+    if (batchIndex >= asyncProgress_.queuedBatches_ || !asyncProgress_.batches_[batchIndex].decoded_)
+        return false;
+    
+    SharedPtr<PrefabTemplate>& node = asyncProgress_.batches_[batchIndex].nodes_[asyncProgress_.loadedNodes_ %
+        ASYNC_LOAD_BATCH_NODES];
+    if (node->GetNumNodes())
+        node->Instantiate(this, resolver_);
+    else
+        LOGERROR("Could not load scene node data from " + asyncProgress_.file_->GetName());
+    
+    // The decoded data is no longer needed once the nodes exist
+    node.Reset();
+    return true;
+}
+
 void Scene::FinishLoading(Deserializer* source)
 {
     if (source)
@@ -881,6 +1298,7 @@ void RegisterSceneLibrary(Context* context)
 {
     Node::RegisterObject(context);
     Scene::RegisterObject(context);
+    PrefabTemplate::RegisterObject(context);
     SmoothedTransform::RegisterObject(context);
 }
 
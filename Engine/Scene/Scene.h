@@ -22,9 +22,12 @@
 
 #pragma once
 
+#include "FlatHashMap.h"
 #include "HashSet.h"
 #include "Mutex.h"
 #include "Node.h"
+#include "ParallelFor.h"
+#include "PrefabTemplate.h"
 #include "SceneResolver.h"
 #include "XMLElement.h"
 
@@ -39,6 +42,33 @@ static const unsigned LAST_REPLICATED_ID = 0xffffff;
 static const unsigned FIRST_LOCAL_ID = 0x01000000;
 static const unsigned LAST_LOCAL_ID = 0xffffffff;
 
+/// Batch of root-level nodes decoded in a worker thread during threaded asynchronous loading.
+struct AsyncLoadBatch
+{
+    /// Construct.
+    AsyncLoadBatch() :
+        offset_(0),
+        size_(0),
+        numNodes_(0),
+        item_(0),
+        decoded_(false)
+    {
+    }
+    
+    /// Offset of the node data in the load buffer.
+    unsigned offset_;
+    /// Size of the node data.
+    unsigned size_;
+    /// Number of root-level nodes.
+    unsigned numNodes_;
+    /// Decoded root-level nodes. Nodes that failed to decode are left empty.
+    Vector<SharedPtr<PrefabTemplate> > nodes_;
+    /// Decoding work item. Valid until decoded.
+    WorkItem* item_;
+    /// Decoding finished flag. Set by the worker thread.
+    volatile bool decoded_;
+};
+
 /// Asynchronous loading progress of a scene.
 struct AsyncProgress
 {
@@ -52,6 +82,62 @@ struct AsyncProgress
     unsigned loadedNodes_;
     /// Total root-level nodes.
     unsigned totalNodes_;
+    /// Root-level node data for threaded binary mode.
+    PODVector<unsigned char> buffer_;
+    /// Root-level node batches for threaded binary mode.
+    Vector<AsyncLoadBatch> batches_;
+    /// Number of batches found by the scanning worker thread.
+    volatile unsigned scannedBatches_;
+    /// Number of root-level nodes found by the scanning worker thread. Less than the total if the data is corrupt.
+    volatile unsigned scannedNodes_;
+    /// Scanning work item. Valid until the scanning has finished.
+    WorkItem* scanItem_;
+    /// Scanning finished flag.
+    volatile bool scanFinished_;
+    /// Number of batches queued for decoding.
+    unsigned queuedBatches_;
+    /// Cancel flag for the worker threads.
+    volatile bool cancel_;
+};
+
+/// Queue of the IDs of removed nodes or components, to be reused oldest first.
+struct FreeIDList
+{
+    /// Construct empty.
+    FreeIDList() :
+        first_(0)
+    {
+    }
+    
+    /// Add a freed ID.
+    void Push(unsigned id)
+    {
+        // Discard the already taken IDs from the front once they make up half the storage
+        if (first_ >= ids_.Size() / 2 && first_ >= 64)
+        {
+            ids_.Erase(0, first_);
+            first_ = 0;
+        }
+        ids_.Push(id);
+    }
+    
+    /// Take the oldest freed ID. The list must not be empty.
+    unsigned Pop() { return ids_[first_++]; }
+    
+    /// Remove all IDs.
+    void Clear()
+    {
+        ids_.Clear();
+        first_ = 0;
+    }
+    
+    /// Return whether has no IDs left.
+    bool Empty() const { return first_ >= ids_.Size(); }
+    
+    /// Freed IDs, including already taken ones before the first index.
+    PODVector<unsigned> ids_;
+    /// Index of the oldest freed ID not taken yet.
+    unsigned first_;
 };
 
 /// Root scene node, represents the whole scene.
@@ -95,6 +181,8 @@ public:
     Node* InstantiateXML(const XMLElement& source, const Vector3& position, const Quaternion& rotation, CreateMode mode = REPLICATED);
     /// Instantiate scene content from XML data. Return root node if successful.
     Node* InstantiateXML(Deserializer& source, const Vector3& position, const Quaternion& rotation, CreateMode mode = REPLICATED);
+    /// Instantiate scene content from a prefab template. Faster than instantiating from binary or XML data, as the attributes are copied directly. Return root node if successful.
+    Node* Instantiate(PrefabTemplate* prefab, const Vector3& position, const Quaternion& rotation, CreateMode mode = REPLICATED);
     /// Clear scene completely of nodes and components.
     void Clear();
     /// Set active flag. Only active scenes will be updated automatically.
@@ -107,6 +195,12 @@ public:
     void SetSmoothingConstant(float constant);
     /// Set network client motion smoothing snap threshold.
     void SetSnapThreshold(float threshold);
+    /// Set whether to recalculate the world transforms of moved nodes in one parallel pass at the end of the scene update, instead of only on demand. Default false.
+    void SetBatchedTransforms(bool enable);
+    /// Set whether to defer the listener notifications of nodes being marked dirty, so that listener components are notified once per update pass instead of on each transform change. Default false.
+    void SetDeferredMarkedDirty(bool enable);
+    /// Set whether asynchronous binary loading decodes the node and component data in worker threads, leaving only object creation to the main thread. Takes effect on the next LoadAsync(). Default false.
+    void SetThreadedLoading(bool enable);
     /// Add a required package file for networking. To be called on the server.
     void AddRequiredPackageFile(PackageFile* package);
     /// Clear required package files.
@@ -140,6 +234,12 @@ public:
     float GetSmoothingConstant() const { return smoothingConstant_; }
     /// Return motion smoothing snap threshold.
     float GetSnapThreshold() const { return snapThreshold_; }
+    /// Return whether world transforms are recalculated in a batched update.
+    bool GetBatchedTransforms() const { return batchedTransforms_; }
+    /// Return whether listener notifications of nodes being marked dirty are deferred.
+    bool GetDeferredMarkedDirty() const { return deferredMarkedDirty_; }
+    /// Return whether asynchronous binary loading decodes in worker threads.
+    bool GetThreadedLoading() const { return threadedLoading_; }
     /// Return required package files.
     const Vector<SharedPtr<PackageFile> >& GetRequiredPackageFiles() const { return requiredPackageFiles_; }
     /// Return a node user variable name, or empty if not registered.
@@ -147,6 +247,10 @@ public:
     
     /// Update scene. Called by HandleUpdate.
     void Update(float timeStep);
+    /// Recalculate the world transforms of nodes queued for the batched update. Called at the end of Update(), but can also be called manually.
+    void UpdateTransforms();
+    /// Notify the listener components of nodes whose dirty marking was deferred. Called at the end of Update(), and by the octree and physics world before they use the transforms, but can also be called manually.
+    void NotifyMarkedDirty();
     /// Begin a threaded update. During threaded update components can choose to delay dirty processing.
     void BeginThreadedUpdate();
     /// End a threaded update. Notify components that marked themselves for delayed dirty processing.
@@ -155,9 +259,9 @@ public:
     void DelayedMarkedDirty(Component* component);
     /// Return threaded update flag.
     bool IsThreadedUpdate() const { return threadedUpdate_; }
-    /// Get free node ID, either non-local or local.
+    /// Get free node ID, either non-local or local. IDs of removed nodes are reused first.
     unsigned GetFreeNodeID(CreateMode mode);
-    /// Get free component ID, either non-local or local.
+    /// Get free component ID, either non-local or local. IDs of removed components are reused first.
     unsigned GetFreeComponentID(CreateMode mode);
     /// Node added. Assign scene pointer and add to ID map.
     void NodeAdded(Node* node);
@@ -181,6 +285,10 @@ public:
     void MarkNetworkUpdate(Component* component);
     /// Mark a node dirty in scene replication states. The node does not need to have own replication state yet.
     void MarkReplicationDirty(Node* node);
+    /// Queue a node whose world transform became dirty for the batched update, if enabled. Called by Node.
+    void QueueTransformUpdate(Node* node);
+    /// Queue a node for deferred listener notification. Called by Node.
+    void QueueMarkedDirty(Node* node);
     
 private:
     /// Handle the logic update event to update the scene, if active.
@@ -189,17 +297,21 @@ private:
     void UpdateAsyncLoading();
     /// Finish asynchronous loading.
     void FinishAsyncLoading();
+    /// Queue the root-level node batches found so far in a threaded asynchronous load for decoding in worker threads.
+    void QueueAsyncLoadBatches();
+    /// Create the next root-level node decoded in a worker thread. Return false if it has not been decoded yet.
+    bool CreateDecodedNode();
     /// Finish loading. Sets the scene filename and checksum.
     void FinishLoading(Deserializer* source);
     
     /// Replicated scene nodes by ID.
-    HashMap<unsigned, Node*> replicatedNodes_;
+    FlatHashMap<unsigned, Node*> replicatedNodes_;
     /// Local scene nodes by ID.
-    HashMap<unsigned, Node*> localNodes_;
+    FlatHashMap<unsigned, Node*> localNodes_;
     /// Replicated components by ID.
-    HashMap<unsigned, Component*> replicatedComponents_;
+    FlatHashMap<unsigned, Component*> replicatedComponents_;
     /// Local components by ID.
-    HashMap<unsigned, Component*> localComponents_;
+    FlatHashMap<unsigned, Component*> localComponents_;
     /// Asynchronous loading progress.
     AsyncProgress asyncProgress_;
     /// Node and component ID resolver for asynchronous loading.
@@ -210,10 +322,26 @@ private:
     Vector<SharedPtr<PackageFile> > requiredPackageFiles_;
     /// Registered node user variable reverse mappings.
     HashMap<ShortStringHash, String> varNames_;
+    /// IDs of removed replicated nodes.
+    FreeIDList freeReplicatedNodeIDs_;
+    /// IDs of removed local nodes.
+    FreeIDList freeLocalNodeIDs_;
+    /// IDs of removed replicated components.
+    FreeIDList freeReplicatedComponentIDs_;
+    /// IDs of removed local components.
+    FreeIDList freeLocalComponentIDs_;
     /// Nodes to check for attribute changes on the next network update.
     HashSet<unsigned> networkUpdateNodes_;
     /// Components to check for attribute changes on the next network update.
     HashSet<unsigned> networkUpdateComponents_;
+    /// Nodes queued for the batched world transform update.
+    Vector<WeakPtr<Node> > transformUpdateNodes_;
+    /// Queued nodes sorted by hierarchy depth during the batched world transform update.
+    Vector<PODVector<Node*> > transformUpdateLevels_;
+    /// Parallel loop for the batched world transform update.
+    ParallelFor<Node*> transformUpdateLoop_;
+    /// Nodes queued for deferred listener notification.
+    Vector<WeakPtr<Node> > markedDirtyNodes_;
     /// Delayed dirty notification queue for components.
     PODVector<Component*> delayedDirtyComponents_;
     /// Mutex for the delayed dirty notification queue.
@@ -242,6 +370,12 @@ private:
     bool asyncLoading_;
     /// Threaded update flag.
     bool threadedUpdate_;
+    /// Batched world transform update flag.
+    bool batchedTransforms_;
+    /// Deferred dirty notification flag.
+    bool deferredMarkedDirty_;
+    /// Threaded asynchronous loading flag.
+    bool threadedLoading_;
 };
 
 /// Register Scene library objects.
@@ -231,19 +231,21 @@ bool Serializable::Load(Deserializer& source)
     if (!attributes)
         return true;
     
+    Variant value;
+    
     for (unsigned i = 0; i < attributes->Size(); ++i)
     {
         const AttributeInfo& attr = attributes->At(i);
         if (!(attr.mode_ & AM_FILE))
             continue;
         
-        if (source.IsEof())
+        if (!DecodeAttribute(attr, source, value))
         {
             LOGERROR("Could not load " + GetTypeName() + ", stream not open or at end");
             return false;
         }
         
-        OnSetAttribute(attr, source.ReadVariant(attr.type_));
+        OnSetAttribute(attr, value);
     }
     
     return true;
@@ -288,55 +290,13 @@ bool Serializable::LoadXML(const XMLElement& source)
     
     XMLElement attrElem = source.GetChild("attribute");
     unsigned startIndex = 0;
+    Variant value;
     
     while (attrElem)
     {
-        const char* name = attrElem.GetAttribute("name");
-        unsigned i = startIndex;
-        unsigned attempts = attributes->Size();
-        
-        while (attempts)
-        {
-            const AttributeInfo& attr = attributes->At(i);
-            if ((attr.mode_ & AM_FILE) && !String::Compare(attr.name_, name, true))
-            {
-                // If enums specified, do enum lookup and int assignment. Otherwise assign the variant directly
-                if (attr.enumNames_)
-                {
-                    const char* value = attrElem.GetAttribute("value");
-                    bool enumFound = false;
-                    int enumValue = 0;
-                    const char** enumPtr = attr.enumNames_;
-                    while (*enumPtr)
-                    {
-                        if (!String::Compare(*enumPtr, value, false))
-                        {
-                            enumFound = true;
-                            break;
-                        }
-                        ++enumPtr;
-                        ++enumValue;
-                    }
-                    if (enumFound)
-                        OnSetAttribute(attr, Variant(enumValue));
-                    else
-                        LOGWARNING("Unknown enum value " + String(value) + " in attribute " + String(attr.name_));
-                }
-                else
-                    OnSetAttribute(attr, attrElem.GetVariantValue(attr.type_));
-                
-                startIndex = (i + 1) % attributes->Size();
-                break;
-            }
-            else
-            {
-                i = (i + 1) % attributes->Size();
-                --attempts;
-            }
-        }
-        
-        if (!attempts)
-            LOGWARNING("Unknown attribute " + String(name) + " in XML data");
+        unsigned index = DecodeAttributeXML(context_, *attributes, attrElem, startIndex, value);
+        if (index != M_MAX_UNSIGNED)
+            OnSetAttribute(attributes->At(index), value);
         
         attrElem = attrElem.GetNext("attribute");
     }
@@ -380,6 +340,83 @@ bool Serializable::SaveXML(XMLElement& dest)
     return true;
 }
 
+bool Serializable::LoadValues(const Vector<Variant>& values)
+{
+    const Vector<AttributeInfo>* attributes = context_->GetAttributes(GetType());
+    if (!attributes)
+        return true;
+    
+    if (values.Size() > attributes->Size())
+    {
+        LOGERROR("Could not load " + GetTypeName() + ", too many attribute values");
+        return false;
+    }
+    
+    for (unsigned i = 0; i < values.Size(); ++i)
+    {
+        if (values[i].GetType() != VAR_NONE)
+            OnSetAttribute(attributes->At(i), values[i]);
+    }
+    
+    return true;
+}
+
+bool Serializable::DecodeAttribute(const AttributeInfo& attr, Deserializer& source, Variant& dest)
+{
+    if (source.IsEof())
+        return false;
+    
+    dest = source.ReadVariant(attr.type_);
+    return true;
+}
+
+unsigned Serializable::DecodeAttributeXML(Context* context, const Vector<AttributeInfo>& attributes, const XMLElement& source,
+    unsigned& startIndex, Variant& dest)
+{
+    const char* name = source.GetAttribute("name");
+    unsigned i = startIndex;
+    unsigned attempts = attributes.Size();
+    
+    while (attempts)
+    {
+        const AttributeInfo& attr = attributes[i];
+        if ((attr.mode_ & AM_FILE) && !String::Compare(attr.name_, name, true))
+        {
+            startIndex = (i + 1) % attributes.Size();
+            
+            // If enums specified, do enum lookup and int assignment. Otherwise decode the variant directly
+            if (attr.enumNames_)
+            {
+                const char* value = source.GetAttribute("value");
+                int enumValue = 0;
+                const char** enumPtr = attr.enumNames_;
+                while (*enumPtr)
+                {
+                    if (!String::Compare(*enumPtr, value, false))
+                    {
+                        dest = enumValue;
+                        return i;
+                    }
+                    ++enumPtr;
+                    ++enumValue;
+                }
+                
+                WriteToLog(context, LOG_WARNING, "Unknown enum value " + String(value) + " in attribute " + String(attr.name_));
+                return M_MAX_UNSIGNED;
+            }
+            
+            dest = source.GetVariantValue(attr.type_);
+            return i;
+        }
+        
+        i = (i + 1) % attributes.Size();
+        --attempts;
+    }
+    
+    WriteToLog(context, LOG_WARNING, "Unknown attribute " + String(name) + " in XML data");
+    return M_MAX_UNSIGNED;
+}
+
 bool Serializable::SetAttribute(unsigned index, const Variant& value)
 {
     const Vector<AttributeInfo>* attributes = context_->GetAttributes(GetType());
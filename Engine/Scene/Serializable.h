@@ -62,9 +62,16 @@ public:
     virtual bool LoadXML(const XMLElement& source);
     /// Save as XML data. Return true if successful.
     virtual bool SaveXML(XMLElement& dest);
+    /// Load from attribute values decoded in advance, indexed as the attribute descriptions. Empty values are skipped. Return true if successful.
+    virtual bool LoadValues(const Vector<Variant>& values);
     /// Apply attribute changes that can not be applied immediately. Called after scene load or a network update.
     virtual void ApplyAttributes() {}
     
+    /// Decode a file attribute value from binary data. Does not log. Return false if at the end of the data.
+    static bool DecodeAttribute(const AttributeInfo& attr, Deserializer& source, Variant& dest);
+    /// Decode the value of the file attribute named by an XML attribute element. The search begins from the start index, which is then moved past the found attribute, so that attributes in saved order are found at the first attempt. Unknown attributes and enum values are logged as warnings. Return the attribute index, or M_MAX_UNSIGNED if the attribute or its enum value is unknown.
+    static unsigned DecodeAttributeXML(Context* context, const Vector<AttributeInfo>& attributes, const XMLElement& source, unsigned& startIndex, Variant& dest);
+    
     /// Set attribute by index. Return true if successfully set.
     bool SetAttribute(unsigned index, const Variant& value);
     /// Set attribute by name. Return true if successfully set.
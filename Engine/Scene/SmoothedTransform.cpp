@@ -170,6 +170,18 @@ void SmoothedTransform::OnNodeSet(Node* node)
     }
 }
 
+bool SmoothedTransform::ResetForReuse()
+{
+    ResetComponent();
+    targetPosition_ = Vector3::ZERO;
+    targetRotation_ = Quaternion::IDENTITY;
+    smoothingMask_ = SMOOTH_NONE;
+    // The event subscription is removed afterward
+    subscribed_ = false;
+    
+    return true;
+}
+
 void SmoothedTransform::HandleUpdateSmoothing(StringHash eventType, VariantMap& eventData)
 {
     using namespace UpdateSmoothing;
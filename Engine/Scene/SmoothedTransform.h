@@ -72,6 +72,8 @@ public:
 protected:
     /// Handle scene node being assigned at creation.
     virtual void OnNodeSet(Node* node);
+    /// Reset to the state of a newly constructed component for reuse by a pooling factory.
+    virtual bool ResetForReuse();
     
 private:
     /// Handle smoothing update event.
@@ -866,7 +866,7 @@ UIElement* UIElement::CreateChild(ShortStringHash type, const String& name)
     SharedPtr<UIElement> newElement = DynamicCast<UIElement>(context_->CreateObject(type));
     if (!newElement)
     {
-        LOGERROR("Could not create unknown UI element type " + type.ToString());
+        LOGERROR("Could not create unknown UI element type " + type.Reverse());
         return 0;
     }
     
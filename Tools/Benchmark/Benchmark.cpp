@@ -0,0 +1,1345 @@
+//
+// Copyright (c) 2008-2013 the Urho3D project.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "AnimatedModel.h"
+#include "Animation.h"
+#include "AnimationState.h"
+#include "Atomic.h"
+#include "CollisionShape.h"
+#include "Context.h"
+#include "File.h"
+#include "FileSystem.h"
+#include "FlatHashMap.h"
+#include "Frustum.h"
+#include "Graphics.h"
+#include "HashMap.h"
+#include "Model.h"
+#include "Octree.h"
+#include "ParallelFor.h"
+#include "ParticleEmitter.h"
+#include "PhysicsWorld.h"
+#include "PrefabTemplate.h"
+#include "ProcessUtils.h"
+#include "Profiler.h"
+#include "ResourceCache.h"
+#include "RigidBody.h"
+#include "Scene.h"
+#include "StaticModel.h"
+#include "StringUtils.h"
+#include "Timer.h"
+#include "VectorBuffer.h"
+#include "WorkQueue.h"
+#include "XMLFile.h"
+
+#include "Sort.h"
+
+#ifdef WIN32
+#include <windows.h>
+#endif
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+using namespace Urho3D;
+
+/// Number of heap allocations made with operator new.
+volatile int allocations_ = 0;
+
+// Count the heap allocations by replacing the global operator new. Done before including DebugNew.h, which redefines new
+void* operator new(size_t size)
+{
+    AtomicIncrement(allocations_);
+    void* ptr = malloc(size ? size : 1);
+    if (!ptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* ptr) throw()
+{
+    free(ptr);
+}
+
+void operator delete[](void* ptr) throw()
+{
+    free(ptr);
+}
+
+#include "DebugNew.h"
+
+/// Timing results of one benchmark.
+struct BenchmarkResult
+{
+    /// Benchmark name.
+    String name_;
+    /// Amount of work items (nodes, queries, operations) processed per iteration.
+    unsigned items_;
+    /// Iteration times in microseconds.
+    PODVector<long long> times_;
+    /// Heap allocations per iteration.
+    PODVector<unsigned> allocations_;
+    /// Profiling data of the timed iterations, empty if profiling is disabled.
+    String profile_;
+};
+
+/// Sort benchmark element with a 64-bit state key laid out like the batch sort key.
+struct SortElement
+{
+    /// Sort key.
+    unsigned long long key_;
+    /// Distance.
+    float distance_;
+};
+
+/// Math benchmark input element.
+struct MathElement
+{
+    /// Local transform.
+    Matrix3x4 transform_;
+    /// Local rotation.
+    Quaternion rotation_;
+    /// Local position.
+    Vector4 position_;
+    /// Local bounding box.
+    BoundingBox box_;
+};
+
+/// Math benchmark result element.
+struct MathResult
+{
+    /// Model-view-projection matrix.
+    Matrix4 modelViewProj_;
+    /// Projected position.
+    Vector4 position_;
+    /// World rotation.
+    Quaternion rotation_;
+    /// World bounding box.
+    BoundingBox box_;
+};
+
+typedef void (*BenchmarkFunction)();
+
+static const unsigned NUM_QUERIES = 100;
+static const unsigned NUM_FRUSTUMS = 16;
+static const unsigned NUM_SPAWNS = 1000;
+static const unsigned WORK_ITEM_SIZE = 16;
+static const unsigned MAP_WORK_ITEM_SIZE = 256;
+static const float TIME_STEP = 1.0f / 60.0f;
+
+SharedPtr<Context> context_;
+SharedPtr<Scene> scene_;
+SharedPtr<Scene> loadScene_;
+Octree* octree_ = 0;
+PhysicsWorld* physicsWorld_ = 0;
+PODVector<Node*> rootNodes_;
+PODVector<Node*> allNodes_;
+PODVector<Node*> replicatedNodes_;
+PODVector<Node*> spawnedNodes_;
+PODVector<AnimatedModel*> animatedModels_;
+PODVector<AnimationState*> animationStates_;
+Vector<BoundingBox> queryBoxes_;
+Vector<Frustum> queryFrustums_;
+Vector<Ray> queryRays_;
+PODVector<Drawable*> queryResult_;
+PODVector<RayQueryResult> rayQueryResult_;
+VectorBuffer binaryData_;
+String binaryFileName_;
+VectorBuffer xmlData_;
+SharedPtr<XMLFile> xmlFile_;
+VectorBuffer prefabData_;
+SharedPtr<XMLFile> prefabXMLFile_;
+SharedPtr<PrefabTemplate> prefab_;
+VectorBuffer networkData_;
+PODVector<unsigned> workData_;
+SharedAllocator* sharedAllocator_ = 0;
+PODVector<SortElement> sortElements_;
+PODVector<SortElement*> sortData_;
+PODVector<SortElement*> sortResult_;
+PODVector<SortElement*> sortBuffer_;
+Vector<MathElement> mathElements_;
+Vector<MathResult> mathResults_;
+Vector<MathResult> scalarMathResults_;
+Matrix3x4 mathParent_;
+Quaternion mathParentRotation_;
+Matrix4 mathViewProj_;
+Vector<BenchmarkResult> results_;
+unsigned numNodes_ = 1000;
+unsigned numThreads_ = 0;
+bool profiling_ = false;
+unsigned numIterations_ = 10;
+unsigned numBodies_ = 0;
+unsigned frameNumber_ = 0;
+float sceneRange_ = 0.0f;
+volatile unsigned sink_ = 0;
+
+int main(int argc, char** argv);
+void Run(const Vector<String>& arguments);
+void ReleaseObjects();
+void CreateScene();
+void CreateQueries();
+void CreateSortData();
+void CreateMathData();
+void RunBenchmark(const String& name, unsigned items, BenchmarkFunction prepare, BenchmarkFunction function);
+String GetResultsJSON();
+String EscapeJSON(const String& str);
+void MoveNodes();
+void UpdateOctree();
+void OctreeInsert();
+void OctreeBoxQuery();
+void OctreeFrustumQuery();
+void OctreeRaycast();
+void SceneSaveBinary();
+void SceneLoadBinary();
+void SceneLoadAsync();
+void SceneSaveXML();
+void SceneLoadXML();
+void XMLAttributeRead();
+unsigned ReadAttributes(const XMLElement& element);
+void TransformPropagation();
+void BatchedTransformPropagation();
+void RepeatedMove();
+void SpawnDespawn();
+void PrefabInstantiateBinary();
+void PrefabInstantiateXML();
+void PrefabInstantiateTemplate();
+void DespawnNodes();
+void AnimatedModelSkinning();
+void PhysicsStep();
+void SerializableDelta();
+void HashMapOperations();
+void FlatHashMapOperations();
+void SharedHashMapOperations();
+void StringOperations();
+void VariantOperations();
+void PrepareSort();
+void SortOperations();
+void RadixSortOperations();
+void ParallelSortOperations();
+void MathOperations();
+void ScalarMathOperations();
+void CheckMathResults();
+void WorkQueueItems();
+void SumWork(const WorkItem* item, unsigned threadIndex);
+void HashMapWork(const WorkItem* item, unsigned threadIndex);
+
+int main(int argc, char** argv)
+{
+    Vector<String> arguments;
+    
+    #ifdef WIN32
+    arguments = ParseArguments(GetCommandLineW());
+    #else
+    arguments = ParseArguments(argc, argv);
+    #endif
+    
+    context_ = new Context();
+    Run(arguments);
+    // The scenes and resources held in globals refer to the context, so release them before it
+    ReleaseObjects();
+    context_.Reset();
+    return 0;
+}
+
+void Run(const Vector<String>& arguments)
+{
+    String outputFileName;
+    numThreads_ = GetNumPhysicalCPUs() - 1;
+    
+    for (unsigned i = 0; i < arguments.Size(); ++i)
+    {
+        if (arguments[i][0] == '-' && arguments[i].Length() >= 2)
+        {
+            String argument = arguments[i].Substring(1).ToLower();
+            unsigned value = ToUInt(argument.Substring(1));
+            
+            switch (argument[0])
+            {
+            case 'n':
+                numNodes_ = Max((int)value, 1);
+                break;
+            
+            case 't':
+                numThreads_ = value;
+                break;
+            
+            case 'i':
+                numIterations_ = Max((int)value, 1);
+                break;
+            
+            case 'p':
+                profiling_ = true;
+                break;
+            
+            default:
+                ErrorExit("Usage: Benchmark [options] [output file]\n\n"
+                    "Runs the engine benchmarks on synthetic scenes and writes the results as JSON to the output file, or to the "
+                    "standard output if not specified. The iteration times are in microseconds.\n\n"
+                    "Options:\n"
+                    "-n<nodes>      Number of nodes in the benchmark scene, default 1000\n"
+                    "-t<threads>    Number of worker threads, default is physical CPU cores - 1\n"
+                    "-i<iterations> Number of timed iterations per benchmark, default 10\n"
+                    "-p             Register a profiler and add its data to the results. Needs a build with profiling enabled\n");
+            }
+        }
+        else
+            outputFileName = arguments[i];
+    }
+    
+    RegisterSceneLibrary(context_);
+    RegisterGraphicsLibrary(context_);
+    RegisterPhysicsLibrary(context_);
+    context_->RegisterSubsystem(new FileSystem(context_));
+    context_->RegisterSubsystem(new ResourceCache(context_));
+    // The profiler must exist before the worker threads are created, so that they get their own block trees
+    if (profiling_)
+        context_->RegisterSubsystem(new Profiler(context_));
+    context_->RegisterSubsystem(new WorkQueue(context_));
+    if (numThreads_)
+        context_->GetSubsystem<WorkQueue>()->CreateThreads(numThreads_);
+    
+    // The benchmark scenes use the stock models, animations and particle effects
+    FileSystem* fileSystem = context_->GetSubsystem<FileSystem>();
+    ResourceCache* cache = context_->GetSubsystem<ResourceCache>();
+    String exePath = fileSystem->GetProgramDir();
+    if (!fileSystem->DirExists(exePath + "CoreData") || !fileSystem->DirExists(exePath + "Data"))
+        ErrorExit("CoreData and Data directories not found, the benchmark should be run from the Bin directory");
+    cache->AddResourceDir(exePath + "CoreData");
+    cache->AddResourceDir(exePath + "Data");
+    
+    // Use a fixed seed so that each run generates the same scene
+    SetRandomSeed(1);
+    CreateScene();
+    CreateQueries();
+    CreateSortData();
+    CreateMathData();
+    sharedAllocator_ = SharedAllocatorInitialize(sizeof(HashMap<int, int>::Node));
+    
+    unsigned numItems = numNodes_ * 10;
+    
+    RunBenchmark("OctreeInsert", allNodes_.Size(), MoveNodes, OctreeInsert);
+    RunBenchmark("OctreeBoxQuery", NUM_QUERIES, 0, OctreeBoxQuery);
+    RunBenchmark("OctreeFrustumQuery", NUM_FRUSTUMS, 0, OctreeFrustumQuery);
+    RunBenchmark("OctreeRaycast", NUM_QUERIES, 0, OctreeRaycast);
+    RunBenchmark("SceneSaveBinary", replicatedNodes_.Size(), 0, SceneSaveBinary);
+    RunBenchmark("SceneLoadBinary", replicatedNodes_.Size(), 0, SceneLoadBinary);
+    RunBenchmark("SceneLoadAsync", replicatedNodes_.Size(), 0, SceneLoadAsync);
+    loadScene_->SetThreadedLoading(true);
+    RunBenchmark("SceneLoadAsyncThreaded", replicatedNodes_.Size(), 0, SceneLoadAsync);
+    loadScene_->SetThreadedLoading(false);
+    RunBenchmark("SceneSaveXML", replicatedNodes_.Size(), 0, SceneSaveXML);
+    RunBenchmark("SceneLoadXML", replicatedNodes_.Size(), 0, SceneLoadXML);
+    RunBenchmark("XMLAttributeRead", replicatedNodes_.Size(), 0, XMLAttributeRead);
+    RunBenchmark("TransformPropagation", allNodes_.Size(), UpdateOctree, TransformPropagation);
+    scene_->SetBatchedTransforms(true);
+    RunBenchmark("BatchedTransformPropagation", allNodes_.Size(), UpdateOctree, BatchedTransformPropagation);
+    scene_->SetBatchedTransforms(false);
+    RunBenchmark("RepeatedMove", rootNodes_.Size(), UpdateOctree, RepeatedMove);
+    scene_->SetDeferredMarkedDirty(true);
+    RunBenchmark("DeferredRepeatedMove", rootNodes_.Size(), UpdateOctree, RepeatedMove);
+    scene_->SetDeferredMarkedDirty(false);
+    RunBenchmark("SpawnDespawn", NUM_SPAWNS, 0, SpawnDespawn);
+    context_->SetObjectPooling(Node::GetTypeStatic(), true);
+    context_->SetObjectPooling(StaticModel::GetTypeStatic(), true);
+    RunBenchmark("PooledSpawnDespawn", NUM_SPAWNS, 0, SpawnDespawn);
+    context_->SetObjectPooling(Node::GetTypeStatic(), false);
+    context_->SetObjectPooling(StaticModel::GetTypeStatic(), false);
+    RunBenchmark("PrefabInstantiate", NUM_SPAWNS, 0, PrefabInstantiateBinary);
+    RunBenchmark("PrefabInstantiateXML", NUM_SPAWNS, 0, PrefabInstantiateXML);
+    RunBenchmark("PrefabTemplateInstantiate", NUM_SPAWNS, 0, PrefabInstantiateTemplate);
+    RunBenchmark("AnimatedModelSkinning", animatedModels_.Size(), 0, AnimatedModelSkinning);
+    RunBenchmark("PhysicsStep", numBodies_, 0, PhysicsStep);
+    RunBenchmark("SerializableDelta", replicatedNodes_.Size(), MoveNodes, SerializableDelta);
+    RunBenchmark("HashMap", numItems, 0, HashMapOperations);
+    RunBenchmark("FlatHashMap", numItems, 0, FlatHashMapOperations);
+    RunBenchmark("SharedHashMap", numItems, 0, SharedHashMapOperations);
+    RunBenchmark("String", numItems, 0, StringOperations);
+    RunBenchmark("Variant", numItems, 0, VariantOperations);
+    RunBenchmark("Sort", sortData_.Size(), PrepareSort, SortOperations);
+    RunBenchmark("RadixSort", sortData_.Size(), PrepareSort, RadixSortOperations);
+    RunBenchmark("ParallelSort", sortData_.Size(), PrepareSort, ParallelSortOperations);
+    RunBenchmark("Math", mathElements_.Size(), 0, MathOperations);
+    RunBenchmark("MathScalar", mathElements_.Size(), 0, ScalarMathOperations);
+    CheckMathResults();
+    RunBenchmark("WorkQueue", (numItems + WORK_ITEM_SIZE - 1) / WORK_ITEM_SIZE, 0, WorkQueueItems);
+    
+    String output = GetResultsJSON();
+    
+    if (outputFileName.Empty())
+        PrintLine(output);
+    else
+    {
+        File outFile(context_);
+        if (!outFile.Open(outputFileName, FILE_WRITE))
+            ErrorExit("Could not open output file " + outputFileName);
+        outFile.Write(output.CString(), output.Length());
+    }
+    
+    fileSystem->Delete(binaryFileName_);
+}
+
+void ReleaseObjects()
+{
+    rootNodes_.Clear();
+    allNodes_.Clear();
+    replicatedNodes_.Clear();
+    spawnedNodes_.Clear();
+    animatedModels_.Clear();
+    animationStates_.Clear();
+    queryResult_.Clear();
+    rayQueryResult_.Clear();
+    octree_ = 0;
+    physicsWorld_ = 0;
+    xmlFile_.Reset();
+    prefabXMLFile_.Reset();
+    prefab_.Reset();
+    loadScene_.Reset();
+    scene_.Reset();
+    SharedAllocatorUninitialize(sharedAllocator_);
+    sharedAllocator_ = 0;
+}
+
+void CreateScene()
+{
+    ResourceCache* cache = context_->GetSubsystem<ResourceCache>();
+    Model* boxModel = cache->GetResource<Model>("Models/Box.mdl");
+    Model* jackModel = cache->GetResource<Model>("Models/Jack.mdl");
+    Animation* walkAnimation = cache->GetResource<Animation>("Models/Jack_Walk.ani");
+    XMLFile* smokeEffect = cache->GetResource<XMLFile>("Particle/Smoke.xml");
+    if (!boxModel || !jackModel || !walkAnimation || !smokeEffect)
+        ErrorExit("Could not load the benchmark scene resources");
+    
+    scene_ = new Scene(context_);
+    loadScene_ = new Scene(context_);
+    octree_ = scene_->CreateComponent<Octree>();
+    physicsWorld_ = scene_->CreateComponent<PhysicsWorld>();
+    
+    // Spread the nodes so that the density stays constant regardless of the scene size
+    sceneRange_ = sqrtf((float)numNodes_) * 2.0f;
+    
+    Node* groundNode = scene_->CreateChild("Ground");
+    groundNode->SetPosition(Vector3(0.0f, -1.0f, 0.0f));
+    groundNode->CreateComponent<RigidBody>();
+    CollisionShape* groundShape = groundNode->CreateComponent<CollisionShape>();
+    groundShape->SetBox(Vector3(sceneRange_ * 2.0f + 10.0f, 2.0f, sceneRange_ * 2.0f + 10.0f));
+    
+    for (unsigned i = 0; i < numNodes_; ++i)
+    {
+        Node* node = scene_->CreateChild("Node" + String(i));
+        node->SetPosition(Vector3(Random(sceneRange_ * 2.0f) - sceneRange_, Random(20.0f), Random(sceneRange_ * 2.0f) -
+            sceneRange_));
+        node->SetRotation(Quaternion(Random(360.0f), Vector3::UP));
+        
+        // Mix of 10% animated models, 10% rigid bodies, 5% particle emitters and 75% static models with a child model
+        unsigned type = i % 20;
+        if (type < 2)
+        {
+            AnimatedModel* model = node->CreateComponent<AnimatedModel>();
+            model->SetModel(jackModel);
+            AnimationState* state = model->AddAnimationState(walkAnimation);
+            state->SetWeight(1.0f);
+            state->SetLooped(true);
+            state->AddTime(Random(walkAnimation->GetLength()));
+            animatedModels_.Push(model);
+            animationStates_.Push(state);
+        }
+        else if (type < 4)
+        {
+            StaticModel* model = node->CreateComponent<StaticModel>();
+            model->SetModel(boxModel);
+            RigidBody* body = node->CreateComponent<RigidBody>();
+            body->SetMass(1.0f);
+            CollisionShape* shape = node->CreateComponent<CollisionShape>();
+            shape->SetBox(Vector3::ONE);
+            ++numBodies_;
+        }
+        else if (type < 5)
+        {
+            ParticleEmitter* emitter = node->CreateComponent<ParticleEmitter>();
+            emitter->LoadParameters(smokeEffect);
+        }
+        else
+        {
+            StaticModel* model = node->CreateComponent<StaticModel>();
+            model->SetModel(boxModel);
+            Node* childNode = node->CreateChild("Child");
+            childNode->SetPosition(Vector3(0.0f, 1.0f, 0.0f));
+            childNode->SetScale(0.5f);
+            StaticModel* childModel = childNode->CreateComponent<StaticModel>();
+            childModel->SetModel(boxModel);
+        }
+        
+        rootNodes_.Push(node);
+    }
+    
+    scene_->GetChildren(allNodes_, true);
+    for (unsigned i = 0; i < allNodes_.Size(); ++i)
+    {
+        if (allNodes_[i]->GetID() < FIRST_LOCAL_ID)
+            replicatedNodes_.Push(allNodes_[i]);
+    }
+    
+    // Insert the drawables to the octree and serialize the scene once for the load benchmarks
+    UpdateOctree();
+    scene_->Save(binaryData_);
+    scene_->SaveXML(xmlData_);
+    xmlFile_ = new XMLFile(context_);
+    xmlData_.Seek(0);
+    xmlFile_->Load(xmlData_);
+    
+    // The asynchronous load benchmarks read the binary scene from a file
+    binaryFileName_ = context_->GetSubsystem<FileSystem>()->GetProgramDir() + "BenchmarkScene.bin";
+    File binaryFile(context_);
+    if (!binaryFile.Open(binaryFileName_, FILE_WRITE))
+        ErrorExit("Could not open output file " + binaryFileName_);
+    binaryFile.Write(binaryData_.GetData(), binaryData_.GetSize());
+    
+    // Use a static model node with a child node as the prefab for the instantiation benchmarks
+    Node* prefabNode = rootNodes_[Min((int)rootNodes_.Size() - 1, 5)];
+    prefabNode->Save(prefabData_);
+    prefabXMLFile_ = new XMLFile(context_);
+    XMLElement prefabElem = prefabXMLFile_->CreateRoot("node");
+    prefabNode->SaveXML(prefabElem);
+    prefab_ = new PrefabTemplate(context_);
+    prefabData_.Seek(0);
+    prefab_->LoadBinary(prefabData_);
+}
+
+void CreateQueries()
+{
+    for (unsigned i = 0; i < NUM_QUERIES; ++i)
+    {
+        Vector3 center(Random(sceneRange_ * 2.0f) - sceneRange_, Random(10.0f), Random(sceneRange_ * 2.0f) - sceneRange_);
+        Vector3 halfSize(sceneRange_ * 0.1f, 5.0f, sceneRange_ * 0.1f);
+        queryBoxes_.Push(BoundingBox(center - halfSize, center + halfSize));
+        
+        Vector3 origin(Random(sceneRange_ * 2.0f) - sceneRange_, 5.0f, Random(sceneRange_ * 2.0f) - sceneRange_);
+        Vector3 direction(Random(2.0f) - 1.0f, Random(0.2f) - 0.1f, Random(2.0f) - 1.0f);
+        queryRays_.Push(Ray(origin, direction.Normalized()));
+    }
+    
+    for (unsigned i = 0; i < NUM_FRUSTUMS; ++i)
+    {
+        Frustum frustum;
+        Vector3 position(Random(sceneRange_ * 2.0f) - sceneRange_, 5.0f, Random(sceneRange_ * 2.0f) - sceneRange_);
+        Quaternion rotation(Random(360.0f), Vector3::UP);
+        frustum.Define(45.0f, 16.0f / 9.0f, 1.0f, 0.1f, sceneRange_, Matrix3x4(position, rotation, 1.0f));
+        queryFrustums_.Push(frustum);
+    }
+}
+
+void CreateSortData()
+{
+    // Use few distinct shaders and more materials and geometries, like in a real batch queue
+    unsigned numElements = numNodes_ * 10;
+    sortElements_.Resize(numElements);
+    sortData_.Resize(numElements);
+    for (unsigned i = 0; i < numElements; ++i)
+    {
+        SortElement& element = sortElements_[i];
+        element.key_ = (((unsigned long long)(Rand() & 0x3f)) << 48) | (((unsigned long long)(Rand() & 0x3ff)) << 16) |
+            (Rand() & 0x3ff);
+        element.distance_ = Random(sceneRange_);
+        sortData_[i] = &element;
+    }
+}
+
+void CreateMathData()
+{
+    unsigned numElements = numNodes_ * 10;
+    mathElements_.Resize(numElements);
+    mathResults_.Resize(numElements);
+    scalarMathResults_.Resize(numElements);
+    for (unsigned i = 0; i < numElements; ++i)
+    {
+        MathElement& element = mathElements_[i];
+        Vector3 position(Random(sceneRange_), Random(10.0f), Random(sceneRange_));
+        element.rotation_ = Quaternion(Random(360.0f), Random(360.0f), Random(360.0f));
+        element.transform_ = Matrix3x4(position, element.rotation_, Vector3(Random(1.0f) + 0.5f, Random(1.0f) + 0.5f,
+            Random(1.0f) + 0.5f));
+        element.position_ = Vector4(position, 1.0f);
+        element.box_ = BoundingBox(-Vector3::ONE, Vector3::ONE);
+    }
+    
+    // Use a parent transform and a perspective view-projection like in scene node and batch transform calculations
+    mathParentRotation_ = Quaternion(0.0f, 45.0f, 0.0f);
+    mathParent_ = Matrix3x4(Vector3(1.0f, 2.0f, 3.0f), mathParentRotation_, 2.0f);
+    Matrix4 projection(Matrix4::IDENTITY);
+    projection.m22_ = 1.001f;
+    projection.m23_ = -0.1f;
+    projection.m32_ = 1.0f;
+    projection.m33_ = 0.0f;
+    mathViewProj_ = projection * Matrix3x4(Vector3(0.0f, 10.0f, -sceneRange_), Quaternion::IDENTITY, 1.0f).Inverse();
+}
+
+void RunBenchmark(const String& name, unsigned items, BenchmarkFunction prepare, BenchmarkFunction function)
+{
+    BenchmarkResult result;
+    result.name_ = name;
+    result.items_ = items;
+    
+    HiresTimer timer;
+    Profiler* profiler = context_->GetSubsystem<Profiler>();
+    
+    // Run one untimed iteration first to warm up the caches and allocations
+    for (unsigned i = 0; i <= numIterations_; ++i)
+    {
+        if (prepare)
+            prepare();
+        
+        // Profile each timed iteration as one frame of the benchmark's profiling interval
+        if (profiler)
+        {
+            if (i == 1)
+                profiler->BeginInterval();
+            profiler->BeginFrame();
+        }
+        
+        int allocations = allocations_;
+        timer.Reset();
+        function();
+        long long time = timer.GetUSec(false);
+        allocations = allocations_ - allocations;
+        
+        if (profiler)
+            profiler->EndFrame();
+        
+        if (i)
+        {
+            result.times_.Push(time);
+            result.allocations_.Push(allocations);
+        }
+    }
+    
+    if (profiler)
+        result.profile_ = profiler->GetData();
+    
+    results_.Push(result);
+}
+
+String GetResultsJSON()
+{
+    char line[256];
+    
+    sprintf(line, "{\n\"nodes\":%u,\n\"threads\":%u,\n\"iterations\":%u,\n\"benchmarks\":[\n", numNodes_, numThreads_,
+        numIterations_);
+    String output(line);
+    
+    for (unsigned i = 0; i < results_.Size(); ++i)
+    {
+        PODVector<long long> times = results_[i].times_;
+        Sort(times.Begin(), times.End());
+        
+        long long total = 0;
+        for (unsigned j = 0; j < times.Size(); ++j)
+            total += times[j];
+        
+        const PODVector<unsigned>& allocations = results_[i].allocations_;
+        long long totalAllocations = 0;
+        for (unsigned j = 0; j < allocations.Size(); ++j)
+            totalAllocations += allocations[j];
+        
+        sprintf(line, "{\"name\":\"%s\",\"items\":%u,\"min\":%lld,\"median\":%lld,\"mean\":%lld,\"max\":%lld,"
+            "\"allocations\":%lld", results_[i].name_.CString(), results_[i].items_, times.Front(), times[times.Size() / 2],
+            total / (long long)times.Size(), times.Back(), totalAllocations / (long long)allocations.Size());
+        output += String(line);
+        if (!results_[i].profile_.Empty())
+            output += ",\"profile\":\"" + EscapeJSON(results_[i].profile_) + "\"";
+        output += i < results_.Size() - 1 ? "},\n" : "}\n";
+    }
+    
+    output += "]\n}";
+    return output;
+}
+
+String EscapeJSON(const String& str)
+{
+    String ret;
+    ret.Reserve(str.Length());
+    
+    for (unsigned i = 0; i < str.Length(); ++i)
+    {
+        char c = str[i];
+        if (c == '"' || c == '\\')
+        {
+            ret += '\\';
+            ret += c;
+        }
+        else if (c == '\n')
+            ret += "\\n";
+        else
+            ret += c;
+    }
+    
+    return ret;
+}
+
+void MoveNodes()
+{
+    Vector3 delta(0.01f, 0.0f, 0.0f);
+    for (unsigned i = 0; i < rootNodes_.Size(); ++i)
+    {
+        rootNodes_[i]->Translate(delta);
+        // Reverse the direction every other frame so that the scene stays in place
+        delta = -delta;
+    }
+}
+
+void UpdateOctree()
+{
+    FrameInfo frame;
+    frame.frameNumber_ = ++frameNumber_;
+    frame.timeStep_ = TIME_STEP;
+    frame.viewSize_ = IntVector2::ZERO;
+    frame.camera_ = 0;
+    
+    octree_->Update(frame);
+}
+
+void OctreeInsert()
+{
+    UpdateOctree();
+}
+
+void OctreeBoxQuery()
+{
+    unsigned numResults = 0;
+    for (unsigned i = 0; i < queryBoxes_.Size(); ++i)
+    {
+        BoxOctreeQuery query(queryResult_, queryBoxes_[i], DRAWABLE_GEOMETRY);
+        octree_->GetDrawables(query);
+        numResults += queryResult_.Size();
+    }
+    sink_ += numResults;
+}
+
+void OctreeFrustumQuery()
+{
+    unsigned numResults = 0;
+    for (unsigned i = 0; i < queryFrustums_.Size(); ++i)
+    {
+        FrustumOctreeQuery query(queryResult_, queryFrustums_[i], DRAWABLE_GEOMETRY);
+        octree_->GetDrawables(query);
+        numResults += queryResult_.Size();
+    }
+    sink_ += numResults;
+}
+
+void OctreeRaycast()
+{
+    unsigned numResults = 0;
+    for (unsigned i = 0; i < queryRays_.Size(); ++i)
+    {
+        RayOctreeQuery query(rayQueryResult_, queryRays_[i], RAY_OBB, sceneRange_, DRAWABLE_GEOMETRY);
+        octree_->Raycast(query);
+        numResults += rayQueryResult_.Size();
+    }
+    sink_ += numResults;
+}
+
+void SceneSaveBinary()
+{
+    VectorBuffer buffer;
+    scene_->Save(buffer);
+    sink_ += buffer.GetSize();
+}
+
+void SceneLoadBinary()
+{
+    binaryData_.Seek(0);
+    loadScene_->Load(binaryData_);
+    sink_ += loadScene_->GetNumChildren();
+}
+
+void SceneLoadAsync()
+{
+    SharedPtr<File> file(new File(context_, binaryFileName_));
+    loadScene_->LoadAsync(file);
+    while (loadScene_->IsAsyncLoading())
+        loadScene_->Update(TIME_STEP);
+    sink_ += loadScene_->GetNumChildren();
+}
+
+void SceneSaveXML()
+{
+    VectorBuffer buffer;
+    scene_->SaveXML(buffer);
+    sink_ += buffer.GetSize();
+}
+
+void SceneLoadXML()
+{
+    xmlData_.Seek(0);
+    loadScene_->LoadXML(xmlData_);
+    sink_ += loadScene_->GetNumChildren();
+}
+
+void XMLAttributeRead()
+{
+    sink_ += ReadAttributes(xmlFile_->GetRoot());
+}
+
+unsigned ReadAttributes(const XMLElement& element)
+{
+    // Read the attribute names and values as strings, like the scene XML loading does, then recurse to the children
+    unsigned sum = 0;
+    Vector<String> names = element.GetAttributeNames();
+    for (unsigned i = 0; i < names.Size(); ++i)
+        sum += element.GetAttribute(names[i]).Length();
+    
+    XMLElement child = element.GetChild();
+    while (child)
+    {
+        sum += ReadAttributes(child);
+        child = child.GetNext();
+    }
+    
+    return sum;
+}
+
+void TransformPropagation()
+{
+    // Rotate the root nodes, which dirties the whole hierarchy, then request all the world transforms
+    Quaternion delta(1.0f, Vector3::UP);
+    for (unsigned i = 0; i < rootNodes_.Size(); ++i)
+        rootNodes_[i]->Rotate(delta);
+    
+    float sum = 0.0f;
+    for (unsigned i = 0; i < allNodes_.Size(); ++i)
+        sum += allNodes_[i]->GetWorldTransform().m03_;
+    sink_ += (unsigned)sum;
+}
+
+void BatchedTransformPropagation()
+{
+    // Same as above, but recalculate the world transforms in the scene's batched update before requesting them
+    Quaternion delta(1.0f, Vector3::UP);
+    for (unsigned i = 0; i < rootNodes_.Size(); ++i)
+        rootNodes_[i]->Rotate(delta);
+    scene_->UpdateTransforms();
+    
+    float sum = 0.0f;
+    for (unsigned i = 0; i < allNodes_.Size(); ++i)
+        sum += allNodes_[i]->GetWorldTransform().m03_;
+    sink_ += (unsigned)sum;
+}
+
+void RepeatedMove()
+{
+    // Move each root node back and forth several times, reading its world position in between as game logic would
+    Vector3 delta(0.01f, 0.0f, 0.0f);
+    float sum = 0.0f;
+    for (unsigned i = 0; i < rootNodes_.Size(); ++i)
+    {
+        for (unsigned j = 0; j < 4; ++j)
+        {
+            rootNodes_[i]->Translate(delta);
+            sum += rootNodes_[i]->GetWorldPosition().x_;
+            delta = -delta;
+        }
+    }
+    scene_->NotifyMarkedDirty();
+    sink_ += (unsigned)sum;
+}
+
+void SpawnDespawn()
+{
+    // Spawn short-lived nodes with a drawable and a child node, then remove them, as a projectile system would
+    Model* boxModel = context_->GetSubsystem<ResourceCache>()->GetResource<Model>("Models/Box.mdl");
+    for (unsigned i = 0; i < NUM_SPAWNS; ++i)
+    {
+        Node* node = scene_->CreateChild();
+        node->SetPosition(Vector3(Random(sceneRange_ * 2.0f) - sceneRange_, 1.0f, Random(sceneRange_ * 2.0f) - sceneRange_));
+        StaticModel* model = node->CreateComponent<StaticModel>();
+        model->SetModel(boxModel);
+        node->CreateChild();
+        spawnedNodes_.Push(node);
+    }
+    
+    UpdateOctree();
+    DespawnNodes();
+}
+
+void PrefabInstantiateBinary()
+{
+    for (unsigned i = 0; i < NUM_SPAWNS; ++i)
+    {
+        prefabData_.Seek(0);
+        spawnedNodes_.Push(scene_->Instantiate(prefabData_, Vector3(Random(sceneRange_ * 2.0f) - sceneRange_, 1.0f,
+            Random(sceneRange_ * 2.0f) - sceneRange_), Quaternion::IDENTITY));
+    }
+    
+    DespawnNodes();
+}
+
+void PrefabInstantiateXML()
+{
+    XMLElement prefabElem = prefabXMLFile_->GetRoot();
+    for (unsigned i = 0; i < NUM_SPAWNS; ++i)
+    {
+        spawnedNodes_.Push(scene_->InstantiateXML(prefabElem, Vector3(Random(sceneRange_ * 2.0f) - sceneRange_, 1.0f,
+            Random(sceneRange_ * 2.0f) - sceneRange_), Quaternion::IDENTITY));
+    }
+    
+    DespawnNodes();
+}
+
+void PrefabInstantiateTemplate()
+{
+    for (unsigned i = 0; i < NUM_SPAWNS; ++i)
+    {
+        spawnedNodes_.Push(scene_->Instantiate(prefab_, Vector3(Random(sceneRange_ * 2.0f) - sceneRange_, 1.0f,
+            Random(sceneRange_ * 2.0f) - sceneRange_), Quaternion::IDENTITY));
+    }
+    
+    DespawnNodes();
+}
+
+void DespawnNodes()
+{
+    for (unsigned i = 0; i < spawnedNodes_.Size(); ++i)
+    {
+        if (spawnedNodes_[i])
+            spawnedNodes_[i]->Remove();
+    }
+    spawnedNodes_.Clear();
+}
+
+void AnimatedModelSkinning()
+{
+    FrameInfo frame;
+    frame.frameNumber_ = ++frameNumber_;
+    frame.timeStep_ = TIME_STEP;
+    frame.viewSize_ = IntVector2::ZERO;
+    frame.camera_ = 0;
+    
+    // Advance the animations. The octree update applies them to the skeletons in the worker threads
+    for (unsigned i = 0; i < animationStates_.Size(); ++i)
+        animationStates_[i]->AddTime(TIME_STEP);
+    octree_->Update(frame);
+    
+    // Then calculate the skin matrices, which is normally done when the models are visible in a view
+    for (unsigned i = 0; i < animatedModels_.Size(); ++i)
+        animatedModels_[i]->UpdateGeometry(frame);
+}
+
+void PhysicsStep()
+{
+    physicsWorld_->Update(TIME_STEP);
+}
+
+void SerializableDelta()
+{
+    // Check each replicated node and component for changed attributes and encode them as for a new client, plus the latest data
+    networkData_.Clear();
+    
+    for (unsigned i = 0; i < replicatedNodes_.Size(); ++i)
+    {
+        Node* node = replicatedNodes_[i];
+        node->PrepareNetworkUpdate();
+        node->WriteInitialDeltaUpdate(networkData_);
+        node->WriteLatestDataUpdate(networkData_);
+        
+        const Vector<SharedPtr<Component> >& components = node->GetComponents();
+        for (unsigned j = 0; j < components.Size(); ++j)
+        {
+            Component* component = components[j];
+            if (component->GetID() >= FIRST_LOCAL_ID)
+                continue;
+            
+            component->PrepareNetworkUpdate();
+            component->WriteInitialDeltaUpdate(networkData_);
+            component->WriteLatestDataUpdate(networkData_);
+        }
+    }
+    
+    sink_ += networkData_.GetSize();
+}
+
+void HashMapOperations()
+{
+    unsigned numItems = numNodes_ * 10;
+    HashMap<int, int> map;
+    
+    for (unsigned i = 0; i < numItems; ++i)
+        map[i * 7] = i;
+    
+    unsigned sum = 0;
+    for (unsigned i = 0; i < numItems; ++i)
+    {
+        HashMap<int, int>::ConstIterator j = map.Find(i * 7);
+        if (j != map.End())
+            sum += j->second_;
+    }
+    
+    for (unsigned i = 0; i < numItems; i += 2)
+        map.Erase(i * 7);
+    
+    sink_ += sum + map.Size();
+}
+
+void FlatHashMapOperations()
+{
+    unsigned numItems = numNodes_ * 10;
+    FlatHashMap<int, int> map;
+    
+    for (unsigned i = 0; i < numItems; ++i)
+        map[i * 7] = i;
+    
+    unsigned sum = 0;
+    for (unsigned i = 0; i < numItems; ++i)
+    {
+        FlatHashMap<int, int>::ConstIterator j = map.Find(i * 7);
+        if (j != map.End())
+            sum += j->second_;
+    }
+    
+    for (unsigned i = 0; i < numItems; i += 2)
+        map.Erase(i * 7);
+    
+    sink_ += sum + map.Size();
+}
+
+void SharedHashMapOperations()
+{
+    unsigned numItems = numNodes_ * 10;
+    WorkQueue* queue = context_->GetSubsystem<WorkQueue>();
+    
+    workData_.Resize(numItems);
+    for (unsigned i = 0; i < numItems; ++i)
+        workData_[i] = i;
+    
+    // Build one map per work item on the worker threads, all reserving their nodes from the same shared allocator
+    WorkItem item;
+    item.workFunction_ = HashMapWork;
+    item.aux_ = sharedAllocator_;
+    for (unsigned i = 0; i < numItems; i += MAP_WORK_ITEM_SIZE)
+    {
+        item.start_ = &workData_[i];
+        item.end_ = &workData_[0] + Min((int)(i + MAP_WORK_ITEM_SIZE), (int)numItems);
+        
+        queue->AddWorkItem(item);
+    }
+    
+    queue->Complete(M_MAX_UNSIGNED);
+}
+
+void StringOperations()
+{
+    unsigned numItems = numNodes_ * 10;
+    unsigned sum = 0;
+    
+    for (unsigned i = 0; i < numItems; ++i)
+    {
+        String str = "Node" + String(i);
+        str += "/Child";
+        str.Replace("Child", "Component");
+        sum += str.Find('/');
+        sum += StringHash(str).Value();
+        sum += str.ToLower().Length();
+    }
+    
+    sink_ += sum;
+}
+
+void VariantOperations()
+{
+    unsigned numItems = numNodes_ * 10;
+    VariantMap map;
+    
+    for (unsigned i = 0; i < numItems; ++i)
+    {
+        Variant value;
+        switch (i % 4)
+        {
+        case 0:
+            value = (int)i;
+            break;
+        
+        case 1:
+            value = (float)i;
+            break;
+        
+        case 2:
+            value = Vector3((float)i, 0.0f, 0.0f);
+            break;
+        
+        case 3:
+            value = String(i);
+            break;
+        }
+        map[ShortStringHash(i)] = value;
+    }
+    
+    unsigned sum = 0;
+    for (VariantMap::ConstIterator i = map.Begin(); i != map.End(); ++i)
+    {
+        Variant copy = i->second_;
+        if (copy == i->second_)
+            sum += copy.GetType();
+    }
+    
+    sink_ += sum;
+}
+
+bool CompareSortElements(SortElement* lhs, SortElement* rhs)
+{
+    if (lhs->key_ != rhs->key_)
+        return lhs->key_ < rhs->key_;
+    else
+        return lhs->distance_ < rhs->distance_;
+}
+
+unsigned long long GetSortElementKey(SortElement* const& element)
+{
+    return element->key_;
+}
+
+unsigned GetSortElementDistanceKey(SortElement* const& element)
+{
+    return FloatRadixKey(element->distance_);
+}
+
+void PrepareSort()
+{
+    sortResult_ = sortData_;
+}
+
+void SortOperations()
+{
+    Sort(sortResult_.Begin(), sortResult_.End(), CompareSortElements);
+    sink_ += (unsigned)sortResult_[0]->key_;
+}
+
+void RadixSortOperations()
+{
+    RadixSort(sortResult_.Begin(), sortResult_.End(), sortBuffer_, GetSortElementDistanceKey);
+    RadixSort(sortResult_.Begin(), sortResult_.End(), sortBuffer_, GetSortElementKey);
+    sink_ += (unsigned)sortResult_[0]->key_;
+}
+
+void ParallelSortOperations()
+{
+    ParallelSort(context_->GetSubsystem<WorkQueue>(), sortResult_.Begin(), sortResult_.End(), sortBuffer_, CompareSortElements);
+    sink_ += (unsigned)sortResult_[0]->key_;
+}
+
+void MathOperations()
+{
+    for (unsigned i = 0; i < mathElements_.Size(); ++i)
+    {
+        const MathElement& element = mathElements_[i];
+        MathResult& result = mathResults_[i];
+        Matrix3x4 world = mathParent_ * element.transform_;
+        result.modelViewProj_ = mathViewProj_ * world;
+        result.position_ = result.modelViewProj_ * element.position_;
+        result.rotation_ = mathParentRotation_ * element.rotation_;
+        result.box_ = element.box_.Transformed(world);
+    }
+    
+    sink_ += (unsigned)mathResults_[0].position_.x_;
+}
+
+Matrix3x4 ScalarMultiply(const Matrix3x4& lhs, const Matrix3x4& rhs)
+{
+    return Matrix3x4(
+        lhs.m00_ * rhs.m00_ + lhs.m01_ * rhs.m10_ + lhs.m02_ * rhs.m20_,
+        lhs.m00_ * rhs.m01_ + lhs.m01_ * rhs.m11_ + lhs.m02_ * rhs.m21_,
+        lhs.m00_ * rhs.m02_ + lhs.m01_ * rhs.m12_ + lhs.m02_ * rhs.m22_,
+        lhs.m00_ * rhs.m03_ + lhs.m01_ * rhs.m13_ + lhs.m02_ * rhs.m23_ + lhs.m03_,
+        lhs.m10_ * rhs.m00_ + lhs.m11_ * rhs.m10_ + lhs.m12_ * rhs.m20_,
+        lhs.m10_ * rhs.m01_ + lhs.m11_ * rhs.m11_ + lhs.m12_ * rhs.m21_,
+        lhs.m10_ * rhs.m02_ + lhs.m11_ * rhs.m12_ + lhs.m12_ * rhs.m22_,
+        lhs.m10_ * rhs.m03_ + lhs.m11_ * rhs.m13_ + lhs.m12_ * rhs.m23_ + lhs.m13_,
+        lhs.m20_ * rhs.m00_ + lhs.m21_ * rhs.m10_ + lhs.m22_ * rhs.m20_,
+        lhs.m20_ * rhs.m01_ + lhs.m21_ * rhs.m11_ + lhs.m22_ * rhs.m21_,
+        lhs.m20_ * rhs.m02_ + lhs.m21_ * rhs.m12_ + lhs.m22_ * rhs.m22_,
+        lhs.m20_ * rhs.m03_ + lhs.m21_ * rhs.m13_ + lhs.m22_ * rhs.m23_ + lhs.m23_
+    );
+}
+
+Matrix4 ScalarMultiply(const Matrix4& lhs, const Matrix3x4& rhs)
+{
+    return Matrix4(
+        lhs.m00_ * rhs.m00_ + lhs.m01_ * rhs.m10_ + lhs.m02_ * rhs.m20_,
+        lhs.m00_ * rhs.m01_ + lhs.m01_ * rhs.m11_ + lhs.m02_ * rhs.m21_,
+        lhs.m00_ * rhs.m02_ + lhs.m01_ * rhs.m12_ + lhs.m02_ * rhs.m22_,
+        lhs.m00_ * rhs.m03_ + lhs.m01_ * rhs.m13_ + lhs.m02_ * rhs.m23_ + lhs.m03_,
+        lhs.m10_ * rhs.m00_ + lhs.m11_ * rhs.m10_ + lhs.m12_ * rhs.m20_,
+        lhs.m10_ * rhs.m01_ + lhs.m11_ * rhs.m11_ + lhs.m12_ * rhs.m21_,
+        lhs.m10_ * rhs.m02_ + lhs.m11_ * rhs.m12_ + lhs.m12_ * rhs.m22_,
+        lhs.m10_ * rhs.m03_ + lhs.m11_ * rhs.m13_ + lhs.m12_ * rhs.m23_ + lhs.m13_,
+        lhs.m20_ * rhs.m00_ + lhs.m21_ * rhs.m10_ + lhs.m22_ * rhs.m20_,
+        lhs.m20_ * rhs.m01_ + lhs.m21_ * rhs.m11_ + lhs.m22_ * rhs.m21_,
+        lhs.m20_ * rhs.m02_ + lhs.m21_ * rhs.m12_ + lhs.m22_ * rhs.m22_,
+        lhs.m20_ * rhs.m03_ + lhs.m21_ * rhs.m13_ + lhs.m22_ * rhs.m23_ + lhs.m23_,
+        lhs.m30_ * rhs.m00_ + lhs.m31_ * rhs.m10_ + lhs.m32_ * rhs.m20_,
+        lhs.m30_ * rhs.m01_ + lhs.m31_ * rhs.m11_ + lhs.m32_ * rhs.m21_,
+        lhs.m30_ * rhs.m02_ + lhs.m31_ * rhs.m12_ + lhs.m32_ * rhs.m22_,
+        lhs.m30_ * rhs.m03_ + lhs.m31_ * rhs.m13_ + lhs.m32_ * rhs.m23_ + lhs.m33_
+    );
+}
+
+Vector4 ScalarMultiply(const Matrix4& lhs, const Vector4& rhs)
+{
+    return Vector4(
+        lhs.m00_ * rhs.x_ + lhs.m01_ * rhs.y_ + lhs.m02_ * rhs.z_ + lhs.m03_ * rhs.w_,
+        lhs.m10_ * rhs.x_ + lhs.m11_ * rhs.y_ + lhs.m12_ * rhs.z_ + lhs.m13_ * rhs.w_,
+        lhs.m20_ * rhs.x_ + lhs.m21_ * rhs.y_ + lhs.m22_ * rhs.z_ + lhs.m23_ * rhs.w_,
+        lhs.m30_ * rhs.x_ + lhs.m31_ * rhs.y_ + lhs.m32_ * rhs.z_ + lhs.m33_ * rhs.w_
+    );
+}
+
+Quaternion ScalarMultiply(const Quaternion& lhs, const Quaternion& rhs)
+{
+    return Quaternion(
+        lhs.w_ * rhs.w_ - lhs.x_ * rhs.x_ - lhs.y_ * rhs.y_ - lhs.z_ * rhs.z_,
+        lhs.w_ * rhs.x_ + lhs.x_ * rhs.w_ + lhs.y_ * rhs.z_ - lhs.z_ * rhs.y_,
+        lhs.w_ * rhs.y_ + lhs.y_ * rhs.w_ + lhs.z_ * rhs.x_ - lhs.x_ * rhs.z_,
+        lhs.w_ * rhs.z_ + lhs.z_ * rhs.w_ + lhs.x_ * rhs.y_ - lhs.y_ * rhs.x_
+    );
+}
+
+BoundingBox ScalarTransformed(const BoundingBox& box, const Matrix3x4& transform)
+{
+    Vector3 oldCenter = (box.min_ + box.max_) * 0.5f;
+    Vector3 oldEdge = (box.max_ - box.min_) * 0.5f;
+    Vector3 newCenter(
+        transform.m00_ * oldCenter.x_ + transform.m01_ * oldCenter.y_ + transform.m02_ * oldCenter.z_ + transform.m03_,
+        transform.m10_ * oldCenter.x_ + transform.m11_ * oldCenter.y_ + transform.m12_ * oldCenter.z_ + transform.m13_,
+        transform.m20_ * oldCenter.x_ + transform.m21_ * oldCenter.y_ + transform.m22_ * oldCenter.z_ + transform.m23_
+    );
+    Vector3 newEdge(
+        Abs(transform.m00_) * oldEdge.x_ + Abs(transform.m01_) * oldEdge.y_ + Abs(transform.m02_) * oldEdge.z_,
+        Abs(transform.m10_) * oldEdge.x_ + Abs(transform.m11_) * oldEdge.y_ + Abs(transform.m12_) * oldEdge.z_,
+        Abs(transform.m20_) * oldEdge.x_ + Abs(transform.m21_) * oldEdge.y_ + Abs(transform.m22_) * oldEdge.z_
+    );
+    
+    return BoundingBox(newCenter - newEdge, newCenter + newEdge);
+}
+
+void ScalarMathOperations()
+{
+    // Same operations as MathOperations() using scalar code, to compare against the SSE math library
+    for (unsigned i = 0; i < mathElements_.Size(); ++i)
+    {
+        const MathElement& element = mathElements_[i];
+        MathResult& result = scalarMathResults_[i];
+        Matrix3x4 world = ScalarMultiply(mathParent_, element.transform_);
+        result.modelViewProj_ = ScalarMultiply(mathViewProj_, world);
+        result.position_ = ScalarMultiply(result.modelViewProj_, element.position_);
+        result.rotation_ = ScalarMultiply(mathParentRotation_, element.rotation_);
+        result.box_ = ScalarTransformed(element.box_, world);
+    }
+    
+    sink_ += (unsigned)scalarMathResults_[0].position_.x_;
+}
+
+bool EqualsWithTolerance(const float* lhs, const float* rhs, unsigned count)
+{
+    for (unsigned i = 0; i < count; ++i)
+    {
+        if (Abs(lhs[i] - rhs[i]) > M_LARGE_EPSILON * Max(Abs(rhs[i]), 1.0f))
+            return false;
+    }
+    
+    return true;
+}
+
+void CheckMathResults()
+{
+    for (unsigned i = 0; i < mathResults_.Size(); ++i)
+    {
+        const MathResult& result = mathResults_[i];
+        const MathResult& scalarResult = scalarMathResults_[i];
+        if (!EqualsWithTolerance(result.modelViewProj_.Data(), scalarResult.modelViewProj_.Data(), 16) ||
+            !EqualsWithTolerance(result.position_.Data(), scalarResult.position_.Data(), 4) ||
+            !EqualsWithTolerance(result.rotation_.Data(), scalarResult.rotation_.Data(), 4) ||
+            !EqualsWithTolerance(result.box_.min_.Data(), scalarResult.box_.min_.Data(), 3) ||
+            !EqualsWithTolerance(result.box_.max_.Data(), scalarResult.box_.max_.Data(), 3))
+            ErrorExit("Math library results differ from the scalar reference at element " + String(i));
+    }
+}
+
+void WorkQueueItems()
+{
+    unsigned numItems = numNodes_ * 10;
+    WorkQueue* queue = context_->GetSubsystem<WorkQueue>();
+    
+    workData_.Resize(numItems);
+    for (unsigned i = 0; i < numItems; ++i)
+        workData_[i] = i;
+    
+    // Use small work items to measure the queue overhead rather than the work itself
+    WorkItem item;
+    item.workFunction_ = SumWork;
+    item.aux_ = 0;
+    for (unsigned i = 0; i < numItems; i += WORK_ITEM_SIZE)
+    {
+        item.start_ = &workData_[i];
+        item.end_ = &workData_[0] + Min((int)(i + WORK_ITEM_SIZE), (int)numItems);
+        
+        queue->AddWorkItem(item);
+    }
+    
+    queue->Complete(M_MAX_UNSIGNED);
+}
+
+void SumWork(const WorkItem* item, unsigned threadIndex)
+{
+    unsigned* start = reinterpret_cast<unsigned*>(item->start_);
+    unsigned* end = reinterpret_cast<unsigned*>(item->end_);
+    
+    unsigned sum = 0;
+    while (start != end)
+        sum += *start++;
+    
+    *reinterpret_cast<unsigned*>(item->start_) = sum;
+}
+
+void HashMapWork(const WorkItem* item, unsigned threadIndex)
+{
+    unsigned* start = reinterpret_cast<unsigned*>(item->start_);
+    unsigned* end = reinterpret_cast<unsigned*>(item->end_);
+    
+    HashMap<int, int> map;
+    map.SetSharedAllocator(static_cast<SharedAllocator*>(item->aux_));
+    
+    for (unsigned* i = start; i != end; ++i)
+        map[*i * 7] = *i;
+    
+    unsigned sum = 0;
+    for (unsigned* i = start; i != end; ++i)
+    {
+        HashMap<int, int>::ConstIterator j = map.Find(*i * 7);
+        if (j != map.End())
+            sum += j->second_;
+    }
+    
+    *start = sum;
+}